@@ -535,13 +535,11 @@ static int cam_cdm_util_reg_random_write(void __iomem *base_addr,
 	}
 	data = cmd_buf + cdm_get_cmd_header_size(CAM_CDM_CMD_REG_RANDOM);
 
-	for (i = 0; i < reg_random->count; i++) {
-		CAM_DBG(CAM_CDM, "reg random: offset %pK, value 0x%x",
-			((void __iomem *)(base_addr + data[0])),
-			data[1]);
+	for (i = 0; i < reg_random->count; i++, data += 2)
 		cam_io_w(data[1], base_addr + data[0]);
-		data += 2;
-	}
+
+	CAM_DBG(CAM_CDM, "reg random: base %pK count %u",
+		base_addr, reg_random->count);
 
 	*used_bytes = ((reg_random->count * (sizeof(uint32_t) * 2)) +
 		(4 * cdm_get_cmd_header_size(CAM_CDM_CMD_REG_RANDOM)));
@@ -8,6 +8,7 @@
 #include <linux/refcount.h>
 
 #include "cam_context.h"
+#include "cam_context_utils.h"
 #include "cam_debug_util.h"
 #include "cam_node.h"
 
@@ -711,6 +712,8 @@ int cam_context_init(struct cam_context *ctx,
 	INIT_LIST_HEAD(&ctx->free_req_list);
 	ctx->req_list = req_list;
 	ctx->req_size = req_size;
+	ctx->req_init_size = req_size;
+	INIT_LIST_HEAD(&ctx->req_pool_entry);
 	for (i = 0; i < req_size; i++) {
 		INIT_LIST_HEAD(&ctx->req_list[i].list);
 		list_add_tail(&ctx->req_list[i].list, &ctx->free_req_list);
@@ -736,6 +739,7 @@ int cam_context_deinit(struct cam_context *ctx)
 	if (ctx->state != CAM_CTX_AVAILABLE)
 		CAM_ERR(CAM_CORE, "Device did not shutdown cleanly");
 
+	cam_context_free_req_pool(ctx);
 	memset(ctx, 0, sizeof(*ctx));
 
 	return 0;
@@ -26,6 +26,10 @@ struct cam_context;
 #define CAM_CTX_CFG_MAX              20
 #define CAM_CTX_RES_MAX              20
 
+/* Upper bounds of the request pool geometry chosen at acquire */
+#define CAM_CTX_REQ_POOL_MAX         128
+#define CAM_CTX_CFG_POOL_MAX         64
+
 /* max tag  dump header string length*/
 #define CAM_CTXT_DUMP_TAG_MAX_LEN 32
 
@@ -53,11 +57,11 @@ enum cam_context_state {
  * @status:                Request status
  * @request_id:            Request id
  * @req_priv:              Derived request object
- * @hw_update_entries:     Hardware update entries
+ * @hw_update_entries:     Hardware update entries, from the request pool
  * @num_hw_update_entries: Number of hardware update entries
- * @in_map_entries:        Entries for in fences
+ * @in_map_entries:        Entries for in fences, from the request pool
  * @num_in_map_entries:    Number of in map entries
- * @out_map_entries:       Entries for out fences
+ * @out_map_entries:       Entries for out fences, from the request pool
  * @num_out_map_entries:   Number of out map entries
  * @num_in_acked:          Number of in fence acked
  * @num_out_acked:         Number of out fence acked
@@ -71,11 +75,11 @@ struct cam_ctx_request {
 	uint32_t                       status;
 	uint64_t                       request_id;
 	void                          *req_priv;
-	struct cam_hw_update_entry     hw_update_entries[CAM_CTX_CFG_MAX];
+	struct cam_hw_update_entry    *hw_update_entries;
 	uint32_t                       num_hw_update_entries;
-	struct cam_hw_fence_map_entry  in_map_entries[CAM_CTX_CFG_MAX];
+	struct cam_hw_fence_map_entry *in_map_entries;
 	uint32_t                       num_in_map_entries;
-	struct cam_hw_fence_map_entry  out_map_entries[CAM_CTX_CFG_MAX];
+	struct cam_hw_fence_map_entry *out_map_entries;
 	uint32_t                       num_out_map_entries;
 	atomic_t                       num_in_acked;
 	uint32_t                       num_out_acked;
@@ -84,6 +88,24 @@ struct cam_ctx_request {
 	struct cam_hw_mgr_dump_pf_data pf_data;
 };
 
+/**
+ * struct cam_ctx_req_pool_stats - Request pool high water marks
+ *
+ * @in_use_hwm:            Most requests taken from the pool at once
+ * @hw_update_hwm:         Most hardware update entries in one request
+ * @in_map_hwm:            Most in map entries in one request
+ * @out_map_hwm:           Most out map entries in one request
+ * @num_exhausted:         Configs rejected because the pool was empty
+ *
+ */
+struct cam_ctx_req_pool_stats {
+	uint32_t                       in_use_hwm;
+	uint32_t                       hw_update_hwm;
+	uint32_t                       in_map_hwm;
+	uint32_t                       out_map_hwm;
+	uint32_t                       num_exhausted;
+};
+
 /**
  * struct cam_ctx_ioctl_ops - Function table for handling IOCTL calls
  *
@@ -193,6 +215,13 @@ struct cam_ctx_ops {
  * @free_req_list:         Requests that are free
  * @req_list:              Reference to the request storage
  * @req_size:              Size of the request storage
+ * @req_init_size:         Size of the request storage given at init, used
+ *                         as default request pool depth
+ * @req_pool:              Request pool allocated at acquire, the request
+ *                         storage once allocated
+ * @req_cfg_max:           Map entries per request in the request pool
+ * @req_pool_stats:        Request pool high water marks
+ * @req_pool_entry:        Link in the list of contexts with a request pool
  * @hw_mgr_intf:           Context to HW interface
  * @ctx_crm_intf:          Context to CRM interface
  * @crm_ctx_intf:          CRM to context interface
@@ -225,6 +254,11 @@ struct cam_context {
 	struct list_head             free_req_list;
 	struct cam_ctx_request      *req_list;
 	uint32_t                     req_size;
+	uint32_t                     req_init_size;
+	struct cam_ctx_request      *req_pool;
+	uint32_t                     req_cfg_max;
+	struct cam_ctx_req_pool_stats req_pool_stats;
+	struct list_head             req_pool_entry;
 
 	struct cam_hw_mgr_intf      *hw_mgr_intf;
 	struct cam_req_mgr_crm_cb   *ctx_crm_intf;
@@ -7,6 +7,7 @@
 #include <linux/debugfs.h>
 #include <linux/videodev2.h>
 #include <linux/slab.h>
+#include <linux/mm.h>
 #include <linux/uaccess.h>
 #include <media/cam_sync.h>
 #include <media/cam_defs.h>
@@ -23,6 +24,16 @@
 static uint cam_debug_ctx_req_list;
 module_param(cam_debug_ctx_req_list, uint, 0644);
 
+/* Request pool geometry used at acquire, 0 keeps the context default */
+static uint cam_ctx_req_pool_depth;
+module_param(cam_ctx_req_pool_depth, uint, 0644);
+static uint cam_ctx_req_cfg_max;
+module_param(cam_ctx_req_cfg_max, uint, 0644);
+
+static LIST_HEAD(cam_ctx_req_pool_list);
+static DEFINE_MUTEX(cam_ctx_req_pool_mutex);
+static struct dentry *cam_ctx_dentry;
+
 static inline int cam_context_validate_thread(void)
 {
 	if (in_interrupt()) {
@@ -32,6 +43,163 @@ static inline int cam_context_validate_thread(void)
 	return 0;
 }
 
+/* Called with ctx->lock held */
+static bool cam_context_req_outstanding(struct cam_context *ctx)
+{
+	struct cam_ctx_request *req;
+	uint32_t                num_free = 0;
+
+	if (!list_empty(&ctx->active_req_list) ||
+		!list_empty(&ctx->pending_req_list) ||
+		!list_empty(&ctx->wait_req_list))
+		return true;
+
+	list_for_each_entry(req, &ctx->free_req_list, list)
+		num_free++;
+
+	return num_free != ctx->req_size;
+}
+
+static int cam_context_alloc_req_pool(struct cam_context *ctx)
+{
+	struct cam_ctx_request        *pool;
+	struct cam_hw_update_entry    *hw_entries;
+	struct cam_hw_fence_map_entry *map_entries;
+	uint32_t                       depth, cfg_max, i;
+	bool                           busy;
+
+	depth = cam_ctx_req_pool_depth ? min_t(uint32_t,
+		cam_ctx_req_pool_depth, CAM_CTX_REQ_POOL_MAX) :
+		ctx->req_init_size;
+	cfg_max = cam_ctx_req_cfg_max ? min_t(uint32_t,
+		cam_ctx_req_cfg_max, CAM_CTX_CFG_POOL_MAX) : CAM_CTX_CFG_MAX;
+
+	if (ctx->req_pool && ctx->req_size == depth &&
+		ctx->req_cfg_max == cfg_max)
+		return 0;
+
+	/*
+	 * Requests of the last session may still be referenced, the pool
+	 * is only replaced once all of them are back on the free list.
+	 * The init time storage has no map entries and is never kept.
+	 */
+	spin_lock(&ctx->lock);
+	busy = cam_context_req_outstanding(ctx);
+	spin_unlock(&ctx->lock);
+	if (busy) {
+		if (!ctx->req_pool) {
+			CAM_ERR(CAM_CTXT, "[%s][%d] Requests outstanding",
+				ctx->dev_name, ctx->ctx_id);
+			return -EBUSY;
+		}
+
+		CAM_WARN(CAM_CTXT,
+			"[%s][%d] Requests outstanding, keep pool depth %u cfg %u",
+			ctx->dev_name, ctx->ctx_id, ctx->req_size,
+			ctx->req_cfg_max);
+		return 0;
+	}
+
+	pool = kvzalloc(depth * (sizeof(*pool) +
+		cfg_max * (sizeof(*hw_entries) + 2 * sizeof(*map_entries))),
+		GFP_KERNEL);
+	if (!pool)
+		return -ENOMEM;
+
+	hw_entries = (struct cam_hw_update_entry *)(pool + depth);
+	map_entries = (struct cam_hw_fence_map_entry *)
+		(hw_entries + depth * cfg_max);
+	for (i = 0; i < depth; i++) {
+		INIT_LIST_HEAD(&pool[i].list);
+		pool[i].ctx = ctx;
+		pool[i].hw_update_entries = hw_entries + i * cfg_max;
+		pool[i].in_map_entries = map_entries + 2 * i * cfg_max;
+		pool[i].out_map_entries = pool[i].in_map_entries + cfg_max;
+	}
+
+	spin_lock(&ctx->lock);
+	INIT_LIST_HEAD(&ctx->free_req_list);
+	for (i = 0; i < depth; i++)
+		list_add_tail(&pool[i].list, &ctx->free_req_list);
+	spin_unlock(&ctx->lock);
+
+	kvfree(ctx->req_pool);
+	ctx->req_pool = pool;
+	ctx->req_list = pool;
+	ctx->req_size = depth;
+	ctx->req_cfg_max = cfg_max;
+	memset(&ctx->req_pool_stats, 0, sizeof(ctx->req_pool_stats));
+
+	mutex_lock(&cam_ctx_req_pool_mutex);
+	if (list_empty(&ctx->req_pool_entry))
+		list_add_tail(&ctx->req_pool_entry, &cam_ctx_req_pool_list);
+	mutex_unlock(&cam_ctx_req_pool_mutex);
+
+	CAM_DBG(CAM_CTXT, "[%s][%d] request pool depth %u cfg %u",
+		ctx->dev_name, ctx->ctx_id, depth, cfg_max);
+
+	return 0;
+}
+
+void cam_context_free_req_pool(struct cam_context *ctx)
+{
+	if (!ctx->req_pool)
+		return;
+
+	mutex_lock(&cam_ctx_req_pool_mutex);
+	list_del_init(&ctx->req_pool_entry);
+	mutex_unlock(&cam_ctx_req_pool_mutex);
+
+	kvfree(ctx->req_pool);
+	ctx->req_pool = NULL;
+}
+
+/* Called with ctx->lock held after a request is taken from the pool */
+static void cam_context_update_req_in_use(struct cam_context *ctx)
+{
+	struct cam_ctx_request *req;
+	uint32_t                num_free = 0;
+
+	list_for_each_entry(req, &ctx->free_req_list, list)
+		num_free++;
+
+	if (ctx->req_size - num_free > ctx->req_pool_stats.in_use_hwm)
+		ctx->req_pool_stats.in_use_hwm = ctx->req_size - num_free;
+}
+
+/*
+ * Map entries past the used counts are kept zeroed, so only the part the
+ * last user filled needs clearing. A failed prepare may have written past
+ * its counts, @full clears the whole request then.
+ */
+static void cam_context_reset_req(struct cam_context *ctx,
+	struct cam_ctx_request *req, bool full)
+{
+	uint32_t num_hw, num_in, num_out;
+
+	num_hw = full ? ctx->req_cfg_max : req->num_hw_update_entries;
+	num_in = full ? ctx->req_cfg_max : req->num_in_map_entries;
+	num_out = full ? ctx->req_cfg_max : req->num_out_map_entries;
+
+	memset(req->hw_update_entries, 0,
+		num_hw * sizeof(struct cam_hw_update_entry));
+	memset(req->in_map_entries, 0,
+		num_in * sizeof(struct cam_hw_fence_map_entry));
+	memset(req->out_map_entries, 0,
+		num_out * sizeof(struct cam_hw_fence_map_entry));
+
+	req->status = 0;
+	req->request_id = 0;
+	req->req_priv = NULL;
+	req->num_hw_update_entries = 0;
+	req->num_in_map_entries = 0;
+	req->num_out_map_entries = 0;
+	atomic_set(&req->num_in_acked, 0);
+	req->num_out_acked = 0;
+	req->flushed = 0;
+	memset(&req->pf_data, 0, sizeof(req->pf_data));
+}
+
 int cam_context_buf_done_from_hw(struct cam_context *ctx,
 	void *done_event_data, uint32_t evt_id)
 {
@@ -352,6 +520,9 @@ int32_t cam_context_prepare_dev_to_hw(struct cam_context *ctx,
 		req = list_first_entry(&ctx->free_req_list,
 			struct cam_ctx_request, list);
 		list_del_init(&req->list);
+		cam_context_update_req_in_use(ctx);
+	} else {
+		ctx->req_pool_stats.num_exhausted++;
 	}
 	spin_unlock(&ctx->lock);
 
@@ -361,7 +532,7 @@ int32_t cam_context_prepare_dev_to_hw(struct cam_context *ctx,
 		return -ENOMEM;
 	}
 
-	memset(req, 0, sizeof(*req));
+	cam_context_reset_req(ctx, req, false);
 	INIT_LIST_HEAD(&req->list);
 	req->ctx = ctx;
 
@@ -410,12 +581,12 @@ int32_t cam_context_prepare_dev_to_hw(struct cam_context *ctx,
 	cfg.packet = packet;
 	cfg.remain_len = remain_len;
 	cfg.ctxt_to_hw_map = ctx->ctxt_to_hw_map;
-	cfg.max_hw_update_entries = CAM_CTX_CFG_MAX;
+	cfg.max_hw_update_entries = ctx->req_cfg_max;
 	cfg.num_hw_update_entries = req->num_hw_update_entries;
 	cfg.hw_update_entries = req->hw_update_entries;
-	cfg.max_out_map_entries = CAM_CTX_CFG_MAX;
+	cfg.max_out_map_entries = ctx->req_cfg_max;
 	cfg.out_map_entries = req->out_map_entries;
-	cfg.max_in_map_entries = CAM_CTX_CFG_MAX;
+	cfg.max_in_map_entries = ctx->req_cfg_max;
 	cfg.in_map_entries = req->in_map_entries;
 	cfg.pf_data = &(req->pf_data);
 
@@ -432,6 +603,15 @@ int32_t cam_context_prepare_dev_to_hw(struct cam_context *ctx,
 	req->num_out_map_entries = cfg.num_out_map_entries;
 	req->num_in_map_entries = cfg.num_in_map_entries;
 	atomic_set(&req->num_in_acked, 0);
+
+	spin_lock(&ctx->lock);
+	ctx->req_pool_stats.hw_update_hwm = max(
+		ctx->req_pool_stats.hw_update_hwm, req->num_hw_update_entries);
+	ctx->req_pool_stats.in_map_hwm = max(
+		ctx->req_pool_stats.in_map_hwm, req->num_in_map_entries);
+	ctx->req_pool_stats.out_map_hwm = max(
+		ctx->req_pool_stats.out_map_hwm, req->num_out_map_entries);
+	spin_unlock(&ctx->lock);
 	req->request_id = packet->header.request_id;
 	req->status = 1;
 	req->req_priv = cfg.priv;
@@ -506,6 +686,7 @@ put_ref:
 				req->out_map_entries[i].sync_id);
 	}
 free_req:
+	cam_context_reset_req(ctx, req, true);
 	spin_lock(&ctx->lock);
 	list_add_tail(&req->list, &ctx->free_req_list);
 	req->ctx = NULL;
@@ -554,6 +735,13 @@ int32_t cam_context_acquire_dev_to_hw(struct cam_context *ctx,
 		goto end;
 	}
 
+	rc = cam_context_alloc_req_pool(ctx);
+	if (rc) {
+		CAM_ERR(CAM_CTXT, "[%s][%d] Request pool alloc failed",
+			ctx->dev_name, ctx->ctx_id);
+		goto end;
+	}
+
 	/* fill in parameters */
 	param.context_data = ctx;
 	param.event_cb = ctx->irq_cb_intf;
@@ -1200,3 +1388,91 @@ int32_t cam_context_dump_dev_to_hw(struct cam_context *ctx,
 	}
 	return rc;
 }
+
+static ssize_t cam_context_req_pool_read(struct file *file,
+	char __user *ubuf, size_t size, loff_t *ppos)
+{
+	const size_t line_len = 96;
+	struct cam_context *ctx;
+	struct cam_ctx_req_pool_stats stats;
+	size_t buf_size = line_len;
+	char *buf;
+	int len;
+	ssize_t rc;
+
+	mutex_lock(&cam_ctx_req_pool_mutex);
+	list_for_each_entry(ctx, &cam_ctx_req_pool_list, req_pool_entry)
+		buf_size += line_len;
+
+	buf = kvzalloc(buf_size, GFP_KERNEL);
+	if (!buf) {
+		mutex_unlock(&cam_ctx_req_pool_mutex);
+		return -ENOMEM;
+	}
+
+	len = scnprintf(buf, buf_size,
+		"dev ctx depth cfg in_use hw_update in_map out_map exhausted\n");
+	list_for_each_entry(ctx, &cam_ctx_req_pool_list, req_pool_entry) {
+		spin_lock_bh(&ctx->lock);
+		stats = ctx->req_pool_stats;
+		spin_unlock_bh(&ctx->lock);
+
+		len += scnprintf(buf + len, buf_size - len,
+			"%s %u %u %u %u %u %u %u %u\n", ctx->dev_name,
+			ctx->ctx_id, ctx->req_size, ctx->req_cfg_max,
+			stats.in_use_hwm, stats.hw_update_hwm,
+			stats.in_map_hwm, stats.out_map_hwm,
+			stats.num_exhausted);
+	}
+	mutex_unlock(&cam_ctx_req_pool_mutex);
+
+	rc = simple_read_from_buffer(ubuf, size, ppos, buf, len);
+	kvfree(buf);
+
+	return rc;
+}
+
+static ssize_t cam_context_req_pool_write(struct file *file,
+	const char __user *ubuf, size_t size, loff_t *ppos)
+{
+	struct cam_context *ctx;
+
+	mutex_lock(&cam_ctx_req_pool_mutex);
+	list_for_each_entry(ctx, &cam_ctx_req_pool_list, req_pool_entry) {
+		spin_lock_bh(&ctx->lock);
+		memset(&ctx->req_pool_stats, 0, sizeof(ctx->req_pool_stats));
+		spin_unlock_bh(&ctx->lock);
+	}
+	mutex_unlock(&cam_ctx_req_pool_mutex);
+
+	return size;
+}
+
+static const struct file_operations cam_context_req_pool_fops = {
+	.open = simple_open,
+	.read = cam_context_req_pool_read,
+	.write = cam_context_req_pool_write,
+};
+
+int cam_context_util_init(void)
+{
+	struct dentry *dbgfileptr = NULL;
+
+	dbgfileptr = debugfs_create_dir("camera_ctx", NULL);
+	if (IS_ERR_OR_NULL(dbgfileptr)) {
+		CAM_WARN(CAM_CTXT, "DebugFS could not create directory!");
+		return 0;
+	}
+	cam_ctx_dentry = dbgfileptr;
+
+	debugfs_create_file("req_pool", 0644, cam_ctx_dentry, NULL,
+		&cam_context_req_pool_fops);
+
+	return 0;
+}
+
+void cam_context_util_exit(void)
+{
+	debugfs_remove_recursive(cam_ctx_dentry);
+	cam_ctx_dentry = NULL;
+}
@@ -34,4 +34,7 @@ int32_t cam_context_dump_pf_info_to_hw(struct cam_context *ctx,
 int32_t cam_context_dump_hw_acq_info(struct cam_context *ctx);
 int32_t cam_context_dump_dev_to_hw(struct cam_context *ctx,
 	struct cam_dump_req_cmd *cmd);
+void cam_context_free_req_pool(struct cam_context *ctx);
+int cam_context_util_init(void);
+void cam_context_util_exit(void);
 #endif /* _CAM_CONTEXT_UTILS_H_ */
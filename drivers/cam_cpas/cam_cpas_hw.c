@@ -19,6 +19,16 @@
 static uint cam_min_camnoc_ib_bw;
 module_param(cam_min_camnoc_ib_bw, uint, 0644);
 
+/*
+ * Bandwidth decreases are held for this many microseconds and merged
+ * into one interconnect request. Increases always go out immediately.
+ * The window is timed with an hrtimer, so sub-jiffy values hold.
+ */
+static uint cam_cpas_vote_coalesce_us;
+module_param(cam_cpas_vote_coalesce_us, uint, 0644);
+MODULE_PARM_DESC(cam_cpas_vote_coalesce_us,
+	"Window in us over which bw decreases are merged, 0 (default) disables coalescing");
+
 static void cam_cpas_update_monitor_array(struct cam_hw_info *cpas_hw,
 	const char *identifier_string, int32_t identifier_value);
 static void cam_cpas_dump_monitor_array(
@@ -227,13 +237,48 @@ static int cam_cpas_util_vote_bus_client_bw(
 		cam_cpas_process_bw_overrides(bus_client, &ab, &ib,
 			&cam_debug->cpas_settings);
 
+	if (cam_cpas_vote_coalesce_us && bus_client->bw_voted &&
+		(ab <= bus_client->curr_ab) && (ib <= bus_client->curr_ib) &&
+		((ab != bus_client->curr_ab) || (ib != bus_client->curr_ib))) {
+		if (bus_client->bw_pending)
+			bus_client->num_merged++;
+		else
+			hrtimer_start(&bus_client->coalesce_timer,
+				ns_to_ktime((u64)cam_cpas_vote_coalesce_us *
+				NSEC_PER_USEC), HRTIMER_MODE_REL);
+		bus_client->bw_pending = true;
+		bus_client->pending_ab = ab;
+		bus_client->pending_ib = ib;
+		bus_client->num_deferred++;
+		goto applied;
+	}
+
+	/* An increase or a return to the current vote cancels the decrease */
+	if (bus_client->bw_pending) {
+		bus_client->bw_pending = false;
+		bus_client->num_merged++;
+	}
+
+	if (bus_client->bw_voted && (ab == bus_client->curr_ab) &&
+		(ib == bus_client->curr_ib)) {
+		bus_client->num_suppressed++;
+		goto applied;
+	}
+
 	rc = cam_soc_bus_client_update_bw(bus_client->soc_bus_client, ab, ib);
 	if (rc) {
 		CAM_ERR(CAM_CPAS,
 			"Update bw failed, ab[%llu] ib[%llu]",
 			ab, ib);
+		bus_client->bw_voted = false;
 		goto unlock_client;
 	}
+	bus_client->num_updates++;
+	bus_client->bw_voted = true;
+	bus_client->curr_ab = ab;
+	bus_client->curr_ib = ib;
+
+applied:
 
 	if (applied_ab)
 		*applied_ab = ab;
@@ -246,6 +291,47 @@ end:
 	return rc;
 }
 
+static enum hrtimer_restart cam_cpas_util_coalesce_timer(
+	struct hrtimer *timer)
+{
+	struct cam_cpas_bus_client *bus_client = container_of(timer,
+		struct cam_cpas_bus_client, coalesce_timer);
+
+	/* The interconnect update sleeps, commit from process context */
+	schedule_work(&bus_client->coalesce_work);
+
+	return HRTIMER_NORESTART;
+}
+
+static void cam_cpas_util_commit_bw(struct work_struct *work)
+{
+	struct cam_cpas_bus_client *bus_client = container_of(work,
+		struct cam_cpas_bus_client, coalesce_work);
+	int rc;
+
+	mutex_lock(&bus_client->lock);
+	if (!bus_client->bw_pending)
+		goto unlock_client;
+
+	bus_client->bw_pending = false;
+	rc = cam_soc_bus_client_update_bw(bus_client->soc_bus_client,
+		bus_client->pending_ab, bus_client->pending_ib);
+	if (rc) {
+		CAM_ERR(CAM_CPAS,
+			"Client: %s deferred bw update failed, ab[%llu] ib[%llu]",
+			bus_client->common_data.name, bus_client->pending_ab,
+			bus_client->pending_ib);
+		bus_client->bw_voted = false;
+		goto unlock_client;
+	}
+	bus_client->num_updates++;
+	bus_client->curr_ab = bus_client->pending_ab;
+	bus_client->curr_ib = bus_client->pending_ib;
+
+unlock_client:
+	mutex_unlock(&bus_client->lock);
+}
+
 static int cam_cpas_util_register_bus_client(
 	struct cam_hw_soc_info *soc_info, struct device_node *dev_node,
 	struct cam_cpas_bus_client *bus_client)
@@ -260,6 +346,12 @@ static int cam_cpas_util_register_bus_client(
 		return rc;
 	}
 	bus_client->curr_vote_level = 0;
+	bus_client->bw_voted = false;
+	bus_client->bw_pending = false;
+	hrtimer_init(&bus_client->coalesce_timer, CLOCK_MONOTONIC,
+		HRTIMER_MODE_REL);
+	bus_client->coalesce_timer.function = cam_cpas_util_coalesce_timer;
+	INIT_WORK(&bus_client->coalesce_work, cam_cpas_util_commit_bw);
 	bus_client->valid = true;
 	mutex_init(&bus_client->lock);
 
@@ -274,8 +366,12 @@ static int cam_cpas_util_unregister_bus_client(
 		return -EINVAL;
 	}
 
+	hrtimer_cancel(&bus_client->coalesce_timer);
+	cancel_work_sync(&bus_client->coalesce_work);
 	cam_soc_bus_client_unregister(&bus_client->soc_bus_client);
 	bus_client->curr_vote_level = 0;
+	bus_client->bw_voted = false;
+	bus_client->bw_pending = false;
 	bus_client->valid = false;
 	mutex_destroy(&bus_client->lock);
 
@@ -608,19 +704,18 @@ static int cam_cpas_axi_consolidate_path_votes(
 	struct cam_cpas_client *cpas_client,
 	struct cam_axi_vote *axi_vote)
 {
-	int rc = 0, i, k, l;
+	int rc = 0, i;
 	struct cam_axi_vote *con_axi_vote = &cpas_client->axi_vote;
-	bool path_found = false, cons_entry_found;
-	struct cam_cpas_tree_node *curr_tree_node = NULL;
-	struct cam_cpas_tree_node *sum_tree_node = NULL;
+	int8_t con_idx[CAM_CPAS_PATH_DATA_MAX][CAM_CPAS_TRANSACTION_MAX];
 	uint32_t transac_type;
 	uint32_t path_data_type;
+	int vote_path;
 	struct cam_axi_per_path_bw_vote *axi_path;
 
 	con_axi_vote->num_paths = 0;
+	memset(con_idx, -1, sizeof(con_idx));
 
 	for (i = 0; i < axi_vote->num_paths; i++) {
-		path_found = false;
 		path_data_type = axi_vote->axi_path[i].path_data_type;
 		transac_type = axi_vote->axi_path[i].transac_type;
 
@@ -631,79 +726,51 @@ static int cam_cpas_axi_consolidate_path_votes(
 			return -EINVAL;
 		}
 
+		vote_path = cpas_client->vote_path[path_data_type][transac_type];
+		if (vote_path < 0) {
+			CAM_ERR(CAM_CPAS,
+				"Client [%s][%d] Consolidated path not found for path=%d, transac=%d",
+				cpas_client->data.identifier,
+				cpas_client->data.cell_index,
+				path_data_type, transac_type);
+			return -EINVAL;
+		}
+
 		axi_path = &con_axi_vote->axi_path[con_axi_vote->num_paths];
 
-		curr_tree_node =
-			cpas_client->tree_node[path_data_type][transac_type];
-		if (curr_tree_node) {
-			path_found = true;
+		if (vote_path == path_data_type) {
 			memcpy(axi_path, &axi_vote->axi_path[i],
 				sizeof(struct cam_axi_per_path_bw_vote));
+			if (con_idx[vote_path][transac_type] < 0)
+				con_idx[vote_path][transac_type] =
+					con_axi_vote->num_paths;
 			con_axi_vote->num_paths++;
 			continue;
 		}
 
-		for (k = 0; k < CAM_CPAS_PATH_DATA_MAX; k++) {
-			sum_tree_node = cpas_client->tree_node[k][transac_type];
-
-			if (!sum_tree_node)
-				continue;
-
-			if (sum_tree_node->constituent_paths[path_data_type]) {
-				path_found = true;
-				/*
-				 * Check if corresponding consolidated path
-				 * entry is already added into consolidated list
-				 */
-				cons_entry_found = false;
-				for (l = 0; l < con_axi_vote->num_paths; l++) {
-					if ((con_axi_vote->axi_path[l]
-					.path_data_type == k) &&
-					(con_axi_vote->axi_path[l]
-					.transac_type == transac_type)) {
-						cons_entry_found = true;
-						con_axi_vote->axi_path[l]
-						.camnoc_bw +=
-						axi_vote->axi_path[i]
-						.camnoc_bw;
-
-						con_axi_vote->axi_path[l]
-						.mnoc_ab_bw +=
-						axi_vote->axi_path[i]
-						.mnoc_ab_bw;
-
-						con_axi_vote->axi_path[l]
-						.mnoc_ib_bw +=
-						axi_vote->axi_path[i]
-						.mnoc_ib_bw;
-						break;
-					}
-				}
-
-				/* If not found, add a new entry */
-				if (!cons_entry_found) {
-					axi_path->path_data_type = k;
-					axi_path->transac_type = transac_type;
-					axi_path->camnoc_bw =
-					axi_vote->axi_path[i].camnoc_bw;
-					axi_path->mnoc_ab_bw =
-					axi_vote->axi_path[i].mnoc_ab_bw;
-					axi_path->mnoc_ib_bw =
-					axi_vote->axi_path[i].mnoc_ib_bw;
-					con_axi_vote->num_paths++;
-				}
-				break;
-			}
+		/*
+		 * Check if corresponding consolidated path entry is
+		 * already added into consolidated list
+		 */
+		if (con_idx[vote_path][transac_type] >= 0) {
+			axi_path = &con_axi_vote->axi_path[
+				con_idx[vote_path][transac_type]];
+			axi_path->camnoc_bw += axi_vote->axi_path[i].camnoc_bw;
+			axi_path->mnoc_ab_bw +=
+				axi_vote->axi_path[i].mnoc_ab_bw;
+			axi_path->mnoc_ib_bw +=
+				axi_vote->axi_path[i].mnoc_ib_bw;
+			continue;
 		}
 
-		if (!path_found) {
-			CAM_ERR(CAM_CPAS,
-				"Client [%s][%d] Consolidated path not found for path=%d, transac=%d",
-				cpas_client->data.identifier,
-				cpas_client->data.cell_index,
-				path_data_type, transac_type);
-			return -EINVAL;
-		}
+		/* If not found, add a new entry */
+		axi_path->path_data_type = vote_path;
+		axi_path->transac_type = transac_type;
+		axi_path->camnoc_bw = axi_vote->axi_path[i].camnoc_bw;
+		axi_path->mnoc_ab_bw = axi_vote->axi_path[i].mnoc_ab_bw;
+		axi_path->mnoc_ib_bw = axi_vote->axi_path[i].mnoc_ib_bw;
+		con_idx[vote_path][transac_type] = con_axi_vote->num_paths;
+		con_axi_vote->num_paths++;
 	}
 
 	return rc;
@@ -827,9 +894,11 @@ static int cam_cpas_util_apply_client_axi_vote(
 		curr_camnoc_old = 0, curr_mnoc_ab_old = 0, curr_mnoc_ib_old = 0,
 		par_camnoc_old = 0, par_mnoc_ab_old = 0, par_mnoc_ib_old = 0;
 	int rc = 0, i = 0;
-	uint64_t applied_ab = 0, applied_ib = 0;
+	uint64_t applied_ab = 0, applied_ib = 0, vote_ns;
+	ktime_t start;
 
 	mutex_lock(&cpas_core->tree_lock);
+	start = ktime_get();
 	if (!cpas_client->tree_node_valid) {
 		/*
 		 * This is by assuming apply_client_axi_vote is called
@@ -970,6 +1039,7 @@ static int cam_cpas_util_apply_client_axi_vote(
 
 	if (!par_tree_node) {
 		CAM_DBG(CAM_CPAS, "No change in BW for all paths");
+		cpas_core->vote_stats.num_unchanged++;
 		rc = 0;
 		goto unlock_tree;
 	}
@@ -1020,6 +1090,11 @@ vote_start_clients:
 		CAM_ERR(CAM_CPAS, "Failed in setting axi clk rate rc=%d", rc);
 
 unlock_tree:
+	vote_ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+	cpas_core->vote_stats.num_votes++;
+	cpas_core->vote_stats.total_ns += vote_ns;
+	if (vote_ns > cpas_core->vote_stats.max_ns)
+		cpas_core->vote_stats.max_ns = vote_ns;
 	mutex_unlock(&cpas_core->tree_lock);
 	return rc;
 }
@@ -2389,6 +2464,94 @@ static int cam_cpas_util_get_internal_ops(struct platform_device *pdev,
 	return rc;
 }
 
+static void cam_cpas_util_get_bus_stats(struct cam_cpas_bus_client *client,
+	uint64_t *stats)
+{
+	if (!client->valid)
+		return;
+
+	mutex_lock(&client->lock);
+	stats[0] += client->num_updates;
+	stats[1] += client->num_suppressed;
+	stats[2] += client->num_deferred;
+	stats[3] += client->num_merged;
+	mutex_unlock(&client->lock);
+}
+
+static ssize_t cam_cpas_vote_stats_read(struct file *file,
+	char __user *ubuf, size_t size, loff_t *ppos)
+{
+	struct cam_cpas *cpas_core = file->private_data;
+	struct cam_cpas_vote_stats stats;
+	uint64_t mnoc[4] = {0}, camnoc[4] = {0};
+	char t_char[384];
+	int len, i;
+
+	mutex_lock(&cpas_core->tree_lock);
+	stats = cpas_core->vote_stats;
+	mutex_unlock(&cpas_core->tree_lock);
+
+	for (i = 0; i < cpas_core->num_axi_ports; i++)
+		cam_cpas_util_get_bus_stats(&cpas_core->axi_port[i].bus_client,
+			mnoc);
+	for (i = 0; i < cpas_core->num_camnoc_axi_ports; i++)
+		cam_cpas_util_get_bus_stats(
+			&cpas_core->camnoc_axi_port[i].bus_client, camnoc);
+
+	len = scnprintf(t_char, sizeof(t_char),
+		"votes %llu unchanged %llu avg_ns %llu max_ns %llu\n"
+		"mnoc updates %llu suppressed %llu deferred %llu merged %llu\n"
+		"camnoc updates %llu suppressed %llu deferred %llu merged %llu\n"
+		"coalesce_us %u\n",
+		stats.num_votes, stats.num_unchanged,
+		stats.num_votes ?
+		div64_u64(stats.total_ns, stats.num_votes) : 0,
+		stats.max_ns, mnoc[0], mnoc[1], mnoc[2], mnoc[3],
+		camnoc[0], camnoc[1], camnoc[2], camnoc[3],
+		cam_cpas_vote_coalesce_us);
+
+	return simple_read_from_buffer(ubuf, size, ppos, t_char, len);
+}
+
+static void cam_cpas_util_reset_bus_stats(struct cam_cpas_bus_client *client)
+{
+	if (!client->valid)
+		return;
+
+	mutex_lock(&client->lock);
+	client->num_updates = 0;
+	client->num_suppressed = 0;
+	client->num_deferred = 0;
+	client->num_merged = 0;
+	mutex_unlock(&client->lock);
+}
+
+static ssize_t cam_cpas_vote_stats_write(struct file *file,
+	const char __user *ubuf, size_t size, loff_t *ppos)
+{
+	struct cam_cpas *cpas_core = file->private_data;
+	int i;
+
+	mutex_lock(&cpas_core->tree_lock);
+	memset(&cpas_core->vote_stats, 0, sizeof(cpas_core->vote_stats));
+	mutex_unlock(&cpas_core->tree_lock);
+
+	for (i = 0; i < cpas_core->num_axi_ports; i++)
+		cam_cpas_util_reset_bus_stats(
+			&cpas_core->axi_port[i].bus_client);
+	for (i = 0; i < cpas_core->num_camnoc_axi_ports; i++)
+		cam_cpas_util_reset_bus_stats(
+			&cpas_core->camnoc_axi_port[i].bus_client);
+
+	return size;
+}
+
+static const struct file_operations cam_cpas_vote_stats_fops = {
+	.open = simple_open,
+	.read = cam_cpas_vote_stats_read,
+	.write = cam_cpas_vote_stats_write,
+};
+
 static int cam_cpas_util_create_debugfs(struct cam_cpas *cpas_core)
 {
 	int rc = 0;
@@ -2409,6 +2572,9 @@ static int cam_cpas_util_create_debugfs(struct cam_cpas *cpas_core)
 	dbgfileptr = debugfs_create_bool("full_state_dump", 0644,
 		cpas_core->dentry, &cpas_core->full_state_dump);
 
+	dbgfileptr = debugfs_create_file("axi_vote_stats", 0644,
+		cpas_core->dentry, cpas_core, &cam_cpas_vote_stats_fops);
+
 	if (IS_ERR(dbgfileptr)) {
 		if (PTR_ERR(dbgfileptr) == -ENODEV)
 			CAM_WARN(CAM_CPAS, "DebugFS not enabled in kernel!");
@@ -6,6 +6,8 @@
 #ifndef _CAM_CPAS_HW_H_
 #define _CAM_CPAS_HW_H_
 
+#include <linux/workqueue.h>
+#include <linux/hrtimer.h>
 #include <dt-bindings/msm/msm-camera.h>
 #include "cam_cpas_api.h"
 #include "cam_cpas_hw_intf.h"
@@ -124,6 +126,8 @@ struct cam_cpas_reg {
  * @axi_vote: Determined/Applied axi vote for the client
  * @axi_port: Client's parent axi port
  * @tree_node: All granular path voting nodes for the client
+ * @vote_path: Path data type of the tree node each path/transaction
+ *             votes into, -1 if the client has no node for it
  *
  */
 struct cam_cpas_client {
@@ -136,6 +140,7 @@ struct cam_cpas_client {
 	struct cam_cpas_axi_port *axi_port;
 	struct cam_cpas_tree_node *tree_node[CAM_CPAS_PATH_DATA_MAX]
 		[CAM_CPAS_TRANSACTION_MAX];
+	int8_t vote_path[CAM_CPAS_PATH_DATA_MAX][CAM_CPAS_TRANSACTION_MAX];
 };
 
 /**
@@ -147,6 +152,18 @@ struct cam_cpas_client {
  * @curr_vote_level: current voted index
  * @common_data: Common data fields for bus client
  * @soc_bus_client: Bus client private information
+ * @bw_voted: Whether @curr_ab and @curr_ib hold a vote in effect
+ * @curr_ab: ab bw last sent to the interconnect
+ * @curr_ib: ib bw last sent to the interconnect
+ * @num_updates: bw requests sent to the interconnect
+ * @num_suppressed: bw requests dropped as unchanged
+ * @bw_pending: A deferred bw decrease is waiting for @coalesce_timer
+ * @pending_ab: Deferred ab bw
+ * @pending_ib: Deferred ib bw
+ * @coalesce_timer: Ends the coalescing window
+ * @coalesce_work: Commits the deferred decrease once the window ends
+ * @num_deferred: bw decreases deferred to the coalescing window
+ * @num_merged: Deferred decreases replaced before they were committed
  */
 struct cam_cpas_bus_client {
 	bool valid;
@@ -154,6 +171,18 @@ struct cam_cpas_bus_client {
 	unsigned int curr_vote_level;
 	struct cam_soc_bus_client_common_data common_data;
 	void *soc_bus_client;
+	bool bw_voted;
+	uint64_t curr_ab;
+	uint64_t curr_ib;
+	uint64_t num_updates;
+	uint64_t num_suppressed;
+	bool bw_pending;
+	uint64_t pending_ab;
+	uint64_t pending_ib;
+	struct hrtimer coalesce_timer;
+	struct work_struct coalesce_work;
+	uint64_t num_deferred;
+	uint64_t num_merged;
 };
 
 /**
@@ -235,6 +264,21 @@ struct cam_cpas_monitor {
 	uint32_t                            camnoc_fill_level[5];
 };
 
+/**
+ * struct cam_cpas_vote_stats : Client axi vote statistics
+ *
+ * @num_votes: Client axi votes applied
+ * @num_unchanged: Votes that left every tree node unchanged
+ * @total_ns: Time spent applying votes
+ * @max_ns: Longest time spent applying a single vote
+ */
+struct cam_cpas_vote_stats {
+	uint64_t num_votes;
+	uint64_t num_unchanged;
+	uint64_t total_ns;
+	uint64_t max_ns;
+};
+
 /**
  * struct cam_cpas : CPAS core data structure info
  *
@@ -261,6 +305,7 @@ struct cam_cpas_monitor {
  * @monitor_head: Monitor array head
  * @monitor_entries: cpas monitor array
  * @full_state_dump: Whether to enable full cpas state dump or not
+ * @vote_stats: Client axi vote statistics, protected by tree_lock
  */
 struct cam_cpas {
 	struct cam_cpas_hw_caps hw_caps;
@@ -286,6 +331,7 @@ struct cam_cpas {
 	atomic64_t  monitor_head;
 	struct cam_cpas_monitor monitor_entries[CAM_CPAS_MONITOR_MAX_ENTRIES];
 	bool full_state_dump;
+	struct cam_cpas_vote_stats vote_stats;
 };
 
 int cam_camsstop_get_internal_ops(struct cam_cpas_internal_ops *internal_ops);
@@ -174,6 +174,38 @@ static int cam_cpas_update_camnoc_node(struct cam_cpas *cpas_core,
 	return 0;
 }
 
+static void cam_cpas_util_build_vote_path(struct cam_cpas *cpas_core,
+	struct cam_cpas_private_soc *soc_private)
+{
+	struct cam_cpas_client *client;
+	struct cam_cpas_tree_node *node;
+	int i, p, t, k;
+
+	for (i = 0; i < soc_private->num_clients; i++) {
+		client = cpas_core->cpas_client[i];
+		if (!client)
+			continue;
+
+		memset(client->vote_path, -1, sizeof(client->vote_path));
+		for (t = 0; t < CAM_CPAS_TRANSACTION_MAX; t++) {
+			for (p = 0; p < CAM_CPAS_PATH_DATA_MAX; p++) {
+				if (client->tree_node[p][t]) {
+					client->vote_path[p][t] = p;
+					continue;
+				}
+
+				for (k = 0; k < CAM_CPAS_PATH_DATA_MAX; k++) {
+					node = client->tree_node[k][t];
+					if (node && node->constituent_paths[p]) {
+						client->vote_path[p][t] = k;
+						break;
+					}
+				}
+			}
+		}
+	}
+}
+
 static int cam_cpas_parse_node_tree(struct cam_cpas *cpas_core,
 	struct device_node *of_node, struct cam_cpas_private_soc *soc_private)
 {
@@ -460,6 +492,7 @@ static int cam_cpas_parse_node_tree(struct cam_cpas *cpas_core,
 			}
 		}
 	}
+	cam_cpas_util_build_vote_path(cpas_core, soc_private);
 	mutex_init(&cpas_core->tree_lock);
 	cam_cpas_util_debug_parse_data(soc_private);
 
@@ -67,6 +67,18 @@ struct hfi_ops {
  */
 int hfi_write_cmd(void *cmd_ptr);
 
+/**
+ * hfi_write_cmd_batch() - write several commands with one doorbell
+ * @cmd_ptrs: array of pointers to command data for hfi write
+ * @num_cmds: number of commands in @cmd_ptrs
+ *
+ * All commands are reserved and published together, either all of
+ * them reach the queue or none do.
+ *
+ * Returns success(zero)/failure(non zero)
+ */
+int hfi_write_cmd_batch(void **cmd_ptrs, uint32_t num_cmds);
+
 /**
  * hfi_read_message() - function for hfi read
  * @pmsg: buffer to place read message for hfi queue
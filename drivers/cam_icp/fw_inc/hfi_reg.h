@@ -7,6 +7,8 @@
 #define _CAM_HFI_REG_H_
 
 #include <linux/types.h>
+#include <linux/spinlock.h>
+#include <linux/semaphore.h>
 #include "hfi_intf.h"
 
 /* general purpose registers */
@@ -263,6 +265,19 @@ struct hfi_qtbl {
 	struct hfi_q_hdr q_hdr[MAX_ICP_HFI_QUEUES];
 };
 
+/* Command queue reservations that may be outstanding at once */
+#define HFI_CMD_Q_MAX_RSV 8
+
+/**
+ * struct hfi_cmd_q_rsv
+ * @end_idx: Queue write index right after this reservation
+ * @done: Producer finished copying its packets
+ */
+struct hfi_cmd_q_rsv {
+	uint32_t end_idx;
+	bool done;
+};
+
 /**
  * struct hfi_info
  * @map: Hfi shared memory info
@@ -276,6 +291,12 @@ struct hfi_qtbl {
  * @mutex msg_q_lock: Lock for message queue
  * @msg_q_state: State of message queue
  * @priv: device private data
+ * @cmd_q_rsv_lock: Protects the command queue reservation state
+ * @cmd_q_rsv_sem: Bounds outstanding reservations to HFI_CMD_Q_MAX_RSV
+ * @cmd_q_reserve_idx: Shadow write index claimed by command producers
+ * @cmd_q_rsv: Outstanding reservations in queue order
+ * @cmd_q_rsv_head: Oldest outstanding reservation in @cmd_q_rsv
+ * @cmd_q_rsv_cnt: Number of outstanding reservations
  */
 struct hfi_info {
 	struct hfi_mem_info map;
@@ -289,6 +310,12 @@ struct hfi_info {
 	struct mutex msg_q_lock;
 	bool msg_q_state;
 	void *priv;
+	spinlock_t cmd_q_rsv_lock;
+	struct semaphore cmd_q_rsv_sem;
+	uint32_t cmd_q_reserve_idx;
+	struct hfi_cmd_q_rsv cmd_q_rsv[HFI_CMD_Q_MAX_RSV];
+	uint32_t cmd_q_rsv_head;
+	uint32_t cmd_q_rsv_cnt;
 };
 
 #endif /* _CAM_HFI_REG_H_ */
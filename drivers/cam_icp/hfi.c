@@ -9,6 +9,7 @@
 #include <linux/random.h>
 #include <asm/errno.h>
 #include <linux/timer.h>
+#include <linux/rwsem.h>
 #include <media/cam_icp.h>
 #include <linux/iopoll.h>
 
@@ -37,7 +38,7 @@
 
 static struct hfi_info *g_hfi;
 unsigned int g_icp_mmu_hdl;
-static DEFINE_MUTEX(hfi_cmd_q_mutex);
+static DECLARE_RWSEM(hfi_cmd_q_rwsem);
 static DEFINE_MUTEX(hfi_msg_q_mutex);
 
 static void hfi_irq_raise(struct hfi_info *hfi)
@@ -134,20 +135,68 @@ void cam_hfi_queue_dump(void)
 	hfi_queue_dump(dwords, num_dwords);
 }
 
-int hfi_write_cmd(void *cmd_ptr)
+static uint32_t hfi_cmd_q_copy(uint32_t *write_q, uint32_t q_size,
+	uint32_t write_idx, void *cmd_ptr)
 {
-	uint32_t size_in_words, empty_space, new_write_idx, read_idx, temp;
-	uint32_t *write_q, *write_ptr;
+	uint32_t size_in_words, new_write_idx, temp;
+
+	size_in_words = (*(uint32_t *)cmd_ptr) >> BYTE_WORD_SHIFT;
+	new_write_idx = write_idx + size_in_words;
+
+	if (new_write_idx < q_size) {
+		memcpy(write_q + write_idx, (uint8_t *)cmd_ptr,
+			size_in_words << BYTE_WORD_SHIFT);
+	} else {
+		new_write_idx -= q_size;
+		temp = (size_in_words - new_write_idx) << BYTE_WORD_SHIFT;
+		memcpy(write_q + write_idx, (uint8_t *)cmd_ptr, temp);
+		memcpy(write_q, (uint8_t *)cmd_ptr + temp,
+			new_write_idx << BYTE_WORD_SHIFT);
+	}
+
+	return new_write_idx;
+}
+
+/*
+ * Producers claim queue space and a reservation slot under a spinlock,
+ * then copy their packets without holding any lock. Whoever completes
+ * the oldest outstanding reservation moves the queue header write index
+ * over every finished reservation and rings the doorbell, so firmware
+ * never sees a packet whose predecessor is still being copied and no
+ * producer waits on another one's copy. The rwsem only keeps init and
+ * deinit from tearing the queue down underneath.
+ */
+int hfi_write_cmd_batch(void **cmd_ptrs, uint32_t num_cmds)
+{
+	uint32_t size_in_words, total_words = 0, empty_space, read_idx;
+	uint32_t start_idx, end_idx, write_idx = 0, q_size, slot, i;
+	uint32_t *write_q;
 	struct hfi_qtbl *q_tbl;
 	struct hfi_q_hdr *q;
+	struct hfi_cmd_q_rsv *rsv;
+	bool publish = false;
 	int rc = 0;
 
-	if (!cmd_ptr) {
-		CAM_ERR(CAM_HFI, "command is null");
+	if (!cmd_ptrs || !num_cmds) {
+		CAM_ERR(CAM_HFI, "Invalid args %pK %u", cmd_ptrs, num_cmds);
 		return -EINVAL;
 	}
 
-	mutex_lock(&hfi_cmd_q_mutex);
+	for (i = 0; i < num_cmds; i++) {
+		if (!cmd_ptrs[i]) {
+			CAM_ERR(CAM_HFI, "command %u is null", i);
+			return -EINVAL;
+		}
+
+		size_in_words = (*(uint32_t *)cmd_ptrs[i]) >> BYTE_WORD_SHIFT;
+		if (!size_in_words) {
+			CAM_DBG(CAM_HFI, "failed");
+			return -EINVAL;
+		}
+		total_words += size_in_words;
+	}
+
+	down_read(&hfi_cmd_q_rwsem);
 	if (!g_hfi) {
 		CAM_ERR(CAM_HFI, "HFI interface not setup");
 		rc = -ENODEV;
@@ -164,60 +213,90 @@ int hfi_write_cmd(void *cmd_ptr)
 
 	q_tbl = (struct hfi_qtbl *)g_hfi->map.qtbl.kva;
 	q = &q_tbl->q_hdr[Q_CMD];
+	q_size = q->qhdr_q_size;
 
 	write_q = (uint32_t *)g_hfi->map.cmd_q.kva;
 
-	size_in_words = (*(uint32_t *)cmd_ptr) >> BYTE_WORD_SHIFT;
-	if (!size_in_words) {
-		CAM_DBG(CAM_HFI, "failed");
-		rc = -EINVAL;
-		goto err;
-	}
-
-	read_idx = q->qhdr_read_idx;
-	empty_space = (q->qhdr_write_idx >= read_idx) ?
-		(q->qhdr_q_size - (q->qhdr_write_idx - read_idx)) :
-		(read_idx - q->qhdr_write_idx);
-	if (empty_space <= size_in_words) {
+	down(&g_hfi->cmd_q_rsv_sem);
+	spin_lock(&g_hfi->cmd_q_rsv_lock);
+	start_idx = g_hfi->cmd_q_reserve_idx;
+	read_idx = READ_ONCE(q->qhdr_read_idx);
+	empty_space = (start_idx >= read_idx) ?
+		(q_size - (start_idx - read_idx)) :
+		(read_idx - start_idx);
+	if (empty_space <= total_words) {
+		spin_unlock(&g_hfi->cmd_q_rsv_lock);
+		up(&g_hfi->cmd_q_rsv_sem);
 		CAM_ERR(CAM_HFI, "failed: empty space %u, size_in_words %u",
-			empty_space, size_in_words);
+			empty_space, total_words);
 		rc = -EIO;
 		goto err;
 	}
 
-	new_write_idx = q->qhdr_write_idx + size_in_words;
-	write_ptr = (uint32_t *)(write_q + q->qhdr_write_idx);
+	end_idx = start_idx + total_words;
+	if (end_idx >= q_size)
+		end_idx -= q_size;
+	g_hfi->cmd_q_reserve_idx = end_idx;
 
-	if (new_write_idx < q->qhdr_q_size) {
-		memcpy(write_ptr, (uint8_t *)cmd_ptr,
-			size_in_words << BYTE_WORD_SHIFT);
-	} else {
-		new_write_idx -= q->qhdr_q_size;
-		temp = (size_in_words - new_write_idx) << BYTE_WORD_SHIFT;
-		memcpy(write_ptr, (uint8_t *)cmd_ptr, temp);
-		memcpy(write_q, (uint8_t *)cmd_ptr + temp,
-			new_write_idx << BYTE_WORD_SHIFT);
-	}
+	slot = (g_hfi->cmd_q_rsv_head + g_hfi->cmd_q_rsv_cnt) %
+		HFI_CMD_Q_MAX_RSV;
+	g_hfi->cmd_q_rsv[slot].end_idx = end_idx;
+	g_hfi->cmd_q_rsv[slot].done = false;
+	g_hfi->cmd_q_rsv_cnt++;
+	spin_unlock(&g_hfi->cmd_q_rsv_lock);
 
-	/*
-	 * To make sure command data in a command queue before
-	 * updating write index
-	 */
-	wmb();
+	for (i = 0; i < num_cmds; i++)
+		start_idx = hfi_cmd_q_copy(write_q, q_size, start_idx,
+			cmd_ptrs[i]);
 
-	q->qhdr_write_idx = new_write_idx;
+	spin_lock(&g_hfi->cmd_q_rsv_lock);
+	g_hfi->cmd_q_rsv[slot].done = true;
+	while (g_hfi->cmd_q_rsv_cnt) {
+		rsv = &g_hfi->cmd_q_rsv[g_hfi->cmd_q_rsv_head];
+		if (!rsv->done)
+			break;
 
-	/*
-	 * Before raising interrupt make sure command data is ready for
-	 * firmware to process
-	 */
-	wmb();
-	hfi_irq_raise(g_hfi);
+		write_idx = rsv->end_idx;
+		g_hfi->cmd_q_rsv_head = (g_hfi->cmd_q_rsv_head + 1) %
+			HFI_CMD_Q_MAX_RSV;
+		g_hfi->cmd_q_rsv_cnt--;
+		up(&g_hfi->cmd_q_rsv_sem);
+		publish = true;
+	}
+
+	if (publish) {
+		/*
+		 * To make sure command data in a command queue before
+		 * updating write index
+		 */
+		wmb();
+		q->qhdr_write_idx = write_idx;
+	}
+	spin_unlock(&g_hfi->cmd_q_rsv_lock);
+
+	if (publish) {
+		/*
+		 * Before raising interrupt make sure command data is ready
+		 * for firmware to process
+		 */
+		wmb();
+		hfi_irq_raise(g_hfi);
+	}
 err:
-	mutex_unlock(&hfi_cmd_q_mutex);
+	up_read(&hfi_cmd_q_rwsem);
 	return rc;
 }
 
+int hfi_write_cmd(void *cmd_ptr)
+{
+	if (!cmd_ptr) {
+		CAM_ERR(CAM_HFI, "command is null");
+		return -EINVAL;
+	}
+
+	return hfi_write_cmd_batch(&cmd_ptr, 1);
+}
+
 int hfi_read_message(uint32_t *pmsg, uint8_t q_id,
 	uint32_t *words_read)
 {
@@ -665,7 +744,7 @@ int cam_hfi_init(struct hfi_mem_info *hfi_mem, const struct hfi_ops *hfi_ops,
 		return -EINVAL;
 	}
 
-	mutex_lock(&hfi_cmd_q_mutex);
+	down_write(&hfi_cmd_q_rwsem);
 	mutex_lock(&hfi_msg_q_mutex);
 
 	if (!g_hfi) {
@@ -703,6 +782,11 @@ int cam_hfi_init(struct hfi_mem_info *hfi_mem, const struct hfi_ops *hfi_ops,
 	cmd_q_hdr->qhdr_pkt_drop_cnt = RESET;
 	cmd_q_hdr->qhdr_read_idx = RESET;
 	cmd_q_hdr->qhdr_write_idx = RESET;
+	spin_lock_init(&g_hfi->cmd_q_rsv_lock);
+	sema_init(&g_hfi->cmd_q_rsv_sem, HFI_CMD_Q_MAX_RSV);
+	g_hfi->cmd_q_reserve_idx = RESET;
+	g_hfi->cmd_q_rsv_head = RESET;
+	g_hfi->cmd_q_rsv_cnt = RESET;
 
 	/* setup firmware-to-Host message queue */
 	msg_q_hdr = &qtbl->q_hdr[Q_MSG];
@@ -877,7 +961,7 @@ int cam_hfi_init(struct hfi_mem_info *hfi_mem, const struct hfi_ops *hfi_ops,
 
 	hfi_irq_enable(g_hfi);
 
-	mutex_unlock(&hfi_cmd_q_mutex);
+	up_write(&hfi_cmd_q_rwsem);
 	mutex_unlock(&hfi_msg_q_mutex);
 
 	return rc;
@@ -885,14 +969,14 @@ regions_fail:
 	kfree(g_hfi);
 	g_hfi = NULL;
 alloc_fail:
-	mutex_unlock(&hfi_cmd_q_mutex);
+	up_write(&hfi_cmd_q_rwsem);
 	mutex_unlock(&hfi_msg_q_mutex);
 	return rc;
 }
 
 void cam_hfi_deinit(void)
 {
-	mutex_lock(&hfi_cmd_q_mutex);
+	down_write(&hfi_cmd_q_rwsem);
 	mutex_lock(&hfi_msg_q_mutex);
 
 	if (!g_hfi) {
@@ -907,6 +991,6 @@ void cam_hfi_deinit(void)
 	g_hfi = NULL;
 
 err:
-	mutex_unlock(&hfi_cmd_q_mutex);
+	up_write(&hfi_cmd_q_rwsem);
 	mutex_unlock(&hfi_msg_q_mutex);
 }
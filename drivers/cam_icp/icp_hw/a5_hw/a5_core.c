@@ -14,6 +14,7 @@
 #include <linux/timer.h>
 #include <linux/elf.h>
 #include <linux/iopoll.h>
+#include <linux/crc32.h>
 #include <media/cam_icp.h>
 #include "cam_io_util.h"
 #include "cam_a5_hw_intf.h"
@@ -136,69 +137,115 @@ static int32_t cam_icp_get_fw_size(const uint8_t *elf, uint32_t *fw_size)
 	return rc;
 }
 
-static int32_t cam_icp_program_fw(const uint8_t *elf,
-		struct cam_a5_device_core_info *core_info)
+static int32_t cam_icp_parse_fw_segs(const struct firmware *fw_elf,
+	struct cam_a5_fw_cache *fw_cache)
 {
-	int32_t rc = 0;
-	uint32_t num_prg_hdrs;
+	uint32_t num_prg_hdrs, num_segs = 0;
 	unsigned char *icp_prg_hdr_tbl;
 	int32_t i = 0;
-	u8 *dest;
-	u8 *src;
 	struct elf32_hdr *elf_hdr;
 	struct elf32_phdr *prg_hdr;
+	struct cam_a5_fw_seg *seg;
 
-	elf_hdr = (struct elf32_hdr *)elf;
+	elf_hdr = (struct elf32_hdr *)fw_elf->data;
 	num_prg_hdrs = elf_hdr->e_phnum;
-	icp_prg_hdr_tbl = (unsigned char *)elf + elf_hdr->e_phoff;
+	icp_prg_hdr_tbl = (unsigned char *)fw_elf->data + elf_hdr->e_phoff;
 	prg_hdr = (struct elf32_phdr *)&icp_prg_hdr_tbl[0];
 
-	if (!prg_hdr) {
-		CAM_ERR(CAM_ICP, "failed to get elf program header attr");
-		return -EINVAL;
-	}
+	fw_cache->segs = kcalloc(num_prg_hdrs, sizeof(*fw_cache->segs),
+		GFP_KERNEL);
+	if (!fw_cache->segs)
+		return -ENOMEM;
 
 	for (i = 0; i < num_prg_hdrs; i++, prg_hdr++) {
-		if (prg_hdr->p_flags == 0)
+		if (prg_hdr->p_flags == 0 || prg_hdr->p_filesz == 0)
 			continue;
 
-		CAM_DBG(CAM_ICP, "Loading FW header size: %u",
-			prg_hdr->p_filesz);
-		if (prg_hdr->p_filesz != 0) {
-			src = (u8 *)((u8 *)elf + prg_hdr->p_offset);
-			dest = (u8 *)(((u8 *)core_info->fw_kva_addr) +
-				prg_hdr->p_vaddr);
+		if ((uint64_t)prg_hdr->p_offset + prg_hdr->p_filesz >
+			fw_elf->size) {
+			CAM_ERR(CAM_ICP, "segment %d out of elf: %x %x %zu",
+				i, prg_hdr->p_offset, prg_hdr->p_filesz,
+				fw_elf->size);
+			kfree(fw_cache->segs);
+			fw_cache->segs = NULL;
+			return -EINVAL;
+		}
 
-			memcpy_toio(dest, src, prg_hdr->p_filesz);
+		seg = &fw_cache->segs[num_segs++];
+		seg->vaddr = prg_hdr->p_vaddr;
+		seg->filesz = prg_hdr->p_filesz;
+		seg->offset = prg_hdr->p_offset;
+		seg->writable = !!(prg_hdr->p_flags & PF_W);
+		if (!seg->writable)
+			seg->crc = crc32_le(~0, fw_elf->data + seg->offset,
+				seg->filesz);
+	}
+	fw_cache->num_segs = num_segs;
+
+	return 0;
+}
+
+/*
+ * On a warm boot read only segments are checked in place and only
+ * rewritten if the fw buffer no longer holds them. Writable segments
+ * are always reloaded since firmware modifies them while running.
+ */
+static int32_t cam_icp_program_fw(struct cam_a5_device_core_info *core_info,
+	struct cam_icp_a5_fw_download_args *args)
+{
+	struct cam_a5_fw_cache *fw_cache = &core_info->fw_cache;
+	struct cam_a5_fw_seg *seg;
+	bool warm;
+	int32_t i = 0;
+	u8 *dest;
+	const u8 *src;
+
+	warm = (fw_cache->loaded_kva == core_info->fw_kva_addr);
+	for (i = 0; i < fw_cache->num_segs; i++) {
+		seg = &fw_cache->segs[i];
+		src = core_info->fw_elf->data + seg->offset;
+		dest = (u8 *)(((u8 *)core_info->fw_kva_addr) + seg->vaddr);
+
+		if (warm && !seg->writable &&
+			crc32_le(~0, dest, seg->filesz) == seg->crc) {
+			args->segs_skipped++;
+			continue;
 		}
+
+		CAM_DBG(CAM_ICP, "Loading FW header size: %u", seg->filesz);
+		memcpy_toio(dest, src, seg->filesz);
+		args->segs_copied++;
 	}
+	fw_cache->loaded_kva = core_info->fw_kva_addr;
 
-	return rc;
+	return 0;
 }
 
-static int32_t cam_a5_download_fw(void *device_priv)
+void cam_a5_free_fw_cache(struct cam_a5_device_core_info *core_info)
+{
+	struct cam_a5_fw_cache *fw_cache = &core_info->fw_cache;
+
+	kfree(fw_cache->segs);
+	release_firmware(core_info->fw_elf);
+	core_info->fw_elf = NULL;
+	memset(fw_cache, 0, sizeof(*fw_cache));
+}
+
+static int32_t cam_a5_load_fw(struct cam_hw_info *a5_dev,
+	struct cam_icp_a5_fw_download_args *args)
 {
 	int32_t rc = 0;
-	uint32_t fw_size;
 	const uint8_t *fw_start = NULL;
-	struct cam_hw_info *a5_dev = device_priv;
-	struct cam_hw_soc_info *soc_info = NULL;
 	struct cam_a5_device_core_info *core_info = NULL;
-	struct cam_a5_device_hw_info *hw_info = NULL;
-	struct platform_device         *pdev = NULL;
+	struct platform_device *pdev = NULL;
 	struct a5_soc_info *cam_a5_soc_info = NULL;
+	ktime_t start;
 
-	if (!device_priv) {
-		CAM_ERR(CAM_ICP, "Invalid cam_dev_info");
-		return -EINVAL;
-	}
-
-	soc_info = &a5_dev->soc_info;
 	core_info = (struct cam_a5_device_core_info *)a5_dev->core_info;
-	hw_info = core_info->a5_hw_info;
-	pdev = soc_info->pdev;
-	cam_a5_soc_info = soc_info->soc_private;
+	pdev = a5_dev->soc_info.pdev;
+	cam_a5_soc_info = a5_dev->soc_info.soc_private;
 
+	start = ktime_get();
 	if (cam_a5_soc_info->fw_name) {
 		CAM_INFO(CAM_ICP, "Downloading firmware %s",
 			cam_a5_soc_info->fw_name);
@@ -219,38 +266,84 @@ static int32_t cam_a5_download_fw(void *device_priv)
 
 	if (!core_info->fw_elf) {
 		CAM_ERR(CAM_ICP, "Invalid elf size");
-		rc = -EINVAL;
-		goto fw_download_failed;
+		return -EINVAL;
 	}
+	args->load_us = ktime_us_delta(ktime_get(), start);
 
+	start = ktime_get();
 	fw_start = core_info->fw_elf->data;
 	rc = cam_icp_validate_fw(fw_start);
 	if (rc) {
 		CAM_ERR(CAM_ICP, "fw elf validation failed");
-		goto fw_download_failed;
+		goto fw_parse_failed;
 	}
 
-	rc = cam_icp_get_fw_size(fw_start, &fw_size);
+	rc = cam_icp_get_fw_size(fw_start, &core_info->fw_cache.fw_size);
 	if (rc) {
 		CAM_ERR(CAM_ICP, "unable to get fw size");
-		goto fw_download_failed;
+		goto fw_parse_failed;
 	}
 
-	if (core_info->fw_buf_len < fw_size) {
+	rc = cam_icp_parse_fw_segs(core_info->fw_elf, &core_info->fw_cache);
+	if (rc) {
+		CAM_ERR(CAM_ICP, "unable to parse fw segments");
+		goto fw_parse_failed;
+	}
+	args->parse_us = ktime_us_delta(ktime_get(), start);
+
+	return 0;
+
+fw_parse_failed:
+	cam_a5_free_fw_cache(core_info);
+	return rc;
+}
+
+static int32_t cam_a5_download_fw(void *device_priv,
+	struct cam_icp_a5_fw_download_args *args)
+{
+	int32_t rc = 0;
+	struct cam_hw_info *a5_dev = device_priv;
+	struct cam_a5_device_core_info *core_info = NULL;
+	struct cam_icp_a5_fw_download_args local_args = {0};
+	ktime_t start;
+
+	if (!device_priv) {
+		CAM_ERR(CAM_ICP, "Invalid cam_dev_info");
+		return -EINVAL;
+	}
+
+	if (!args)
+		args = &local_args;
+
+	core_info = (struct cam_a5_device_core_info *)a5_dev->core_info;
+	args->cache_hit = core_info->fw_cache.resident;
+	if (!args->cache_hit) {
+		rc = cam_a5_load_fw(a5_dev, args);
+		if (rc)
+			return rc;
+	}
+
+	if (core_info->fw_buf_len < core_info->fw_cache.fw_size) {
 		CAM_ERR(CAM_ICP, "mismatch in fw size: %u %llu",
-			fw_size, core_info->fw_buf_len);
+			core_info->fw_cache.fw_size, core_info->fw_buf_len);
 		rc = -EINVAL;
 		goto fw_download_failed;
 	}
 
-	rc = cam_icp_program_fw(fw_start, core_info);
+	start = ktime_get();
+	rc = cam_icp_program_fw(core_info, args);
 	if (rc) {
 		CAM_ERR(CAM_ICP, "fw program is failed");
 		goto fw_download_failed;
 	}
+	args->copy_us = ktime_us_delta(ktime_get(), start);
+
+	core_info->fw_cache.resident = args->cache_fw;
+	if (args->cache_fw)
+		return 0;
 
 fw_download_failed:
-	release_firmware(core_info->fw_elf);
+	cam_a5_free_fw_cache(core_info);
 	return rc;
 }
 
@@ -599,7 +692,7 @@ int cam_a5_process_cmd(void *device_priv, uint32_t cmd_type,
 
 	switch (cmd_type) {
 	case CAM_ICP_CMD_FW_DOWNLOAD:
-		rc = cam_a5_download_fw(device_priv);
+		rc = cam_a5_download_fw(device_priv, cmd_args);
 		break;
 	case CAM_ICP_CMD_POWER_COLLAPSE:
 		rc = cam_a5_power_collapse(a5_dev);
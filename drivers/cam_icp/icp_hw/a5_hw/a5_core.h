@@ -45,6 +45,38 @@ struct cam_a5_device_hw_info {
 	uint32_t a5_status;
 };
 
+/**
+ * struct cam_a5_fw_seg - loadable segment of the firmware elf
+ * @vaddr: Offset of the segment in the fw buffer
+ * @filesz: Size of the segment data
+ * @offset: Offset of the segment data in the elf
+ * @crc: crc32 of the segment data, valid for read only segments
+ * @writable: Firmware may modify the segment at runtime
+ */
+struct cam_a5_fw_seg {
+	uint32_t vaddr;
+	uint32_t filesz;
+	uint32_t offset;
+	uint32_t crc;
+	bool writable;
+};
+
+/**
+ * struct cam_a5_fw_cache - parsed firmware image
+ * @segs: Loadable segment table
+ * @num_segs: Number of entries in @segs
+ * @fw_size: Size of fw buffer the image needs
+ * @resident: Image and table are kept after download
+ * @loaded_kva: fw buffer the image was last written to
+ */
+struct cam_a5_fw_cache {
+	struct cam_a5_fw_seg *segs;
+	uint32_t num_segs;
+	uint32_t fw_size;
+	bool resident;
+	uintptr_t loaded_kva;
+};
+
 /**
  * struct cam_a5_device_hw_info
  * @a5_hw_info: A5 hardware info
@@ -57,6 +89,7 @@ struct cam_a5_device_hw_info {
  * @irq_cb: IRQ callback
  * @cpas_handle: CPAS handle for A5
  * @cpast_start: state variable for cpas
+ * @fw_cache: Parsed firmware image, kept across downloads on request
  */
 struct cam_a5_device_core_info {
 	struct cam_a5_device_hw_info *a5_hw_info;
@@ -70,6 +103,7 @@ struct cam_a5_device_core_info {
 	struct cam_icp_set_irq_cb irq_cb;
 	uint32_t cpas_handle;
 	bool cpas_start;
+	struct cam_a5_fw_cache fw_cache;
 };
 
 int cam_a5_init_hw(void *device_priv,
@@ -85,6 +119,11 @@ void cam_a5_irq_raise(void *priv);
 void cam_a5_irq_enable(void *priv);
 void __iomem *cam_a5_iface_addr(void *priv);
 
+/**
+ * @brief : API to drop the resident firmware image
+ */
+void cam_a5_free_fw_cache(struct cam_a5_device_core_info *core_info);
+
 /**
  * @brief : API to register a5 hw to platform framework.
  * @return struct platform_device pointer on on success, or ERR_PTR() on error.
@@ -210,6 +210,7 @@ static void cam_a5_component_unbind(struct device *dev,
 	a5_dev = a5_dev_intf->hw_priv;
 	core_info = (struct cam_a5_device_core_info *)a5_dev->core_info;
 	cam_cpas_unregister_client(core_info->cpas_handle);
+	cam_a5_free_fw_cache(core_info);
 	cam_a5_deinit_soc_resources(&a5_dev->soc_info);
 	memset(&cam_a5_soc_info, 0, sizeof(struct a5_soc_info));
 	kfree(a5_dev->core_info);
@@ -54,6 +54,9 @@
 
 #define ICP_DEVICE_IDLE_TIMEOUT 400
 
+/* Upper bound on message queue reads drained per interrupt */
+#define ICP_MSG_Q_DRAIN_MAX 16
+
 static const struct hfi_ops hfi_a5_ops = {
 	.irq_raise = cam_a5_irq_raise,
 	.irq_enable = cam_a5_irq_enable,
@@ -1896,6 +1899,108 @@ static int cam_icp_get_icp_fw_dump_lvl(void *data, u64 *val)
 DEFINE_SIMPLE_ATTRIBUTE(cam_icp_debug_fw_dump, cam_icp_get_icp_fw_dump_lvl,
 	cam_icp_set_icp_fw_dump_lvl, "%08llu");
 
+static ssize_t cam_icp_ack_stats_read(struct file *file, char __user *ubuf,
+	size_t size, loff_t *ppos)
+{
+	struct cam_icp_hw_ctx_data *ctx_data;
+	struct cam_icp_ack_stats stats;
+	char *t_char;
+	size_t buf_size = 4096;
+	int len = 0, i, j;
+	ssize_t rc;
+
+	t_char = kzalloc(buf_size, GFP_KERNEL);
+	if (!t_char)
+		return -ENOMEM;
+
+	for (i = 0; i < CAM_ICP_CTX_MAX; i++) {
+		ctx_data = &icp_hw_mgr.ctx_data[i];
+		mutex_lock(&ctx_data->ctx_mutex);
+		stats = ctx_data->ack_stats;
+		mutex_unlock(&ctx_data->ctx_mutex);
+		if (!stats.num_acks && !stats.num_stale)
+			continue;
+
+		len += scnprintf(t_char + len, buf_size - len,
+			"ctx %d: acks %llu scans %llu stale %llu avg_us %llu max_us %llu lat_us",
+			i, stats.num_acks, stats.num_scans, stats.num_stale,
+			stats.num_acks ?
+			div64_u64(stats.total_us, stats.num_acks) : 0,
+			stats.max_us);
+		for (j = 0; j < ICP_ACK_LATENCY_BUCKETS - 1; j++)
+			len += scnprintf(t_char + len, buf_size - len,
+				" <%d:%llu", 64 << j, stats.latency[j]);
+		len += scnprintf(t_char + len, buf_size - len, " >=%d:%llu\n",
+			64 << (ICP_ACK_LATENCY_BUCKETS - 2),
+			stats.latency[ICP_ACK_LATENCY_BUCKETS - 1]);
+	}
+
+	rc = simple_read_from_buffer(ubuf, size, ppos, t_char, len);
+	kfree(t_char);
+	return rc;
+}
+
+static ssize_t cam_icp_ack_stats_write(struct file *file,
+	const char __user *ubuf, size_t size, loff_t *ppos)
+{
+	struct cam_icp_hw_ctx_data *ctx_data;
+	int i;
+
+	for (i = 0; i < CAM_ICP_CTX_MAX; i++) {
+		ctx_data = &icp_hw_mgr.ctx_data[i];
+		mutex_lock(&ctx_data->ctx_mutex);
+		memset(&ctx_data->ack_stats, 0, sizeof(ctx_data->ack_stats));
+		mutex_unlock(&ctx_data->ctx_mutex);
+	}
+
+	return size;
+}
+
+static const struct file_operations cam_icp_ack_stats_fops = {
+	.open = simple_open,
+	.read = cam_icp_ack_stats_read,
+	.write = cam_icp_ack_stats_write,
+};
+
+static ssize_t cam_icp_boot_stats_read(struct file *file, char __user *ubuf,
+	size_t size, loff_t *ppos)
+{
+	struct cam_icp_fw_boot_stats stats;
+	char t_char[256];
+	int len;
+
+	mutex_lock(&icp_hw_mgr.hw_mgr_mutex);
+	stats = icp_hw_mgr.boot_stats;
+	mutex_unlock(&icp_hw_mgr.hw_mgr_mutex);
+
+	len = scnprintf(t_char, sizeof(t_char),
+		"boots %llu cache_hits %llu segs_copied %u segs_skipped %u\n"
+		"last_us total %llu load %llu parse %llu copy %llu resume %llu\n"
+		"max_total_us %llu\n",
+		stats.num_boots, stats.num_cache_hits, stats.segs_copied,
+		stats.segs_skipped, stats.total_us, stats.load_us,
+		stats.parse_us, stats.copy_us, stats.resume_us,
+		stats.max_total_us);
+
+	return simple_read_from_buffer(ubuf, size, ppos, t_char, len);
+}
+
+static ssize_t cam_icp_boot_stats_write(struct file *file,
+	const char __user *ubuf, size_t size, loff_t *ppos)
+{
+	mutex_lock(&icp_hw_mgr.hw_mgr_mutex);
+	memset(&icp_hw_mgr.boot_stats, 0, sizeof(icp_hw_mgr.boot_stats));
+	mutex_unlock(&icp_hw_mgr.hw_mgr_mutex);
+
+	return size;
+}
+
+static const struct file_operations cam_icp_boot_stats_fops = {
+	.open = simple_open,
+	.read = cam_icp_boot_stats_read,
+	.write = cam_icp_boot_stats_write,
+};
+
 static int cam_icp_hw_mgr_create_debugfs_entry(void)
 {
 	int rc = 0;
@@ -1934,6 +2039,15 @@ static int cam_icp_hw_mgr_create_debugfs_entry(void)
 	dbgfileptr = debugfs_create_bool("disable_ubwc_comp", 0644,
 		icp_hw_mgr.dentry, &icp_hw_mgr.disable_ubwc_comp);
 
+	dbgfileptr = debugfs_create_file("ack_stats", 0644,
+		icp_hw_mgr.dentry, NULL, &cam_icp_ack_stats_fops);
+
+	dbgfileptr = debugfs_create_bool("icp_fw_cache", 0644,
+		icp_hw_mgr.dentry, &icp_hw_mgr.icp_fw_cache);
+
+	dbgfileptr = debugfs_create_file("fw_boot_stats", 0644,
+		icp_hw_mgr.dentry, NULL, &cam_icp_boot_stats_fops);
+
 	if (IS_ERR(dbgfileptr)) {
 		if (PTR_ERR(dbgfileptr) == -ENODEV)
 			CAM_WARN(CAM_ICP, "DebugFS not enabled in kernel!");
@@ -1951,6 +2065,7 @@ static int cam_icp_mgr_process_cmd(void *priv, void *data)
 	int rc;
 	struct hfi_cmd_work_data *task_data = NULL;
 	struct cam_icp_hw_mgr *hw_mgr;
+	void *cmds[2];
 
 	if (!data || !priv) {
 		CAM_ERR(CAM_ICP, "Invalid params%pK %pK", data, priv);
@@ -1960,7 +2075,13 @@ static int cam_icp_mgr_process_cmd(void *priv, void *data)
 	hw_mgr = priv;
 	task_data = (struct hfi_cmd_work_data *)data;
 
-	rc = hfi_write_cmd(task_data->data);
+	if (task_data->pre_data) {
+		cmds[0] = task_data->pre_data;
+		cmds[1] = task_data->data;
+		rc = hfi_write_cmd_batch(cmds, ARRAY_SIZE(cmds));
+	} else {
+		rc = hfi_write_cmd(task_data->data);
+	}
 
 	return rc;
 }
@@ -2068,11 +2189,67 @@ static const char *cam_icp_error_handle_id_to_type(
 	return name;
 }
 
+static inline uint64_t cam_icp_mgr_frame_cookie(uint64_t request_id,
+	int32_t idx)
+{
+	if (request_id & ~ICP_FRAME_REQ_ID_MASK)
+		return request_id;
+
+	return request_id | ((uint64_t)(idx + 1) << ICP_FRAME_SLOT_SHIFT);
+}
+
+static int32_t cam_icp_mgr_find_frame_slot(
+	struct cam_icp_hw_ctx_data *ctx_data, uint64_t cookie,
+	uint64_t *request_id)
+{
+	struct hfi_frame_process_info *hfi_frame_process;
+	uint32_t slot = cookie >> ICP_FRAME_SLOT_SHIFT;
+	int32_t i;
+
+	hfi_frame_process = &ctx_data->hfi_frame_process;
+	if (slot && slot <= CAM_FRAME_CMD_MAX &&
+		hfi_frame_process->request_id[slot - 1] == *request_id)
+		return slot - 1;
+
+	/*
+	 * Request ids too wide for the cookie are sent as is and may look
+	 * like a slot, anything the slot does not match falls back to a scan.
+	 */
+	ctx_data->ack_stats.num_scans++;
+	for (i = 0; i < CAM_FRAME_CMD_MAX; i++) {
+		if (hfi_frame_process->request_id[i] == cookie) {
+			*request_id = cookie;
+			return i;
+		}
+		if (slot && hfi_frame_process->request_id[i] == *request_id)
+			return i;
+	}
+
+	if (slot)
+		ctx_data->ack_stats.num_stale++;
+
+	return -1;
+}
+
+static void cam_icp_mgr_update_ack_stats(
+	struct cam_icp_hw_ctx_data *ctx_data)
+{
+	struct cam_icp_ack_stats *stats = &ctx_data->ack_stats;
+	uint64_t lat_us;
+
+	lat_us = ktime_us_delta(ktime_get(), icp_hw_mgr.msg_irq_ts);
+	stats->num_acks++;
+	stats->total_us += lat_us;
+	if (lat_us > stats->max_us)
+		stats->max_us = lat_us;
+	stats->latency[min_t(int, fls64(lat_us >> 6),
+		ICP_ACK_LATENCY_BUCKETS - 1)]++;
+}
+
 static int cam_icp_mgr_handle_frame_process(uint32_t *msg_ptr, int flag)
 {
-	int i;
-	uint32_t idx;
-	uint64_t request_id;
+	int32_t idx;
+	uint64_t request_id, cookie;
 	struct cam_icp_hw_ctx_data *ctx_data = NULL;
 	struct hfi_msg_ipebps_async_ack *ioconfig_ack = NULL;
 	struct hfi_frame_process_info *hfi_frame_process;
@@ -2081,7 +2258,9 @@ static int cam_icp_mgr_handle_frame_process(uint32_t *msg_ptr, int flag)
 	uint32_t event_id;
 
 	ioconfig_ack = (struct hfi_msg_ipebps_async_ack *)msg_ptr;
-	request_id = ioconfig_ack->user_data2;
+	cookie = ioconfig_ack->user_data2;
+	request_id = (cookie >> ICP_FRAME_SLOT_SHIFT) ?
+		(cookie & ICP_FRAME_REQ_ID_MASK) : cookie;
 	ctx_data = (struct cam_icp_hw_ctx_data *)
 		U64_TO_PTR(ioconfig_ack->user_data1);
 	if (!ctx_data) {
@@ -2108,17 +2287,13 @@ static int cam_icp_mgr_handle_frame_process(uint32_t *msg_ptr, int flag)
 	cam_icp_device_timer_reset(&icp_hw_mgr, clk_type);
 
 	hfi_frame_process = &ctx_data->hfi_frame_process;
-	for (i = 0; i < CAM_FRAME_CMD_MAX; i++)
-		if (hfi_frame_process->request_id[i] == request_id)
-			break;
-
-	if (i >= CAM_FRAME_CMD_MAX) {
+	idx = cam_icp_mgr_find_frame_slot(ctx_data, cookie, &request_id);
+	if (idx < 0) {
 		CAM_ERR(CAM_ICP, "pkt not found in ctx data for req_id =%lld",
 			request_id);
 		mutex_unlock(&ctx_data->ctx_mutex);
 		return -EINVAL;
 	}
-	idx = i;
 
 	if (flag == ICP_FRAME_PROCESS_FAILURE) {
 		buf_data.evt_param = CAM_SYNC_ICP_EVENT_FRAME_PROCESS_FAILURE;
@@ -2154,6 +2329,7 @@ static int cam_icp_mgr_handle_frame_process(uint32_t *msg_ptr, int flag)
 	}
 	clear_bit(idx, ctx_data->hfi_frame_process.bitmap);
 	hfi_frame_process->fw_process_flag[idx] = false;
+	cam_icp_mgr_update_ack_stats(ctx_data);
 	mutex_unlock(&ctx_data->ctx_mutex);
 
 	return 0;
@@ -2608,10 +2784,38 @@ static int cam_icp_process_msg_pkt_type(
 	return rc;
 }
 
+static int cam_icp_mgr_process_msg_buf(struct cam_icp_hw_mgr *hw_mgr,
+	uint32_t read_len)
+{
+	uint32_t msg_processed_len = 0;
+	uint32_t *msg_ptr = (uint32_t *)icp_hw_mgr.msg_buf;
+
+	read_len = read_len << BYTE_WORD_SHIFT;
+	while (true) {
+		cam_icp_process_msg_pkt_type(hw_mgr, msg_ptr,
+			&msg_processed_len);
+
+		if (!msg_processed_len) {
+			CAM_ERR(CAM_ICP, "Failed to read");
+			return -EINVAL;
+		}
+
+		read_len -= msg_processed_len;
+		if (read_len > 0) {
+			msg_ptr += (msg_processed_len >>
+			BYTE_WORD_SHIFT);
+			msg_processed_len = 0;
+		} else {
+			break;
+		}
+	}
+
+	return 0;
+}
+
 static int32_t cam_icp_mgr_process_msg(void *priv, void *data)
 {
-	uint32_t read_len, msg_processed_len;
-	uint32_t *msg_ptr = NULL;
+	uint32_t read_len, num_reads;
 	struct hfi_msg_work_data *task_data;
 	struct cam_icp_hw_mgr *hw_mgr;
 	int rc = 0;
@@ -2623,32 +2827,26 @@ static int32_t cam_icp_mgr_process_msg(void *priv, void *data)
 
 	task_data = data;
 	hw_mgr = priv;
+	hw_mgr->msg_irq_ts = task_data->irq_ts;
 
-	rc = hfi_read_message(icp_hw_mgr.msg_buf, Q_MSG, &read_len);
-	if (rc) {
-		CAM_DBG(CAM_ICP, "Unable to read msg q rc %d", rc);
-	} else {
-		read_len = read_len << BYTE_WORD_SHIFT;
-		msg_ptr = (uint32_t *)icp_hw_mgr.msg_buf;
-		while (true) {
-			cam_icp_process_msg_pkt_type(hw_mgr, msg_ptr,
-				&msg_processed_len);
-
-			if (!msg_processed_len) {
-				CAM_ERR(CAM_ICP, "Failed to read");
-				rc = -EINVAL;
-				break;
-			}
-
-			read_len -= msg_processed_len;
-			if (read_len > 0) {
-				msg_ptr += (msg_processed_len >>
-				BYTE_WORD_SHIFT);
-				msg_processed_len = 0;
-			} else {
-				break;
-			}
+	/*
+	 * Firmware may post more messages while the previous read is being
+	 * processed, drain them here instead of waiting for another irq.
+	 */
+	for (num_reads = 0; num_reads < ICP_MSG_Q_DRAIN_MAX; num_reads++) {
+		rc = hfi_read_message(icp_hw_mgr.msg_buf, Q_MSG, &read_len);
+		if (rc) {
+			if (!num_reads)
+				CAM_DBG(CAM_ICP, "Unable to read msg q rc %d",
+					rc);
+			else
+				rc = 0;
+			break;
 		}
+
+		rc = cam_icp_mgr_process_msg_buf(hw_mgr, read_len);
+		if (rc)
+			break;
 	}
 
 	cam_icp_mgr_process_dbg_buf(icp_hw_mgr.icp_dbg_lvl);
@@ -2687,6 +2885,7 @@ int32_t cam_icp_hw_mgr_cb(uint32_t irq_status, void *data)
 	task_data = (struct hfi_msg_work_data *)task->payload;
 	task_data->data = hw_mgr;
 	task_data->irq_status = irq_status;
+	task_data->irq_ts = ktime_get();
 	task_data->type = ICP_WORKQ_TASK_MSG_TYPE;
 	task->process_cb = cam_icp_mgr_process_msg;
 	rc = cam_req_mgr_workq_enqueue_task(task, &icp_hw_mgr,
@@ -3585,7 +3784,11 @@ static int cam_icp_mgr_fw_download(struct cam_icp_hw_mgr *hw_mgr)
 	struct cam_hw_intf *icp_dev_intf = NULL;
 	struct cam_icp_set_irq_cb irq_cb;
 	struct cam_icp_a5_set_fw_buf_info fw_buf_info;
+	struct cam_icp_a5_fw_download_args download_args = {0};
+	struct cam_icp_fw_boot_stats *stats = &hw_mgr->boot_stats;
+	ktime_t start, resume_start;
 
+	start = ktime_get();
 	icp_dev_intf = hw_mgr->icp_dev_intf;
 	if (!icp_dev_intf) {
 		CAM_ERR(CAM_ICP, "ICP device interface is invalid");
@@ -3612,14 +3815,40 @@ static int cam_icp_mgr_fw_download(struct cam_icp_hw_mgr *hw_mgr)
 	if (rc)
 		return rc;
 
+	download_args.cache_fw = hw_mgr->icp_fw_cache;
 	rc = icp_dev_intf->hw_ops.process_cmd(
 		icp_dev_intf->hw_priv,
 		CAM_ICP_CMD_FW_DOWNLOAD,
-		NULL, 0);
+		&download_args, sizeof(download_args));
+	if (rc)
+		return rc;
+
+	resume_start = ktime_get();
+	rc = cam_icp_mgr_proc_resume(hw_mgr);
 	if (rc)
 		return rc;
 
-	return cam_icp_mgr_proc_resume(hw_mgr);
+	stats->num_boots++;
+	if (download_args.cache_hit)
+		stats->num_cache_hits++;
+	stats->segs_copied = download_args.segs_copied;
+	stats->segs_skipped = download_args.segs_skipped;
+	stats->load_us = download_args.load_us;
+	stats->parse_us = download_args.parse_us;
+	stats->copy_us = download_args.copy_us;
+	stats->resume_us = ktime_us_delta(ktime_get(), resume_start);
+	stats->total_us = ktime_us_delta(ktime_get(), start);
+	if (stats->total_us > stats->max_total_us)
+		stats->max_total_us = stats->total_us;
+
+	CAM_DBG(CAM_ICP,
+		"fw download %lluus: load %llu parse %llu copy %llu resume %llu segs %u/%u cache %d",
+		stats->total_us, stats->load_us, stats->parse_us,
+		stats->copy_us, stats->resume_us, stats->segs_copied,
+		stats->segs_copied + stats->segs_skipped,
+		download_args.cache_hit);
+
+	return 0;
 }
 
 static int cam_icp_mgr_hfi_init(struct cam_icp_hw_mgr *hw_mgr)
@@ -3898,7 +4127,8 @@ static int cam_icp_mgr_handle_config_err(
 }
 
 static int cam_icp_mgr_enqueue_config(struct cam_icp_hw_mgr *hw_mgr,
-	struct cam_hw_config_args *config_args)
+	struct cam_hw_config_args *config_args,
+	struct hfi_cmd_ipebps_async *ioconfig_cmd)
 {
 	int rc = 0;
 	uint64_t request_id = 0;
@@ -3921,6 +4151,7 @@ static int cam_icp_mgr_enqueue_config(struct cam_icp_hw_mgr *hw_mgr,
 
 	task_data = (struct hfi_cmd_work_data *)task->payload;
 	task_data->data = (void *)hw_update_entries->addr;
+	task_data->pre_data = ioconfig_cmd;
 	hfi_cmd = (struct hfi_cmd_ipebps_async *)hw_update_entries->addr;
 	task_data->request_id = request_id;
 	task_data->type = ICP_WORKQ_TASK_CMD_TYPE;
@@ -3968,6 +4199,7 @@ static int cam_icp_mgr_send_config_io(struct cam_icp_hw_ctx_data *ctx_data,
 	ioconfig_cmd.user_data2 = (uint64_t)0x0;
 	task_data = (struct hfi_cmd_work_data *)task->payload;
 	task_data->data = (void *)&ioconfig_cmd;
+	task_data->pre_data = NULL;
 	task_data->request_id = 0;
 	task_data->type = ICP_WORKQ_TASK_MSG_TYPE;
 	task->process_cb = cam_icp_mgr_process_cmd;
@@ -4002,30 +4234,6 @@ static int cam_icp_mgr_send_config_io(struct cam_icp_hw_ctx_data *ctx_data,
 	return rc;
 }
 
-static int cam_icp_mgr_send_recfg_io(struct cam_icp_hw_ctx_data *ctx_data,
-	struct hfi_cmd_ipebps_async *ioconfig_cmd, uint64_t req_id)
-{
-	int rc = 0;
-	struct hfi_cmd_work_data *task_data;
-	struct crm_workq_task *task;
-
-	task = cam_req_mgr_workq_get_task(icp_hw_mgr.cmd_work);
-	if (!task)
-		return -ENOMEM;
-
-	task_data = (struct hfi_cmd_work_data *)task->payload;
-	task_data->data = (void *)ioconfig_cmd;
-	task_data->request_id = req_id;
-	task_data->type = ICP_WORKQ_TASK_CMD_TYPE;
-	task->process_cb = cam_icp_mgr_process_cmd;
-	rc = cam_req_mgr_workq_enqueue_task(task, &icp_hw_mgr,
-		CRM_TASK_PRIORITY_0);
-	if (rc)
-		return rc;
-
-	return rc;
-}
-
 static int cam_icp_mgr_config_hw(void *hw_mgr_priv, void *config_hw_args)
 {
 	int rc = 0;
@@ -4069,20 +4277,17 @@ static int cam_icp_mgr_config_hw(void *hw_mgr_priv, void *config_hw_args)
 	CAM_DBG(CAM_ICP, "req_id %llu, io config %llu", req_id,
 		frame_info->io_config);
 
-	if (frame_info->io_config != 0) {
-		CAM_INFO(CAM_ICP, "Send recfg io");
-		rc = cam_icp_mgr_send_recfg_io(ctx_data,
-			&frame_info->hfi_cfg_io_cmd, req_id);
-		if (rc)
-			CAM_ERR(CAM_ICP, "Fail to send reconfig io cmd");
-	}
-
 	if (req_id <= ctx_data->last_flush_req)
 		CAM_WARN(CAM_ICP,
 			"Anomaly submitting flushed req %llu [last_flush %llu] in ctx %u",
 			req_id, ctx_data->last_flush_req, ctx_data->ctx_id);
 
-	rc = cam_icp_mgr_enqueue_config(hw_mgr, config_args);
+	/* A reconfig io goes out with the frame under one doorbell */
+	if (frame_info->io_config != 0)
+		CAM_INFO(CAM_ICP, "Send recfg io");
+
+	rc = cam_icp_mgr_enqueue_config(hw_mgr, config_args,
+		frame_info->io_config ? &frame_info->hfi_cfg_io_cmd : NULL);
 	if (rc)
 		goto config_err;
 	CAM_DBG(CAM_REQ,
@@ -4103,7 +4308,7 @@ config_err:
 static int cam_icp_mgr_prepare_frame_process_cmd(
 	struct cam_icp_hw_ctx_data *ctx_data,
 	struct hfi_cmd_ipebps_async *hfi_cmd,
-	uint64_t request_id,
+	uint64_t request_id, int32_t idx,
 	uint32_t fw_cmd_buf_iova_addr)
 {
 	hfi_cmd->size = sizeof(struct hfi_cmd_ipebps_async);
@@ -4116,7 +4321,7 @@ static int cam_icp_mgr_prepare_frame_process_cmd(
 	hfi_cmd->fw_handles[0] = ctx_data->fw_handle;
 	hfi_cmd->payload.indirect = fw_cmd_buf_iova_addr;
 	hfi_cmd->user_data1 = PTR_TO_U64(ctx_data);
-	hfi_cmd->user_data2 = request_id;
+	hfi_cmd->user_data2 = cam_icp_mgr_frame_cookie(request_id, idx);
 
 	CAM_DBG(CAM_ICP, "ctx_data : %pK, request_id :%lld cmd_buf %x",
 		(void *)ctx_data->context_priv, request_id,
@@ -4958,7 +5163,7 @@ static int cam_icp_mgr_prepare_hw_update(void *hw_mgr_priv,
 	hfi_cmd = (struct hfi_cmd_ipebps_async *)
 			&ctx_data->hfi_frame_process.hfi_frame_cmd[idx];
 	cam_icp_mgr_prepare_frame_process_cmd(
-		ctx_data, hfi_cmd, packet->header.request_id,
+		ctx_data, hfi_cmd, packet->header.request_id, idx,
 		fw_cmd_buf_iova_addr);
 
 	prepare_args->num_hw_update_entries = 1;
@@ -5445,6 +5650,7 @@ static int cam_icp_mgr_create_handle(uint32_t dev_type,
 	reinit_completion(&ctx_data->wait_complete);
 	task_data = (struct hfi_cmd_work_data *)task->payload;
 	task_data->data = (void *)&create_handle;
+	task_data->pre_data = NULL;
 	task_data->request_id = 0;
 	task_data->type = ICP_WORKQ_TASK_CMD_TYPE;
 	task->process_cb = cam_icp_mgr_process_cmd;
@@ -5491,6 +5697,7 @@ static int cam_icp_mgr_send_ping(struct cam_icp_hw_ctx_data *ctx_data)
 	init_completion(&ctx_data->wait_complete);
 	task_data = (struct hfi_cmd_work_data *)task->payload;
 	task_data->data = (void *)&ping_pkt;
+	task_data->pre_data = NULL;
 	task_data->request_id = 0;
 	task_data->type = ICP_WORKQ_TASK_CMD_TYPE;
 	task->process_cb = cam_icp_mgr_process_cmd;
@@ -25,6 +25,15 @@
 
 #define CAM_FRAME_CMD_MAX       40
 
+/*
+ * Frame process commands carry the frame slot (index + 1) in the top
+ * byte of user_data2 so the ack can be matched without a scan.
+ */
+#define ICP_FRAME_SLOT_SHIFT    56
+#define ICP_FRAME_REQ_ID_MASK   ((1ULL << ICP_FRAME_SLOT_SHIFT) - 1)
+
+#define ICP_ACK_LATENCY_BUCKETS 8
+
 #define CAM_MAX_OUT_RES         6
 #define CAM_MAX_IN_RES          8
 
@@ -103,11 +112,13 @@ struct icp_hfi_mem_info {
  * struct hfi_cmd_work_data
  * @type: Task type
  * @data: Pointer to command data
+ * @pre_data: Optional command written ahead of @data with one doorbell
  * @request_id: Request id
  */
 struct hfi_cmd_work_data {
 	uint32_t type;
 	void *data;
+	void *pre_data;
 	int32_t request_id;
 };
 
@@ -116,11 +127,13 @@ struct hfi_cmd_work_data {
  * @type: Task type
  * @data: Pointer to message data
  * @irq_status: IRQ status
+ * @irq_ts: Time the message interrupt was received
  */
 struct hfi_msg_work_data {
 	uint32_t type;
 	void *data;
 	uint32_t irq_status;
+	ktime_t irq_ts;
 };
 
 /**
@@ -221,6 +234,24 @@ struct cam_ctx_clk_info {
 	struct cam_axi_per_path_bw_vote axi_path[CAM_ICP_MAX_PER_PATH_VOTES];
 	bool bw_included;
 };
+/**
+ * struct cam_icp_ack_stats
+ * @num_acks: Frame process acks handled
+ * @num_scans: Acks that needed a linear search for the frame slot
+ * @num_stale: Acks whose frame slot was already released
+ * @total_us: Sum of irq to callback latency
+ * @max_us: Worst irq to callback latency
+ * @latency: Latency histogram, bucket n covers [64 << (n - 1), 64 << n) us
+ */
+struct cam_icp_ack_stats {
+	uint64_t num_acks;
+	uint64_t num_scans;
+	uint64_t num_stale;
+	uint64_t total_us;
+	uint64_t max_us;
+	uint64_t latency[ICP_ACK_LATENCY_BUCKETS];
+};
+
 /**
  * struct cam_icp_hw_ctx_data
  * @context_priv: Context private data
@@ -243,6 +274,7 @@ struct cam_ctx_clk_info {
  * @watch_dog_reset_counter: Counter for watch dog reset
  * @icp_dev_io_info: io config resource
  * @last_flush_req: last flush req for this ctx
+ * @ack_stats: Frame process ack statistics
  */
 struct cam_icp_hw_ctx_data {
 	void *context_priv;
@@ -265,6 +297,7 @@ struct cam_icp_hw_ctx_data {
 	uint32_t watch_dog_reset_counter;
 	struct cam_icp_acquire_dev_info icp_dev_io_info;
 	uint64_t last_flush_req;
+	struct cam_icp_ack_stats ack_stats;
 };
 
 /**
@@ -307,6 +340,32 @@ struct cam_icp_clk_info {
 	uint32_t watch_dog_reset_counter;
 };
 
+/**
+ * struct cam_icp_fw_boot_stats
+ * @num_boots: Firmware downloads performed
+ * @num_cache_hits: Downloads served from the resident image
+ * @segs_copied: Segments written by the last download
+ * @segs_skipped: Segments left intact by the last download
+ * @load_us: Last time spent requesting the firmware image
+ * @parse_us: Last time spent validating and parsing the elf
+ * @copy_us: Last time spent writing segments to the fw buffer
+ * @resume_us: Last time spent bringing the processor out of reset
+ * @total_us: Last total time in cam_icp_mgr_fw_download()
+ * @max_total_us: Worst total time in cam_icp_mgr_fw_download()
+ */
+struct cam_icp_fw_boot_stats {
+	uint64_t num_boots;
+	uint64_t num_cache_hits;
+	uint32_t segs_copied;
+	uint32_t segs_skipped;
+	uint64_t load_us;
+	uint64_t parse_us;
+	uint64_t copy_us;
+	uint64_t resume_us;
+	uint64_t total_us;
+	uint64_t max_total_us;
+};
+
 /**
  * struct cam_icp_hw_mgr
  * @hw_mgr_mutex: Mutex for ICP hardware manager
@@ -356,6 +415,9 @@ struct cam_icp_clk_info {
  * @recovery: Flag to validate if in previous session FW
  *            reported a fatal error or wdt. If set FW is
  *            re-downloaded for new camera session.
+ * @msg_irq_ts: Interrupt time of the message batch being processed
+ * @icp_fw_cache: Keep the parsed firmware image resident across boots
+ * @boot_stats: Firmware download timing
  */
 struct cam_icp_hw_mgr {
 	struct mutex hw_mgr_mutex;
@@ -403,6 +465,9 @@ struct cam_icp_hw_mgr {
 	bool bps_clk_state;
 	bool disable_ubwc_comp;
 	atomic_t recovery;
+	ktime_t msg_irq_ts;
+	bool icp_fw_cache;
+	struct cam_icp_fw_boot_stats boot_stats;
 };
 
 static int cam_icp_mgr_hw_close(void *hw_priv, void *hw_close_args);
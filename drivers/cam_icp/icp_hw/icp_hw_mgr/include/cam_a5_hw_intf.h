@@ -18,6 +18,26 @@ struct cam_icp_a5_set_fw_buf_info {
 	uint64_t len;
 };
 
+/**
+ * struct cam_icp_a5_fw_download_args - firmware download payload
+ * @cache_fw: Keep the parsed firmware image resident after download
+ * @cache_hit: Output, image came from the resident cache
+ * @load_us: Output, time spent requesting the firmware image
+ * @parse_us: Output, time spent validating and parsing the elf
+ * @copy_us: Output, time spent writing segments to the fw buffer
+ * @segs_copied: Output, segments written to the fw buffer
+ * @segs_skipped: Output, segments already intact in the fw buffer
+ */
+struct cam_icp_a5_fw_download_args {
+	bool cache_fw;
+	bool cache_hit;
+	uint64_t load_us;
+	uint64_t parse_us;
+	uint64_t copy_us;
+	uint32_t segs_copied;
+	uint32_t segs_skipped;
+};
+
 /**
  * struct cam_icp_a5_query_cap - ICP query device capability payload
  * @fw_version: firmware version info
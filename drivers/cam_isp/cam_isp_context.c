@@ -3747,6 +3747,25 @@ static int __cam_isp_ctx_flush_req(struct cam_context *ctx,
 	return 0;
 }
 
+static void __cam_isp_ctx_reset_wm_shadow(struct cam_context *ctx)
+{
+	int                               rc;
+	struct cam_isp_context           *ctx_isp;
+	struct cam_hw_cmd_args            hw_cmd_args;
+	struct cam_isp_hw_cmd_args        isp_hw_cmd_args;
+
+	/* Prepared requests which are dropped never reach the WMs */
+	ctx_isp = (struct cam_isp_context *) ctx->ctx_priv;
+	hw_cmd_args.ctxt_to_hw_map = ctx_isp->hw_ctx;
+	hw_cmd_args.cmd_type = CAM_HW_MGR_CMD_INTERNAL;
+	isp_hw_cmd_args.cmd_type = CAM_ISP_HW_MGR_CMD_RESET_WM_SHADOW;
+	hw_cmd_args.u.internal_args = (void *)&isp_hw_cmd_args;
+	rc = ctx->hw_mgr_intf->hw_cmd(ctx->hw_mgr_intf->hw_mgr_priv,
+		&hw_cmd_args);
+	if (rc)
+		CAM_ERR(CAM_ISP, "WM shadow reset failed rc: %d", rc);
+}
+
 static int __cam_isp_ctx_flush_req_in_top_state(
 	struct cam_context               *ctx,
 	struct cam_req_mgr_flush_request *flush_req)
@@ -3833,6 +3852,7 @@ static int __cam_isp_ctx_flush_req_in_top_state(
 	}
 
 end:
+	__cam_isp_ctx_reset_wm_shadow(ctx);
 	ctx_isp->bubble_frame_cnt = 0;
 	atomic_set(&ctx_isp->process_bubble, 0);
 	atomic_set(&ctx_isp->rxd_epoch, 0);
@@ -3854,6 +3874,7 @@ static int __cam_isp_ctx_flush_req_in_ready(
 		ctx->state = CAM_CTX_ACQUIRED;
 	spin_unlock_bh(&ctx->lock);
 
+	__cam_isp_ctx_reset_wm_shadow(ctx);
 	trace_cam_context_state("ISP", ctx);
 
 	CAM_DBG(CAM_ISP, "Flush request in ready state. next state %d",
@@ -4944,6 +4965,7 @@ put_ref:
 			CAM_ERR(CAM_CTXT, "Failed to put ref of fence %d",
 				req_isp->fence_map_out[i].sync_id);
 	}
+	__cam_isp_ctx_reset_wm_shadow(ctx);
 free_req:
 	spin_lock_bh(&ctx->lock);
 	list_add_tail(&req->list, &ctx->free_req_list);
@@ -8,6 +8,8 @@
 #include <linux/string.h>
 #include <linux/uaccess.h>
 #include <linux/debugfs.h>
+#include <linux/math64.h>
+#include <linux/crc32.h>
 
 #include <media/cam_isp.h>
 
@@ -4228,6 +4230,7 @@ static int cam_ife_mgr_stop_hw(void *hw_mgr_priv, void *stop_hw_args)
 
 	CAM_DBG(CAM_ISP, " Enter...ctx id:%d", ctx->ctx_index);
 	stop_isp = (struct cam_isp_stop_args    *)stop_args->args;
+	ctx->prepare_tmpl.valid = false;
 
 	/* Set the csid halt command */
 	if ((stop_isp->hw_stop_cmd == CAM_ISP_HW_STOP_AT_FRAME_BOUNDARY) ||
@@ -4848,6 +4851,7 @@ static int cam_ife_mgr_release_hw(void *hw_mgr_priv,
 	ctx->is_fe_enabled = false;
 	ctx->is_offline = false;
 	ctx->pf_mid_found = false;
+	ctx->prepare_tmpl.valid = false;
 	ctx->last_cdm_done_req = 0;
 	atomic_set(&ctx->overflow_pending, 0);
 	for (i = 0; i < CAM_IFE_HW_NUM_MAX; i++) {
@@ -6469,6 +6473,100 @@ static int cam_ife_mgr_util_insert_frame_header(
 	return rc;
 }
 
+static uint32_t cam_ife_mgr_packet_signature(struct cam_packet *packet)
+{
+	struct cam_buf_io_cfg *io_cfg;
+	uint32_t               key[4], sig, i;
+
+	key[0] = packet->header.op_code;
+	key[1] = packet->num_cmd_buf;
+	key[2] = packet->num_io_configs;
+	key[3] = packet->kmd_cmd_buf_index;
+	sig = crc32_le(~0, (uint8_t *)key, sizeof(key));
+
+	io_cfg = (struct cam_buf_io_cfg *)((uint8_t *)&packet->payload +
+		packet->io_configs_offset);
+	for (i = 0; i < packet->num_io_configs; i++) {
+		key[0] = io_cfg[i].resource_type;
+		key[1] = io_cfg[i].direction;
+		key[2] = io_cfg[i].format;
+		sig = crc32_le(sig, (uint8_t *)key, 3 * sizeof(uint32_t));
+	}
+
+	return sig;
+}
+
+static int cam_ife_mgr_tmpl_capture(struct cam_kmd_buf_info *kmd_buf,
+	uint32_t start_bytes, uint32_t *cmd_words, uint32_t *cmd_bytes)
+{
+	uint32_t len = kmd_buf->used_bytes - start_bytes;
+
+	if (len > sizeof(uint32_t) * CAM_IFE_PREPARE_TMPL_MAX_WORDS) {
+		CAM_DBG(CAM_ISP, "Command of %u bytes not cached", len);
+		return -ENOSPC;
+	}
+
+	memcpy(cmd_words, kmd_buf->cpu_addr + start_bytes/4, len);
+	*cmd_bytes = len;
+
+	return 0;
+}
+
+static void cam_ife_mgr_prepare_stage_end(uint64_t *stage_ns,
+	enum cam_ife_prepare_stage stage, ktime_t *ts)
+{
+	ktime_t now = ktime_get();
+
+	stage_ns[stage] += ktime_to_ns(ktime_sub(now, *ts));
+	*ts = now;
+}
+
+static void cam_ife_mgr_update_prepare_stats(uint64_t *stage_ns,
+	bool tmpl_hit)
+{
+	struct cam_ife_prepare_stats *stats = &g_ife_hw_mgr.prepare_stats;
+	int i;
+
+	spin_lock(&g_ife_hw_mgr.prepare_stats_lock);
+	stats->num_prepare++;
+	if (tmpl_hit)
+		stats->num_tmpl_hit++;
+
+	for (i = 0; i < CAM_IFE_PREPARE_STAGE_MAX; i++) {
+		stats->total_ns[i] += stage_ns[i];
+		if (stage_ns[i] > stats->max_ns[i])
+			stats->max_ns[i] = stage_ns[i];
+	}
+	spin_unlock(&g_ife_hw_mgr.prepare_stats_lock);
+}
+
+/*
+ * The WM shadows advance at prepare, a request dropped before it is
+ * applied leaves values behind the hardware never received.
+ */
+static void cam_ife_mgr_reset_wm_shadow(struct cam_ife_hw_mgr_ctx *ctx)
+{
+	struct cam_isp_hw_mgr_res     *hw_mgr_res;
+	struct cam_isp_resource_node  *res;
+	struct cam_hw_intf            *hw_intf;
+	uint32_t                       i, j;
+
+	for (i = 0; i < max_ife_out_res; i++) {
+		hw_mgr_res = &ctx->res_list_ife_out[i];
+		for (j = 0; j < CAM_ISP_HW_SPLIT_MAX; j++) {
+			res = hw_mgr_res->hw_res[j];
+			if (!res)
+				continue;
+
+			hw_intf = res->hw_intf;
+			if (hw_intf && hw_intf->hw_ops.process_cmd)
+				hw_intf->hw_ops.process_cmd(hw_intf->hw_priv,
+					CAM_ISP_HW_CMD_WM_SHADOW_RESET, res,
+					sizeof(struct cam_isp_resource_node));
+		}
+	}
+}
+
 static int cam_ife_mgr_prepare_hw_update(void *hw_mgr_priv,
 	void *prepare_hw_update_args)
 {
@@ -6485,18 +6583,28 @@ static int cam_ife_mgr_prepare_hw_update(void *hw_mgr_priv,
 	struct cam_isp_prepare_hw_update_data   *prepare_hw_data;
 	struct cam_isp_frame_header_info         frame_header_info;
 	struct cam_isp_change_base_args          change_base_info = {0};
+	struct cam_ife_prepare_tmpl             *tmpl;
+	struct cam_ife_prepare_tmpl_base        *tmpl_base;
+	uint32_t                                 signature, start_bytes;
+	bool                                     tmpl_hit = false;
+	bool                                     tmpl_ok = true;
+	uint64_t                                 stage_ns[
+						CAM_IFE_PREPARE_STAGE_MAX] = {0};
+	ktime_t                                  ts;
 
 	if (!hw_mgr_priv || !prepare_hw_update_args) {
 		CAM_ERR(CAM_ISP, "Invalid args");
 		return -EINVAL;
 	}
 
+	ts = ktime_get();
+
 	prepare_hw_data = (struct cam_isp_prepare_hw_update_data  *)
 		prepare->priv;
 
 	ctx = (struct cam_ife_hw_mgr_ctx *) prepare->ctxt_to_hw_map;
 	hw_mgr = (struct cam_ife_hw_mgr *)hw_mgr_priv;
-
+	tmpl = &ctx->prepare_tmpl;
 
 	CAM_DBG(CAM_REQ, "ctx[%pK][%d] Enter for req_id %lld",
 		ctx, ctx->ctx_index, prepare->packet->header.request_id);
@@ -6521,6 +6629,21 @@ static int cam_ife_mgr_prepare_hw_update(void *hw_mgr_priv,
 		prepare_hw_data->frame_header_res_id = 0x0;
 	}
 
+	/*
+	 * Packets are validated and patched every time since they come
+	 * from userspace, the template only replaces the commands that
+	 * depend on the acquired resources.
+	 */
+	signature = cam_ife_mgr_packet_signature(prepare->packet);
+	if (tmpl->valid && tmpl->signature == signature &&
+		!hw_mgr->debug_cfg.disable_prepare_tmpl)
+		tmpl_hit = true;
+	else
+		tmpl->valid = false;
+
+	cam_ife_mgr_prepare_stage_end(stage_ns,
+		CAM_IFE_PREPARE_STAGE_PARSE, &ts);
+
 	if (ctx->internal_cdm)
 		rc = cam_packet_util_process_patches(prepare->packet,
 			hw_mgr->mgr_common.img_iommu_hdl,
@@ -6535,6 +6658,9 @@ static int cam_ife_mgr_prepare_hw_update(void *hw_mgr_priv,
 		return rc;
 	}
 
+	cam_ife_mgr_prepare_stage_end(stage_ns,
+		CAM_IFE_PREPARE_STAGE_PATCH, &ts);
+
 	prepare->num_hw_update_entries = 0;
 	prepare->num_in_map_entries = 0;
 	prepare->num_out_map_entries = 0;
@@ -6554,13 +6680,24 @@ static int cam_ife_mgr_prepare_hw_update(void *hw_mgr_priv,
 			"change base i=%d, idx=%d, ctx->internal_cdm = %d",
 			i, ctx->base[i].idx, ctx->internal_cdm);
 
+		tmpl_base = &tmpl->base[i];
 		/* Add change base */
 		if (!ctx->internal_cdm) {
 			change_base_info.base_idx = ctx->base[i].idx;
 			change_base_info.cdm_id = ctx->cdm_id;
-			rc = cam_isp_add_change_base(prepare,
-				&ctx->res_list_ife_src,
-				&change_base_info, &kmd_buf);
+			start_bytes = kmd_buf.used_bytes;
+			if (tmpl_hit)
+				rc = cam_isp_add_cmd_words(prepare, &kmd_buf,
+					tmpl_base->change_base,
+					tmpl_base->change_base_bytes);
+			else
+				rc = cam_isp_add_change_base(prepare,
+					&ctx->res_list_ife_src,
+					&change_base_info, &kmd_buf);
+			if (!rc && !tmpl_hit && cam_ife_mgr_tmpl_capture(
+				&kmd_buf, start_bytes, tmpl_base->change_base,
+				&tmpl_base->change_base_bytes))
+				tmpl_ok = false;
 			if (rc) {
 				CAM_ERR(CAM_ISP,
 				"Failed in change base i=%d, idx=%d, rc=%d",
@@ -6582,6 +6719,9 @@ static int cam_ife_mgr_prepare_hw_update(void *hw_mgr_priv,
 			}
 		}
 
+		cam_ife_mgr_prepare_stage_end(stage_ns,
+			CAM_IFE_PREPARE_STAGE_CMD_BUF, &ts);
+
 		memset(&frame_header_info, 0,
 			sizeof(struct cam_isp_frame_header_info));
 		if (frame_header_enable) {
@@ -6607,6 +6747,9 @@ static int cam_ife_mgr_prepare_hw_update(void *hw_mgr_priv,
 			goto end;
 		}
 
+		cam_ife_mgr_prepare_stage_end(stage_ns,
+			CAM_IFE_PREPARE_STAGE_IO_BUF, &ts);
+
 		/* fence map table entries need to fill only once in the loop */
 		if (fill_fence)
 			fill_fence = false;
@@ -6680,11 +6823,17 @@ static int cam_ife_mgr_prepare_hw_update(void *hw_mgr_priv,
 	for (i = 0; i < ctx->num_base; i++) {
 		change_base_info.base_idx = ctx->base[i].idx;
 		change_base_info.cdm_id = ctx->cdm_id;
+		tmpl_base = &tmpl->base[i];
 		/* Add change base */
 		if (!ctx->internal_cdm) {
-			rc = cam_isp_add_change_base(prepare,
-				&ctx->res_list_ife_src,
-				&change_base_info, &kmd_buf);
+			if (tmpl_hit)
+				rc = cam_isp_add_cmd_words(prepare, &kmd_buf,
+					tmpl_base->change_base,
+					tmpl_base->change_base_bytes);
+			else
+				rc = cam_isp_add_change_base(prepare,
+					&ctx->res_list_ife_src,
+					&change_base_info, &kmd_buf);
 
 			if (rc) {
 				CAM_ERR(CAM_ISP,
@@ -6694,8 +6843,20 @@ static int cam_ife_mgr_prepare_hw_update(void *hw_mgr_priv,
 			}
 		}
 		/*Add reg update */
-		rc = cam_isp_add_reg_update(prepare, &ctx->res_list_ife_src,
-			ctx->base[i].idx, &kmd_buf);
+		if (tmpl_hit) {
+			rc = cam_isp_add_cmd_words(prepare, &kmd_buf,
+				tmpl_base->reg_update,
+				tmpl_base->reg_update_bytes);
+		} else {
+			start_bytes = kmd_buf.used_bytes;
+			rc = cam_isp_add_reg_update(prepare,
+				&ctx->res_list_ife_src,
+				ctx->base[i].idx, &kmd_buf);
+			if (!rc && cam_ife_mgr_tmpl_capture(&kmd_buf,
+				start_bytes, tmpl_base->reg_update,
+				&tmpl_base->reg_update_bytes))
+				tmpl_ok = false;
+		}
 
 		if (rc) {
 			CAM_ERR(CAM_ISP,
@@ -6716,7 +6877,20 @@ static int cam_ife_mgr_prepare_hw_update(void *hw_mgr_priv,
 				i, ctx->base[i].idx, rc);
 	}
 
+	cam_ife_mgr_prepare_stage_end(stage_ns,
+		CAM_IFE_PREPARE_STAGE_REG_UPDATE, &ts);
+
+	if (!rc && !tmpl_hit && tmpl_ok) {
+		tmpl->signature = signature;
+		tmpl->valid = true;
+	}
+
 end:
+	if (!rc)
+		cam_ife_mgr_update_prepare_stats(stage_ns, tmpl_hit);
+	else
+		cam_ife_mgr_reset_wm_shadow(ctx);
+
 	return rc;
 }
 
@@ -7090,6 +7264,9 @@ static int cam_ife_mgr_cmd(void *hw_mgr_priv, void *cmd_args)
 			isp_hw_cmd_args->u.last_cdm_done =
 				ctx->last_cdm_done_req;
 			break;
+		case CAM_ISP_HW_MGR_CMD_RESET_WM_SHADOW:
+			cam_ife_mgr_reset_wm_shadow(ctx);
+			break;
 		default:
 			CAM_ERR(CAM_ISP, "Invalid HW mgr command:0x%x",
 				hw_cmd_args->cmd_type);
@@ -8173,6 +8350,81 @@ DEFINE_SIMPLE_ATTRIBUTE(cam_ife_camif_debug,
 	cam_ife_get_camif_debug,
 	cam_ife_set_camif_debug, "%16llu");
 
+static ssize_t cam_ife_wm_update_stats_read(struct file *file,
+	char __user *ubuf, size_t size, loff_t *ppos)
+{
+	uint64_t num_updates, used_bytes, full_bytes;
+	char t_char[128];
+	int len;
+
+	cam_isp_get_wm_update_stats(&num_updates, &used_bytes, &full_bytes);
+
+	len = scnprintf(t_char, sizeof(t_char),
+		"updates %llu avg_full_bytes %llu avg_used_bytes %llu\n",
+		num_updates,
+		num_updates ? div64_u64(full_bytes, num_updates) : 0,
+		num_updates ? div64_u64(used_bytes, num_updates) : 0);
+
+	return simple_read_from_buffer(ubuf, size, ppos, t_char, len);
+}
+
+static ssize_t cam_ife_wm_update_stats_write(struct file *file,
+	const char __user *ubuf, size_t size, loff_t *ppos)
+{
+	cam_isp_reset_wm_update_stats();
+
+	return size;
+}
+
+static const struct file_operations cam_ife_wm_update_stats_fops = {
+	.open = simple_open,
+	.read = cam_ife_wm_update_stats_read,
+	.write = cam_ife_wm_update_stats_write,
+};
+
+static ssize_t cam_ife_prepare_stats_read(struct file *file,
+	char __user *ubuf, size_t size, loff_t *ppos)
+{
+	static const char * const stage_name[CAM_IFE_PREPARE_STAGE_MAX] = {
+		"parse", "patch", "cmd_buf", "io_buf", "reg_update",
+	};
+	struct cam_ife_prepare_stats stats;
+	char t_char[384];
+	int len, i;
+
+	spin_lock(&g_ife_hw_mgr.prepare_stats_lock);
+	stats = g_ife_hw_mgr.prepare_stats;
+	spin_unlock(&g_ife_hw_mgr.prepare_stats_lock);
+
+	len = scnprintf(t_char, sizeof(t_char), "prepare %llu tmpl_hit %llu\n",
+		stats.num_prepare, stats.num_tmpl_hit);
+	for (i = 0; i < CAM_IFE_PREPARE_STAGE_MAX; i++)
+		len += scnprintf(t_char + len, sizeof(t_char) - len,
+			"%s avg_ns %llu max_ns %llu\n", stage_name[i],
+			stats.num_prepare ?
+			div64_u64(stats.total_ns[i], stats.num_prepare) : 0,
+			stats.max_ns[i]);
+
+	return simple_read_from_buffer(ubuf, size, ppos, t_char, len);
+}
+
+static ssize_t cam_ife_prepare_stats_write(struct file *file,
+	const char __user *ubuf, size_t size, loff_t *ppos)
+{
+	spin_lock(&g_ife_hw_mgr.prepare_stats_lock);
+	memset(&g_ife_hw_mgr.prepare_stats, 0,
+		sizeof(g_ife_hw_mgr.prepare_stats));
+	spin_unlock(&g_ife_hw_mgr.prepare_stats_lock);
+
+	return size;
+}
+
+static const struct file_operations cam_ife_prepare_stats_fops = {
+	.open = simple_open,
+	.read = cam_ife_prepare_stats_read,
+	.write = cam_ife_prepare_stats_write,
+};
+
 static int cam_ife_hw_mgr_debug_register(void)
 {
 	int rc = 0;
@@ -8206,6 +8458,15 @@ static int cam_ife_hw_mgr_debug_register(void)
 	dbgfileptr = debugfs_create_bool("disable_ubwc_comp", 0644,
 		g_ife_hw_mgr.debug_cfg.dentry,
 		&g_ife_hw_mgr.debug_cfg.disable_ubwc_comp);
+	dbgfileptr = debugfs_create_file("wm_update_stats", 0644,
+		g_ife_hw_mgr.debug_cfg.dentry, NULL,
+		&cam_ife_wm_update_stats_fops);
+	dbgfileptr = debugfs_create_bool("disable_prepare_tmpl", 0644,
+		g_ife_hw_mgr.debug_cfg.dentry,
+		&g_ife_hw_mgr.debug_cfg.disable_prepare_tmpl);
+	dbgfileptr = debugfs_create_file("prepare_stats", 0644,
+		g_ife_hw_mgr.debug_cfg.dentry, NULL,
+		&cam_ife_prepare_stats_fops);
 
 	if (IS_ERR(dbgfileptr)) {
 		if (PTR_ERR(dbgfileptr) == -ENODEV)
@@ -8236,6 +8497,7 @@ int cam_ife_hw_mgr_init(struct cam_hw_mgr_intf *hw_mgr_intf, int *iommu_hdl)
 
 	mutex_init(&g_ife_hw_mgr.ctx_mutex);
 	spin_lock_init(&g_ife_hw_mgr.ctx_lock);
+	spin_lock_init(&g_ife_hw_mgr.prepare_stats_lock);
 
 	if (CAM_IFE_HW_NUM_MAX != CAM_IFE_CSID_HW_NUM_MAX) {
 		CAM_ERR(CAM_ISP, "CSID num is different then IFE num");
@@ -23,6 +23,23 @@
 #define CAM_IFE_CUSTOM_CFG_FRAME_HEADER_TS   BIT(0)
 #define CAM_IFE_CUSTOM_CFG_SW_SYNC_ON        BIT(1)
 
+/* Max command words cached per base in the prepare template */
+#define CAM_IFE_PREPARE_TMPL_MAX_WORDS       16
+
+/*
+ * Stages of request prepare timed for the prepare stats. The parse stage
+ * covers packet validation, kmd buffer lookup, frame header setup and the
+ * template signature.
+ */
+enum cam_ife_prepare_stage {
+	CAM_IFE_PREPARE_STAGE_PARSE,
+	CAM_IFE_PREPARE_STAGE_PATCH,
+	CAM_IFE_PREPARE_STAGE_CMD_BUF,
+	CAM_IFE_PREPARE_STAGE_IO_BUF,
+	CAM_IFE_PREPARE_STAGE_REG_UPDATE,
+	CAM_IFE_PREPARE_STAGE_MAX,
+};
+
 /**
  * struct cam_ife_hw_mgr_debug - contain the debug information
  *
@@ -34,6 +51,7 @@
  * @enable_req_dump:           Enable request dump on HW errors
  * @per_req_reg_dump:          Enable per request reg dump
  * @disable_ubwc_comp:         Disable UBWC compression
+ * @disable_prepare_tmpl:      Build every request without prepare template
  *
  */
 struct cam_ife_hw_mgr_debug {
@@ -45,6 +63,58 @@ struct cam_ife_hw_mgr_debug {
 	bool           enable_req_dump;
 	bool           per_req_reg_dump;
 	bool           disable_ubwc_comp;
+	bool           disable_prepare_tmpl;
+};
+
+/**
+ * struct cam_ife_prepare_tmpl_base - Cached command words of one base
+ *
+ * @change_base_bytes:      Size of the change base command, 0 if none
+ * @reg_update_bytes:       Size of the reg update commands
+ * @change_base:            Change base command words
+ * @reg_update:             Reg update command words
+ */
+struct cam_ife_prepare_tmpl_base {
+	uint32_t                        change_base_bytes;
+	uint32_t                        reg_update_bytes;
+	uint32_t                        change_base[
+						CAM_IFE_PREPARE_TMPL_MAX_WORDS];
+	uint32_t                        reg_update[
+						CAM_IFE_PREPARE_TMPL_MAX_WORDS];
+};
+
+/**
+ * struct cam_ife_prepare_tmpl - Prepare template of a context
+ *
+ * The change base and reg update commands of a base only depend on the
+ * acquired resources, they are built once by the hw layer and replayed
+ * for later requests with the same packet layout. Validation, patching,
+ * the IQ command buffers and the io buffers are still processed for
+ * every request.
+ *
+ * @valid:                  Template holds the commands for @signature
+ * @signature:              Layout signature of the packet it was built on
+ * @base:                   Cached commands per base
+ */
+struct cam_ife_prepare_tmpl {
+	bool                            valid;
+	uint32_t                        signature;
+	struct cam_ife_prepare_tmpl_base base[CAM_IFE_HW_NUM_MAX];
+};
+
+/**
+ * struct cam_ife_prepare_stats - Request prepare timing
+ *
+ * @num_prepare:            Number of prepared requests
+ * @num_tmpl_hit:           Requests prepared from the template
+ * @total_ns:               Time spent per stage
+ * @max_ns:                 Longest time spent per stage
+ */
+struct cam_ife_prepare_stats {
+	uint64_t                        num_prepare;
+	uint64_t                        num_tmpl_hit;
+	uint64_t                        total_ns[CAM_IFE_PREPARE_STAGE_MAX];
+	uint64_t                        max_ns[CAM_IFE_PREPARE_STAGE_MAX];
 };
 
 /**
@@ -103,6 +173,7 @@ struct cam_ife_hw_mgr_debug {
  * @hw_enabled              Array to indicate active HW
  * @internal_cdm            Indicate whether context uses internal CDM
  * @pf_mid_found            in page fault, mid found for this ctx.
+ * @prepare_tmpl            Cached change base and reg update commands
  */
 struct cam_ife_hw_mgr_ctx {
 	struct list_head                list;
@@ -158,6 +229,7 @@ struct cam_ife_hw_mgr_ctx {
 	bool                            dsp_enabled;
 	bool                            internal_cdm;
 	bool                            pf_mid_found;
+	struct cam_ife_prepare_tmpl     prepare_tmpl;
 };
 
 /**
@@ -180,6 +252,8 @@ struct cam_ife_hw_mgr_ctx {
  * @support_consumed_addr  indicate whether hw supports last consumed address
  * @hw_pid_support         hw pid support for this target
  * @max_vfe_out_res_type   max ife out res type value from hw
+ * @prepare_stats          request prepare timing
+ * @prepare_stats_lock     lock for the prepare stats
  */
 struct cam_ife_hw_mgr {
 	struct cam_isp_hw_mgr          mgr_common;
@@ -203,6 +277,8 @@ struct cam_ife_hw_mgr {
 	bool                           support_consumed_addr;
 	bool                           hw_pid_support;
 	uint32_t                       max_vfe_out_res_type;
+	struct cam_ife_prepare_stats   prepare_stats;
+	spinlock_t                     prepare_stats_lock;
 };
 
 /**
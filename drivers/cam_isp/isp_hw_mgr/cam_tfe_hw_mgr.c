@@ -4982,6 +4982,9 @@ static int cam_tfe_mgr_cmd(void *hw_mgr_priv, void *cmd_args)
 		case CAM_ISP_HW_MGR_CMD_UPDATE_CLOCK:
 			rc = cam_tfe_cshiphy_callback(ctx, isp_hw_cmd_args->cmd_data);
 			break;
+		case CAM_ISP_HW_MGR_CMD_RESET_WM_SHADOW:
+			/* TFE bus programs every WM register per request */
+			break;
 		default:
 			CAM_ERR(CAM_ISP, "Invalid HW mgr command:0x%x",
 				hw_cmd_args->cmd_type);
@@ -4,6 +4,7 @@
  * Copyright (c) 2023 Qualcomm Innovation Center, Inc. All rights reserved.
  */
 
+#include <linux/atomic.h>
 #include <media/cam_defs.h>
 #include <media/cam_isp.h>
 #include "cam_mem_mgr.h"
@@ -13,6 +14,28 @@
 #include "cam_debug_util.h"
 #include "cam_isp_hw_mgr_intf.h"
 
+static struct {
+	atomic64_t num_updates;
+	atomic64_t used_bytes;
+	atomic64_t skipped_bytes;
+} cam_isp_wm_update_stats;
+
+void cam_isp_get_wm_update_stats(uint64_t *num_updates,
+	uint64_t *used_bytes, uint64_t *full_bytes)
+{
+	*num_updates = atomic64_read(&cam_isp_wm_update_stats.num_updates);
+	*used_bytes = atomic64_read(&cam_isp_wm_update_stats.used_bytes);
+	*full_bytes = *used_bytes +
+		atomic64_read(&cam_isp_wm_update_stats.skipped_bytes);
+}
+
+void cam_isp_reset_wm_update_stats(void)
+{
+	atomic64_set(&cam_isp_wm_update_stats.num_updates, 0);
+	atomic64_set(&cam_isp_wm_update_stats.used_bytes, 0);
+	atomic64_set(&cam_isp_wm_update_stats.skipped_bytes, 0);
+}
+
 int cam_isp_add_change_base(
 	struct cam_hw_prepare_update_args      *prepare,
 	struct list_head                       *res_list_isp_src,
@@ -89,6 +112,51 @@ int cam_isp_add_change_base(
 	return rc;
 }
 
+int cam_isp_add_cmd_words(
+	struct cam_hw_prepare_update_args      *prepare,
+	struct cam_kmd_buf_info                *kmd_buf_info,
+	uint32_t                               *cmd_words,
+	uint32_t                                cmd_bytes)
+{
+	struct cam_hw_update_entry      *hw_entry;
+	uint32_t                         num_ent;
+
+	/* Like the builders, an empty command adds no hw entry */
+	if (!cmd_bytes)
+		return 0;
+
+	num_ent = prepare->num_hw_update_entries;
+	if (num_ent + 1 >= prepare->max_hw_update_entries) {
+		CAM_ERR(CAM_ISP, "Insufficient  HW entries :%d %d",
+			num_ent, prepare->max_hw_update_entries);
+		return -EINVAL;
+	}
+
+	if (kmd_buf_info->used_bytes + cmd_bytes > kmd_buf_info->size) {
+		CAM_ERR(CAM_ISP, "no free mem %d %d %d",
+			kmd_buf_info->size, kmd_buf_info->used_bytes,
+			cmd_bytes);
+		return -ENOMEM;
+	}
+
+	memcpy(kmd_buf_info->cpu_addr + kmd_buf_info->used_bytes/4,
+		cmd_words, cmd_bytes);
+
+	hw_entry = &prepare->hw_update_entries[num_ent];
+	hw_entry->handle = kmd_buf_info->handle;
+	hw_entry->len    = cmd_bytes;
+	hw_entry->offset = kmd_buf_info->offset;
+	hw_entry->flags  = CAM_ISP_IOCFG_BL;
+	CAM_DBG(CAM_ISP, "num_ent=%d handle=0x%x, len=%u, offset=%u",
+		num_ent, hw_entry->handle, hw_entry->len, hw_entry->offset);
+
+	kmd_buf_info->used_bytes += cmd_bytes;
+	kmd_buf_info->offset     += cmd_bytes;
+	prepare->num_hw_update_entries = num_ent + 1;
+
+	return 0;
+}
+
 static int cam_isp_update_dual_config(
 	struct cam_cmd_buf_desc            *cmd_desc,
 	uint32_t                            split_id,
@@ -726,6 +794,7 @@ int cam_isp_add_io_buffers(
 
 			update_buf.cmd.size = kmd_buf_remain_size;
 			update_buf.wm_update = &wm_update;
+			wm_update.skipped_regs = 0;
 
 			CAM_DBG(CAM_ISP, "cmd buffer 0x%pK, size %d",
 				update_buf.cmd.cmd_buf_addr,
@@ -752,6 +821,12 @@ int cam_isp_add_io_buffers(
 			}
 
 			io_cfg_used_bytes += update_buf.cmd.used_bytes;
+			atomic64_inc(&cam_isp_wm_update_stats.num_updates);
+			atomic64_add(update_buf.cmd.used_bytes,
+				&cam_isp_wm_update_stats.used_bytes);
+			/* Each skipped register is one reg/value pair */
+			atomic64_add(wm_update.skipped_regs * 2 * sizeof(uint32_t),
+				&cam_isp_wm_update_stats.skipped_bytes);
 
 			if (!out_map_entries) {
 				CAM_ERR(CAM_ISP, "out_map_entries is NULL");
@@ -249,4 +249,44 @@ int cam_isp_add_go_cmd(
 	uint32_t                              base_idx,
 	struct cam_kmd_buf_info              *kmd_buf_info);
 
+/*
+ * cam_isp_add_cmd_words()
+ *
+ * @brief                  Copy prebuilt CDM commands into the kmd buffer
+ *                         and add them as one hw entry, nothing is added
+ *                         for empty commands
+ *
+ * @prepare:               Contain the  packet and HW update variables
+ * @kmd_buf_info:          Kmd buffer to store the commands
+ * @cmd_words:             Commands previously built by the ISP HW
+ * @cmd_bytes:             Size of the commands
+ *
+ * @return:                0 for success
+ *                         -EINVAL/-ENOMEM for Fail
+ */
+int cam_isp_add_cmd_words(
+	struct cam_hw_prepare_update_args      *prepare,
+	struct cam_kmd_buf_info                *kmd_buf_info,
+	uint32_t                               *cmd_words,
+	uint32_t                                cmd_bytes);
+
+/*
+ * cam_isp_get_wm_update_stats()
+ *
+ * @brief                  Read the WM buffer update payload counters
+ *
+ * @num_updates:           Number of WM buffer updates prepared
+ * @used_bytes:            CDM payload bytes written for them
+ * @full_bytes:            CDM payload bytes without WM shadowing
+ */
+void cam_isp_get_wm_update_stats(uint64_t *num_updates,
+	uint64_t *used_bytes, uint64_t *full_bytes);
+
+/*
+ * cam_isp_reset_wm_update_stats()
+ *
+ * @brief                  Clear the WM buffer update payload counters
+ */
+void cam_isp_reset_wm_update_stats(void);
+
 #endif /*_CAM_ISP_HW_PARSER_H */
@@ -11,6 +11,25 @@
 #include "cam_io_util.h"
 #include "cam_irq_controller.h"
 #include "cam_debug_util.h"
+#include "cam_trace.h"
+
+/* Number of status bits in one IRQ register */
+#define CAM_IRQ_BITS_PER_REG 32
+
+struct cam_irq_evt_handler;
+
+/**
+ * struct cam_irq_bit_node:
+ * @Brief:                  Links an event handler into the subscriber list
+ *                          of one status bit
+ *
+ * @list:                   list_head in the per bit subscriber list
+ * @evt_handler:            Event handler subscribed to the bit
+ */
+struct cam_irq_bit_node {
+	struct list_head                   list;
+	struct cam_irq_evt_handler        *evt_handler;
+};
 
 /**
  * struct cam_irq_evt_handler:
@@ -28,7 +47,11 @@
  * @bottom_half_enqueue_func:
  *                          Function used to enqueue the bottom_half event
  * @list_node:              list_head struct used for overall handler List
- * @th_list_node:           list_head struct used for top half handler List
+ * @bit_nodes:              One node per subscribed bit, linking this handler
+ *                          into the per bit subscriber lists
+ * @num_bit_nodes:          Number of entries in bit_nodes
+ * @th_seq:                 Top half pass in which this handler last ran,
+ *                          used to run it once per pass
  */
 struct cam_irq_evt_handler {
 	enum cam_irq_priority_level        priority;
@@ -39,7 +62,9 @@ struct cam_irq_evt_handler {
 	void                              *bottom_half;
 	struct cam_irq_bh_api              irq_bh_api;
 	struct list_head                   list_node;
-	struct list_head                   th_list_node;
+	struct cam_irq_bit_node           *bit_nodes;
+	uint32_t                           num_bit_nodes;
+	uint32_t                           th_seq;
 	int                                index;
 };
 
@@ -55,6 +80,9 @@ struct cam_irq_evt_handler {
  * @top_half_enable_mask:   Array of enabled bit_mask sorted by priority
  * @pclear_mask:            Partial mask to be cleared in case entire status
  *                          register is not to be cleared
+ * @subscribed_mask:        Per priority mask of bits with at least one
+ *                          subscriber, enabled or not
+ * @bit_list:               Per priority, per bit list of subscribed handlers
  */
 struct cam_irq_register_obj {
 	uint32_t                     index;
@@ -63,6 +91,9 @@ struct cam_irq_register_obj {
 	uint32_t                     status_reg_offset;
 	uint32_t                     top_half_enable_mask[CAM_IRQ_PRIORITY_MAX];
 	uint32_t                     pclear_mask;
+	uint32_t                     subscribed_mask[CAM_IRQ_PRIORITY_MAX];
+	struct list_head
+		bit_list[CAM_IRQ_PRIORITY_MAX][CAM_IRQ_BITS_PER_REG];
 };
 
 /**
@@ -83,7 +114,7 @@ struct cam_irq_register_obj {
  * @global_clear_bitmask:   Bitmask needed to be used in Global Clear register
  *                          for Clear IRQ cmd to take effect
  * @evt_handler_list_head:  List of all event handlers
- * @th_list_head:           List of handlers sorted by priority
+ * @th_seq:                 Sequence number of the current top half pass
  * @hdl_idx:                Unique identity of handler assigned on Subscribe.
  *                          Used to Unsubscribe.
  * @lock:                   Lock for use by controller
@@ -99,7 +130,7 @@ struct cam_irq_controller {
 	uint32_t                        global_clear_offset;
 	uint32_t                        global_clear_bitmask;
 	struct list_head                evt_handler_list_head;
-	struct list_head                th_list_head[CAM_IRQ_PRIORITY_MAX];
+	uint32_t                        th_seq;
 	uint32_t                        hdl_idx;
 	spinlock_t                      lock;
 	struct cam_irq_th_payload       th_payload;
@@ -116,6 +147,7 @@ int cam_irq_controller_deinit(void **irq_controller)
 			&controller->evt_handler_list_head,
 			struct cam_irq_evt_handler, list_node);
 		list_del_init(&evt_handler->list_node);
+		kfree(evt_handler->bit_nodes);
 		kfree(evt_handler->evt_bit_mask_arr);
 		kfree(evt_handler);
 	}
@@ -135,7 +167,7 @@ int cam_irq_controller_init(const char       *name,
 	bool                                  clear_all)
 {
 	struct cam_irq_controller *controller = NULL;
-	int i, rc = 0;
+	int i, j, k, rc = 0;
 
 	*irq_controller = NULL;
 
@@ -190,6 +222,10 @@ int cam_irq_controller_init(const char       *name,
 			register_info->irq_reg_set[i].clear_reg_offset;
 		controller->irq_register_arr[i].status_reg_offset =
 			register_info->irq_reg_set[i].status_reg_offset;
+		for (j = 0; j < CAM_IRQ_PRIORITY_MAX; j++)
+			for (k = 0; k < CAM_IRQ_BITS_PER_REG; k++)
+				INIT_LIST_HEAD(&controller->irq_register_arr[i]
+					.bit_list[j][k]);
 		CAM_DBG(CAM_IRQ_CTRL, "i %d mask_reg_offset: 0x%x", i,
 			controller->irq_register_arr[i].mask_reg_offset);
 		CAM_DBG(CAM_IRQ_CTRL, "i %d clear_reg_offset: 0x%x", i,
@@ -211,8 +247,6 @@ int cam_irq_controller_init(const char       *name,
 		(void __iomem *)controller->mem_base);
 
 	INIT_LIST_HEAD(&controller->evt_handler_list_head);
-	for (i = 0; i < CAM_IRQ_PRIORITY_MAX; i++)
-		INIT_LIST_HEAD(&controller->th_list_head[i]);
 
 	spin_lock_init(&controller->lock);
 
@@ -231,6 +265,73 @@ reg_alloc_error:
 	return rc;
 }
 
+/**
+ * cam_irq_controller_index_handler()
+ *
+ * @Brief:                Add the handler to the subscriber list of every bit
+ *                        it subscribed to. Called with controller lock held.
+ *
+ * @controller:           IRQ Controller structure
+ * @evt_handler:          Event handler structure
+ */
+static void cam_irq_controller_index_handler(
+	struct cam_irq_controller   *controller,
+	struct cam_irq_evt_handler  *evt_handler)
+{
+	struct cam_irq_register_obj *irq_register;
+	struct cam_irq_bit_node     *node = evt_handler->bit_nodes;
+	uint32_t                     mask, bit;
+	int                          i;
+
+	for (i = 0; i < controller->num_registers; i++) {
+		irq_register = &controller->irq_register_arr[i];
+		mask = evt_handler->evt_bit_mask_arr[i];
+		irq_register->subscribed_mask[evt_handler->priority] |= mask;
+		while (mask) {
+			bit = __ffs(mask);
+			mask &= mask - 1;
+			node->evt_handler = evt_handler;
+			list_add_tail(&node->list,
+				&irq_register->bit_list[evt_handler->priority][bit]);
+			node++;
+		}
+	}
+}
+
+/**
+ * cam_irq_controller_unindex_handler()
+ *
+ * @Brief:                Remove the handler from the per bit subscriber lists.
+ *                        Called with controller lock held.
+ *
+ * @controller:           IRQ Controller structure
+ * @evt_handler:          Event handler structure
+ */
+static void cam_irq_controller_unindex_handler(
+	struct cam_irq_controller   *controller,
+	struct cam_irq_evt_handler  *evt_handler)
+{
+	struct cam_irq_register_obj *irq_register;
+	enum cam_irq_priority_level  priority = evt_handler->priority;
+	uint32_t                     mask, bit;
+	int                          i;
+
+	for (i = 0; i < evt_handler->num_bit_nodes; i++)
+		list_del_init(&evt_handler->bit_nodes[i].list);
+
+	for (i = 0; i < controller->num_registers; i++) {
+		irq_register = &controller->irq_register_arr[i];
+		mask = evt_handler->evt_bit_mask_arr[i];
+		while (mask) {
+			bit = __ffs(mask);
+			mask &= mask - 1;
+			if (list_empty(&irq_register->bit_list[priority][bit]))
+				irq_register->subscribed_mask[priority] &=
+					~BIT(bit);
+		}
+	}
+}
+
 int cam_irq_controller_subscribe_irq(void *irq_controller,
 	enum cam_irq_priority_level        priority,
 	uint32_t                          *evt_bit_mask_arr,
@@ -303,10 +404,21 @@ int cam_irq_controller_subscribe_irq(void *irq_controller,
 	}
 
 	INIT_LIST_HEAD(&evt_handler->list_node);
-	INIT_LIST_HEAD(&evt_handler->th_list_node);
 
-	for (i = 0; i < controller->num_registers; i++)
+	for (i = 0; i < controller->num_registers; i++) {
 		evt_handler->evt_bit_mask_arr[i] = evt_bit_mask_arr[i];
+		evt_handler->num_bit_nodes += hweight32(evt_bit_mask_arr[i]);
+	}
+
+	if (evt_handler->num_bit_nodes) {
+		evt_handler->bit_nodes = kcalloc(evt_handler->num_bit_nodes,
+			sizeof(struct cam_irq_bit_node), GFP_KERNEL);
+		if (!evt_handler->bit_nodes) {
+			CAM_DBG(CAM_IRQ_CTRL, "Error allocating bit nodes");
+			rc = -ENOMEM;
+			goto free_evt_bit_mask;
+		}
+	}
 
 	evt_handler->priority                 = priority;
 	evt_handler->handler_priv             = handler_priv;
@@ -342,14 +454,15 @@ int cam_irq_controller_subscribe_irq(void *irq_controller,
 
 	list_add_tail(&evt_handler->list_node,
 		&controller->evt_handler_list_head);
-	list_add_tail(&evt_handler->th_list_node,
-		&controller->th_list_head[priority]);
+	cam_irq_controller_index_handler(controller, evt_handler);
 
 	if (need_lock)
 		spin_unlock_irqrestore(&controller->lock, flags);
 
 	return evt_handler->index;
 
+free_evt_bit_mask:
+	kfree(evt_handler->evt_bit_mask_arr);
 free_evt_handler:
 	kfree(evt_handler);
 	evt_handler = NULL;
@@ -508,7 +621,6 @@ int cam_irq_controller_unsubscribe_irq(void *irq_controller,
 		if (evt_handler->index == handle) {
 			CAM_DBG(CAM_IRQ_CTRL, "unsubscribe item %d", handle);
 			list_del_init(&evt_handler->list_node);
-			list_del_init(&evt_handler->th_list_node);
 			found = 1;
 			rc = 0;
 			break;
@@ -517,6 +629,7 @@ int cam_irq_controller_unsubscribe_irq(void *irq_controller,
 
 	if (found) {
 		priority = evt_handler->priority;
+		cam_irq_controller_unindex_handler(controller, evt_handler);
 		for (i = 0; i < controller->num_registers; i++) {
 			irq_register = &controller->irq_register_arr[i];
 			irq_register->top_half_enable_mask[priority] &=
@@ -540,6 +653,7 @@ int cam_irq_controller_unsubscribe_irq(void *irq_controller,
 					controller->global_clear_offset);
 		}
 
+		kfree(evt_handler->bit_nodes);
 		kfree(evt_handler->evt_bit_mask_arr);
 		kfree(evt_handler);
 	}
@@ -550,111 +664,119 @@ int cam_irq_controller_unsubscribe_irq(void *irq_controller,
 	return rc;
 }
 
-/**
- * cam_irq_controller_match_bit_mask()
- *
- * @Brief:                This function checks if any of the enabled IRQ bits
- *                        for a certain handler is Set in the Status values
- *                        of the controller.
- *
- * @controller:           IRQ Controller structure
- * @evt_handler:          Event handler structure
- *
- * @Return:               True: If any interested IRQ Bit is Set
- *                        False: Otherwise
- */
-static bool cam_irq_controller_match_bit_mask(
-	struct cam_irq_controller   *controller,
-	struct cam_irq_evt_handler  *evt_handler)
-{
-	int i;
-
-	for (i = 0; i < controller->num_registers; i++) {
-		if (evt_handler->evt_bit_mask_arr[i] &
-			controller->irq_status_arr[i])
-			return true;
-	}
-
-	return false;
-}
-
-static void cam_irq_controller_th_processing(
+static void cam_irq_controller_th_dispatch(
 	struct cam_irq_controller      *controller,
-	struct list_head               *th_list_head)
+	struct cam_irq_evt_handler     *evt_handler)
 {
-	struct cam_irq_evt_handler     *evt_handler = NULL;
 	struct cam_irq_th_payload      *th_payload = &controller->th_payload;
-	bool                            is_irq_match;
 	int                             rc = -EINVAL;
 	int                             i;
 	void                           *bh_cmd = NULL;
 	struct cam_irq_bh_api          *irq_bh_api = NULL;
 
-	CAM_DBG(CAM_IRQ_CTRL, "Enter");
+	CAM_DBG(CAM_IRQ_CTRL, "match found");
 
-	if (list_empty(th_list_head))
-		return;
+	cam_irq_th_payload_init(th_payload);
+	th_payload->handler_priv  = evt_handler->handler_priv;
+	th_payload->num_registers = controller->num_registers;
+	for (i = 0; i < controller->num_registers; i++) {
+		th_payload->evt_status_arr[i] =
+			controller->irq_status_arr[i] &
+			evt_handler->evt_bit_mask_arr[i];
+	}
 
-	list_for_each_entry(evt_handler, th_list_head, th_list_node) {
-		is_irq_match = cam_irq_controller_match_bit_mask(controller,
-			evt_handler);
+	irq_bh_api = &evt_handler->irq_bh_api;
 
-		if (!is_irq_match)
-			continue;
+	if (evt_handler->bottom_half_handler) {
+		rc = irq_bh_api->get_bh_payload_func(
+			evt_handler->bottom_half, &bh_cmd);
+		if (rc || !bh_cmd) {
+			CAM_ERR_RATE_LIMIT(CAM_ISP,
+				"No payload, IRQ handling frozen for %s",
+				controller->name);
+			return;
+		}
+	}
 
-		CAM_DBG(CAM_IRQ_CTRL, "match found");
+	/*
+	 * irq_status_arr[0] is dummy argument passed. the entire
+	 * status array is passed in th_payload.
+	 */
+	if (evt_handler->top_half_handler)
+		rc = evt_handler->top_half_handler(
+			controller->irq_status_arr[0],
+			(void *)th_payload);
+
+	if (rc && bh_cmd) {
+		irq_bh_api->put_bh_payload_func(
+			evt_handler->bottom_half, &bh_cmd);
+		return;
+	}
 
-		cam_irq_th_payload_init(th_payload);
-		th_payload->handler_priv  = evt_handler->handler_priv;
-		th_payload->num_registers = controller->num_registers;
-		for (i = 0; i < controller->num_registers; i++) {
-			th_payload->evt_status_arr[i] =
-				controller->irq_status_arr[i] &
-				evt_handler->evt_bit_mask_arr[i];
-		}
+	if (evt_handler->bottom_half_handler) {
+		CAM_DBG(CAM_IRQ_CTRL, "Enqueuing bottom half for %s",
+			controller->name);
+		irq_bh_api->bottom_half_enqueue_func(
+			evt_handler->bottom_half,
+			bh_cmd,
+			evt_handler->handler_priv,
+			th_payload->evt_payload_priv,
+			evt_handler->bottom_half_handler);
+	}
+}
 
-		irq_bh_api = &evt_handler->irq_bh_api;
-		bh_cmd = NULL;
-
-		if (evt_handler->bottom_half_handler) {
-			rc = irq_bh_api->get_bh_payload_func(
-				evt_handler->bottom_half, &bh_cmd);
-			if (rc || !bh_cmd) {
-				CAM_ERR_RATE_LIMIT(CAM_ISP,
-					"No payload, IRQ handling frozen for %s",
-					controller->name);
-				continue;
-			}
-		}
+/**
+ * cam_irq_controller_th_processing()
+ *
+ * @Brief:                Walk the set status bits and run the top half of
+ *                        every handler subscribed to them at this priority.
+ *                        A handler subscribed to several of the set bits
+ *                        runs once.
+ *
+ * @controller:           IRQ Controller structure
+ * @priority:             Priority level to process
+ *
+ * @Return:               Number of handlers invoked
+ */
+static uint32_t cam_irq_controller_th_processing(
+	struct cam_irq_controller      *controller,
+	enum cam_irq_priority_level     priority)
+{
+	struct cam_irq_register_obj    *irq_register;
+	struct cam_irq_bit_node        *node, *node_temp;
+	struct cam_irq_evt_handler     *evt_handler;
+	uint32_t                        pending, bit, seq;
+	uint32_t                        num_handled = 0;
+	int                             i;
 
-		/*
-		 * irq_status_arr[0] is dummy argument passed. the entire
-		 * status array is passed in th_payload.
-		 */
-		if (evt_handler->top_half_handler)
-			rc = evt_handler->top_half_handler(
-				controller->irq_status_arr[0],
-				(void *)th_payload);
-
-		if (rc && bh_cmd) {
-			irq_bh_api->put_bh_payload_func(
-				evt_handler->bottom_half, &bh_cmd);
-			continue;
-		}
+	CAM_DBG(CAM_IRQ_CTRL, "Enter");
 
-		if (evt_handler->bottom_half_handler) {
-			CAM_DBG(CAM_IRQ_CTRL, "Enqueuing bottom half for %s",
-				controller->name);
-			irq_bh_api->bottom_half_enqueue_func(
-				evt_handler->bottom_half,
-				bh_cmd,
-				evt_handler->handler_priv,
-				th_payload->evt_payload_priv,
-				evt_handler->bottom_half_handler);
+	seq = ++controller->th_seq;
+	for (i = 0; i < controller->num_registers; i++) {
+		irq_register = &controller->irq_register_arr[i];
+		pending = controller->irq_status_arr[i] &
+			irq_register->subscribed_mask[priority];
+
+		while (pending) {
+			bit = __ffs(pending);
+			pending &= pending - 1;
+			list_for_each_entry_safe(node, node_temp,
+				&irq_register->bit_list[priority][bit], list) {
+				evt_handler = node->evt_handler;
+				if (evt_handler->th_seq == seq)
+					continue;
+
+				evt_handler->th_seq = seq;
+				cam_irq_controller_th_dispatch(controller,
+					evt_handler);
+				num_handled++;
+			}
 		}
 	}
 
 	CAM_DBG(CAM_IRQ_CTRL, "Exit");
+
+	return num_handled;
 }
 
 irqreturn_t cam_irq_controller_clear_and_mask(int irq_num, void *priv)
@@ -691,10 +813,17 @@ irqreturn_t cam_irq_controller_handle_irq(int irq_num, void *priv)
 	bool         need_th_processing[CAM_IRQ_PRIORITY_MAX] = {false};
 	int          i;
 	int          j;
+	uint32_t     num_handled = 0;
+	ktime_t      start_ts = 0;
+	bool         trace_on;
 
 	if (!controller)
 		return IRQ_NONE;
 
+	trace_on = trace_cam_irq_th_duration_enabled();
+	if (trace_on)
+		start_ts = ktime_get();
+
 	CAM_DBG(CAM_IRQ_CTRL,
 		"Locking: %s IRQ Controller: [%pK], lock handle: %pK",
 		controller->name, controller, &controller->lock);
@@ -748,11 +877,15 @@ irqreturn_t cam_irq_controller_handle_irq(int irq_num, void *priv)
 	for (i = 0; i < CAM_IRQ_PRIORITY_MAX; i++) {
 		if (need_th_processing[i]) {
 			CAM_DBG(CAM_IRQ_CTRL, "Invoke TH processing");
-			cam_irq_controller_th_processing(controller,
-				&controller->th_list_head[i]);
+			num_handled += cam_irq_controller_th_processing(
+				controller, i);
 		}
 	}
 	spin_unlock(&controller->lock);
+
+	if (trace_on)
+		trace_cam_irq_th_duration(controller->name, num_handled,
+			ktime_to_ns(ktime_sub(ktime_get(), start_ts)));
 	CAM_DBG(CAM_IRQ_CTRL,
 		"Unlocked: %s IRQ Controller: %pK, lock handle: %pK",
 		controller->name, controller, &controller->lock);
@@ -18,6 +18,101 @@
 #define CAM_ISP_HW_DUMP_TAG_MAX_LEN 32
 /* Max isp hw pid values number */
 #define CAM_ISP_HW_MAX_PID_VAL      4
+/* WM config registers tracked for delta programming */
+#define CAM_ISP_WM_SHADOW_MAX_REGS  8
+/* WM buffer updates between forced full register refreshes */
+#define CAM_ISP_WM_SHADOW_REFRESH   64
+
+/*
+ * struct cam_isp_wm_shadow:
+ *
+ * @Brief:              Last value prepared for the static registers of a
+ *                      write master, so unchanged ones can be left out of
+ *                      the next buffer update
+ *
+ * @num_regs:           Number of valid entries
+ * @offset:             Register offsets
+ * @val:                Register values
+ * @num_updates:        Buffer updates since the last full refresh
+ */
+struct cam_isp_wm_shadow {
+	uint32_t                num_regs;
+	uint32_t                offset[CAM_ISP_WM_SHADOW_MAX_REGS];
+	uint32_t                val[CAM_ISP_WM_SHADOW_MAX_REGS];
+	uint32_t                num_updates;
+};
+
+/*
+ * cam_isp_wm_shadow_reset()
+ *
+ * @Brief:              Forget all shadowed values, the next update
+ *                      programs every register
+ *
+ * @shadow:             WM shadow
+ */
+static inline void cam_isp_wm_shadow_reset(struct cam_isp_wm_shadow *shadow)
+{
+	shadow->num_regs = 0;
+	shadow->num_updates = 0;
+}
+
+/*
+ * cam_isp_wm_shadow_begin()
+ *
+ * @Brief:              Start a buffer update, forces a full refresh every
+ *                      CAM_ISP_WM_SHADOW_REFRESH updates
+ *
+ * @shadow:             WM shadow
+ */
+static inline void cam_isp_wm_shadow_begin(struct cam_isp_wm_shadow *shadow)
+{
+	if (shadow->num_updates++ >= CAM_ISP_WM_SHADOW_REFRESH) {
+		shadow->num_regs = 0;
+		shadow->num_updates = 1;
+	}
+}
+
+/*
+ * cam_isp_wm_shadow_add_reg()
+ *
+ * @Brief:              Append a register to the update unless the shadow
+ *                      says it already holds this value
+ *
+ * @shadow:             WM shadow
+ * @reg_val_pair:       Register/value array
+ * @index:              Next free index in @reg_val_pair
+ * @num_skipped:        Incremented for every register left out
+ * @offset:             Register offset
+ * @val:                Register value
+ */
+static inline void cam_isp_wm_shadow_add_reg(struct cam_isp_wm_shadow *shadow,
+	uint32_t *reg_val_pair, uint32_t *index, uint32_t *num_skipped,
+	uint32_t offset, uint32_t val)
+{
+	uint32_t i;
+
+	for (i = 0; i < shadow->num_regs; i++) {
+		if (shadow->offset[i] != offset)
+			continue;
+
+		if (shadow->val[i] == val) {
+			(*num_skipped)++;
+			return;
+		}
+
+		shadow->val[i] = val;
+		goto add_reg;
+	}
+
+	if (shadow->num_regs < CAM_ISP_WM_SHADOW_MAX_REGS) {
+		shadow->offset[shadow->num_regs] = offset;
+		shadow->val[shadow->num_regs++] = val;
+	}
+
+add_reg:
+	reg_val_pair[(*index)++] = offset;
+	reg_val_pair[(*index)++] = val;
+}
 /*
  * struct cam_isp_timestamp:
  *
@@ -139,6 +234,7 @@ enum cam_isp_hw_cmd_type {
 	CAM_ISP_HW_CMD_DYNAMIC_CLOCK_UPDATE,
 	CAM_ISP_HW_DUMP_HW_SRC_CLK_RATE,
 	CAM_ISP_HW_CMD_TPG_SET_PATTERN,
+	CAM_ISP_HW_CMD_WM_SHADOW_RESET,
 	CAM_ISP_HW_CMD_MAX,
 };
 
@@ -260,6 +356,8 @@ struct cam_isp_hw_cmd_buf_update {
  * @ stride:           stride of scratch buffer
  * @ slice_height:     slice height of scratch buffer
  * @ io_cfg:           IO buffer config information sent from UMD
+ * @ skipped_regs:     Output, registers left out of the update because
+ *                     the WM already holds their value
  *
  */
 struct cam_isp_hw_get_wm_update {
@@ -274,6 +372,7 @@ struct cam_isp_hw_get_wm_update {
 	uint32_t                        stride;
 	uint32_t                        slice_height;
 	struct cam_buf_io_cfg          *io_cfg;
+	uint32_t                        skipped_regs;
 };
 
 /*
@@ -123,6 +123,7 @@ struct cam_sfe_bus_wr_wm_resource_data {
 
 	uint32_t             acquired_width;
 	uint32_t             acquired_height;
+	struct cam_isp_wm_shadow shadow;
 };
 
 struct cam_sfe_bus_wr_comp_grp_data {
@@ -509,6 +510,7 @@ static int cam_sfe_bus_release_wm(void   *bus_priv,
 	rsrc_data->h_init = 0;
 	rsrc_data->init_cfg_done = false;
 	rsrc_data->hfr_cfg_done = false;
+	cam_isp_wm_shadow_reset(&rsrc_data->shadow);
 	rsrc_data->en_cfg = 0;
 	rsrc_data->is_dual = 0;
 
@@ -568,6 +570,7 @@ static int cam_sfe_bus_stop_wm(struct cam_isp_resource_node *wm_res)
 	wm_res->res_state = CAM_ISP_RESOURCE_STATE_RESERVED;
 	rsrc_data->init_cfg_done = false;
 	rsrc_data->hfr_cfg_done = false;
+	cam_isp_wm_shadow_reset(&rsrc_data->shadow);
 
 	return 0;
 }
@@ -1690,9 +1693,10 @@ static int cam_sfe_bus_wr_update_wm(void *priv, void *cmd_args,
 	struct cam_sfe_bus_wr_out_data         *sfe_out_data = NULL;
 	struct cam_sfe_bus_wr_wm_resource_data *wm_data = NULL;
 	uint32_t *reg_val_pair;
-	uint32_t  i, j, k, size = 0;
+	uint32_t  i, j, k, size = 0, num_skipped = 0;
 	uint32_t  frame_inc = 0, val;
 	uint32_t loop_size = 0, stride = 0, slice_h = 0;
+	bool      refresh;
 
 	bus_priv = (struct cam_sfe_bus_wr_priv  *) priv;
 	update_buf =  (struct cam_isp_hw_get_cmd_update *) cmd_args;
@@ -1728,17 +1732,19 @@ static int cam_sfe_bus_wr_update_wm(void *priv, void *cmd_args,
 
 		wm_data = (struct cam_sfe_bus_wr_wm_resource_data *)
 			sfe_out_data->wm_res[i].res_priv;
+		cam_isp_wm_shadow_begin(&wm_data->shadow);
+		refresh = !wm_data->shadow.num_regs;
 
-		CAM_SFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
-			wm_data->hw_regs->cfg, wm_data->en_cfg);
+		cam_isp_wm_shadow_add_reg(&wm_data->shadow, reg_val_pair, &j,
+			&num_skipped, wm_data->hw_regs->cfg, wm_data->en_cfg);
 		CAM_DBG(CAM_SFE, "WM:%d en_cfg 0x%X",
-			wm_data->index, reg_val_pair[j-1]);
+			wm_data->index, wm_data->en_cfg);
 
 		val = (wm_data->height << 16) | wm_data->width;
-		CAM_SFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
-			wm_data->hw_regs->image_cfg_0, val);
+		cam_isp_wm_shadow_add_reg(&wm_data->shadow, reg_val_pair, &j,
+			&num_skipped, wm_data->hw_regs->image_cfg_0, val);
 		CAM_DBG(CAM_SFE, "WM:%d image height and width 0x%X",
-			wm_data->index, reg_val_pair[j-1]);
+			wm_data->index, val);
 
 		/* For initial configuration program all bus registers */
 		if (update_buf->use_scratch_cfg) {
@@ -1757,7 +1763,8 @@ static int cam_sfe_bus_wr_update_wm(void *priv, void *cmd_args,
 			CAM_WARN(CAM_SFE, "Warning stride %u expected %u",
 				stride, val);
 
-		if (wm_data->stride != val || !wm_data->init_cfg_done) {
+		if (wm_data->stride != val || !wm_data->init_cfg_done ||
+			refresh) {
 			CAM_SFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
 				wm_data->hw_regs->image_cfg_2,
 				stride);
@@ -1769,10 +1776,11 @@ static int cam_sfe_bus_wr_update_wm(void *priv, void *cmd_args,
 		frame_inc = stride * slice_h;
 
 		if (!(wm_data->en_cfg & (0x3 << 16))) {
-			CAM_SFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
+			cam_isp_wm_shadow_add_reg(&wm_data->shadow,
+				reg_val_pair, &j, &num_skipped,
 				wm_data->hw_regs->image_cfg_1, wm_data->h_init);
 			CAM_DBG(CAM_SFE, "WM:%d h_init 0x%X",
-				wm_data->index, reg_val_pair[j-1]);
+				wm_data->index, wm_data->h_init);
 		}
 
 		if (wm_data->index > 7)
@@ -1797,10 +1805,10 @@ static int cam_sfe_bus_wr_update_wm(void *priv, void *cmd_args,
 				wm_data->index, reg_val_pair[j-1]);
 		}
 
-		CAM_SFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
-			wm_data->hw_regs->frame_incr, frame_inc);
+		cam_isp_wm_shadow_add_reg(&wm_data->shadow, reg_val_pair, &j,
+			&num_skipped, wm_data->hw_regs->frame_incr, frame_inc);
 		CAM_DBG(CAM_SFE, "WM:%d frame_inc %d",
-			wm_data->index, reg_val_pair[j-1]);
+			wm_data->index, frame_inc);
 
 		/* enable the WM */
 		CAM_SFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
@@ -1827,6 +1835,7 @@ static int cam_sfe_bus_wr_update_wm(void *priv, void *cmd_args,
 
 	/* cdm util returns dwords, need to convert to bytes */
 	update_buf->cmd.used_bytes = size * 4;
+	update_buf->wm_update->skipped_regs = num_skipped;
 
 	return 0;
 }
@@ -2137,6 +2146,27 @@ static int __cam_sfe_bus_wr_process_cmd(
 		cmd_args, arg_size);
 }
 
+static int cam_sfe_bus_wr_reset_wm_shadow(void *cmd_args)
+{
+	struct cam_isp_resource_node           *sfe_out = cmd_args;
+	struct cam_sfe_bus_wr_out_data         *sfe_out_data;
+	struct cam_sfe_bus_wr_wm_resource_data *wm_data;
+	uint32_t                                i;
+
+	sfe_out_data = sfe_out->res_priv;
+	if (!sfe_out_data) {
+		CAM_ERR(CAM_SFE, "Failed! Invalid data");
+		return -EINVAL;
+	}
+
+	for (i = 0; i < sfe_out_data->num_wm; i++) {
+		wm_data = sfe_out_data->wm_res[i].res_priv;
+		cam_isp_wm_shadow_reset(&wm_data->shadow);
+	}
+
+	return 0;
+}
+
 static int cam_sfe_bus_wr_process_cmd(
 	struct cam_isp_resource_node *priv,
 	uint32_t cmd_type, void *cmd_args,
@@ -2181,6 +2211,9 @@ static int cam_sfe_bus_wr_process_cmd(
 			sfe_out_res_id, bus_priv);
 		break;
 		}
+	case CAM_ISP_HW_CMD_WM_SHADOW_RESET:
+		rc = cam_sfe_bus_wr_reset_wm_shadow(cmd_args);
+		break;
 	case CAM_ISP_HW_CMD_WM_CONFIG_UPDATE:
 		rc = cam_sfe_bus_wr_update_wm_config(cmd_args);
 		break;
@@ -152,6 +152,7 @@ struct cam_vfe_bus_ver2_wm_resource_data {
 	uint32_t             ubwc_bandwidth_limit;
 	uint32_t             acquired_width;
 	uint32_t             acquired_height;
+	struct cam_isp_wm_shadow shadow;
 };
 
 struct cam_vfe_bus_ver2_comp_grp_data {
@@ -1404,6 +1405,7 @@ static int cam_vfe_bus_release_wm(void   *bus_priv,
 	rsrc_data->ubwc_meta_offset = 0;
 	rsrc_data->init_cfg_done = false;
 	rsrc_data->hfr_cfg_done = false;
+	cam_isp_wm_shadow_reset(&rsrc_data->shadow);
 	rsrc_data->en_cfg = 0;
 	rsrc_data->is_dual = 0;
 
@@ -1545,6 +1547,7 @@ static int cam_vfe_bus_stop_wm(struct cam_isp_resource_node *wm_res)
 	wm_res->res_state = CAM_ISP_RESOURCE_STATE_RESERVED;
 	rsrc_data->init_cfg_done = false;
 	rsrc_data->hfr_cfg_done = false;
+	cam_isp_wm_shadow_reset(&rsrc_data->shadow);
 
 	return rc;
 }
@@ -3219,9 +3222,10 @@ static int cam_vfe_bus_update_wm(void *priv, void *cmd_args,
 	struct cam_vfe_bus_ver2_wm_resource_data *wm_data = NULL;
 	struct cam_vfe_bus_ver2_reg_offset_ubwc_client *ubwc_client = NULL;
 	uint32_t *reg_val_pair;
-	uint32_t  i, j, k, size = 0;
+	uint32_t  i, j, k, size = 0, num_skipped = 0;
 	uint32_t  frame_inc = 0, val;
 	uint32_t loop_size = 0;
+	bool      refresh;
 
 	bus_priv = (struct cam_vfe_bus_ver2_priv  *) priv;
 	update_buf =  (struct cam_isp_hw_get_cmd_update *) cmd_args;
@@ -3254,12 +3258,14 @@ static int cam_vfe_bus_update_wm(void *priv, void *cmd_args,
 
 		wm_data = vfe_out_data->wm_res[i]->res_priv;
 		ubwc_client = wm_data->hw_regs->ubwc_regs;
+		cam_isp_wm_shadow_begin(&wm_data->shadow);
+		refresh = !wm_data->shadow.num_regs;
 		/* update width register */
-		CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
-			wm_data->hw_regs->buffer_width_cfg,
+		cam_isp_wm_shadow_add_reg(&wm_data->shadow, reg_val_pair, &j,
+			&num_skipped, wm_data->hw_regs->buffer_width_cfg,
 			wm_data->width);
 		CAM_DBG(CAM_ISP, "WM %d image width 0x%x",
-			wm_data->index, reg_val_pair[j-1]);
+			wm_data->index, wm_data->width);
 
 		/* For initial configuration program all bus registers */
 		val = io_cfg->planes[i].plane_stride;
@@ -3272,8 +3278,8 @@ static int cam_vfe_bus_update_wm(void *priv, void *cmd_args,
 				io_cfg->planes[i].plane_stride,
 				val);
 
-		if ((wm_data->stride != val ||
-			!wm_data->init_cfg_done) && (wm_data->index >= 3)) {
+		if ((wm_data->stride != val || !wm_data->init_cfg_done ||
+			refresh) && (wm_data->index >= 3)) {
 			CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
 				wm_data->hw_regs->stride,
 				io_cfg->planes[i].plane_stride);
@@ -3288,7 +3294,7 @@ static int cam_vfe_bus_update_wm(void *priv, void *cmd_args,
 					"No UBWC register to configure.");
 				return -EINVAL;
 			}
-			if (wm_data->ubwc_updated) {
+			if (wm_data->ubwc_updated || refresh) {
 				wm_data->ubwc_updated = false;
 				cam_vfe_bus_update_ubwc_regs(
 					wm_data, reg_val_pair, i, &j);
@@ -3341,10 +3347,10 @@ static int cam_vfe_bus_update_wm(void *priv, void *cmd_args,
 				wm_data->index, reg_val_pair[j-1]);
 		}
 
-		CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
-			wm_data->hw_regs->frame_inc, frame_inc);
+		cam_isp_wm_shadow_add_reg(&wm_data->shadow, reg_val_pair, &j,
+			&num_skipped, wm_data->hw_regs->frame_inc, frame_inc);
 		CAM_DBG(CAM_ISP, "WM %d frame_inc %d",
-			wm_data->index, reg_val_pair[j-1]);
+			wm_data->index, frame_inc);
 
 
 		/* enable the WM */
@@ -3372,6 +3378,7 @@ static int cam_vfe_bus_update_wm(void *priv, void *cmd_args,
 
 	/* cdm util returns dwords, need to convert to bytes */
 	update_buf->cmd.used_bytes = size * 4;
+	update_buf->wm_update->skipped_regs = num_skipped;
 
 	return 0;
 }
@@ -3991,6 +3998,27 @@ end:
 	return 0;
 }
 
+static int cam_vfe_bus_reset_wm_shadow(void *cmd_args)
+{
+	struct cam_isp_resource_node             *vfe_out = cmd_args;
+	struct cam_vfe_bus_ver2_vfe_out_data     *vfe_out_data;
+	struct cam_vfe_bus_ver2_wm_resource_data *wm_data;
+	uint32_t                                  i;
+
+	vfe_out_data = vfe_out->res_priv;
+	if (!vfe_out_data) {
+		CAM_ERR(CAM_ISP, "Failed! Invalid data");
+		return -EINVAL;
+	}
+
+	for (i = 0; i < vfe_out_data->num_wm; i++) {
+		wm_data = vfe_out_data->wm_res[i]->res_priv;
+		cam_isp_wm_shadow_reset(&wm_data->shadow);
+	}
+
+	return 0;
+}
+
 static int cam_vfe_bus_process_cmd(
 	struct cam_isp_resource_node *priv,
 	uint32_t cmd_type, void *cmd_args, uint32_t arg_size)
@@ -4010,6 +4038,9 @@ static int cam_vfe_bus_process_cmd(
 	case CAM_ISP_HW_CMD_GET_BUF_UPDATE:
 		rc = cam_vfe_bus_update_wm(priv, cmd_args, arg_size);
 		break;
+	case CAM_ISP_HW_CMD_WM_SHADOW_RESET:
+		rc = cam_vfe_bus_reset_wm_shadow(cmd_args);
+		break;
 	case CAM_ISP_HW_CMD_GET_HFR_UPDATE:
 		rc = cam_vfe_bus_update_hfr(priv, cmd_args, arg_size);
 		break;
@@ -148,6 +148,7 @@ struct cam_vfe_bus_ver3_wm_resource_data {
 	uint32_t             ubwc_bandwidth_limit;
 	uint32_t             acquired_width;
 	uint32_t             acquired_height;
+	struct cam_isp_wm_shadow shadow;
 };
 
 struct cam_vfe_bus_ver3_comp_grp_data {
@@ -1391,6 +1392,7 @@ static int cam_vfe_bus_ver3_release_wm(void   *bus_priv,
 	rsrc_data->init_cfg_done = false;
 	rsrc_data->hfr_cfg_done = false;
 	rsrc_data->ubwc_updated = false;
+	cam_isp_wm_shadow_reset(&rsrc_data->shadow);
 	rsrc_data->en_cfg = 0;
 	rsrc_data->is_dual = 0;
 
@@ -1488,6 +1490,7 @@ static int cam_vfe_bus_ver3_stop_wm(struct cam_isp_resource_node *wm_res)
 	rsrc_data->init_cfg_done = false;
 	rsrc_data->hfr_cfg_done = false;
 	rsrc_data->ubwc_updated = false;
+	cam_isp_wm_shadow_reset(&rsrc_data->shadow);
 
 	return 0;
 }
@@ -2954,8 +2957,9 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 	struct cam_vfe_bus_ver3_wm_resource_data *wm_data = NULL;
 	struct cam_vfe_bus_ver3_reg_offset_ubwc_client *ubwc_client = NULL;
 	uint32_t *reg_val_pair;
-	uint32_t  i, j, size = 0;
+	uint32_t  i, j, size = 0, num_skipped = 0;
 	uint32_t  frame_inc = 0, val;
+	bool      refresh;
 
 	bus_priv = (struct cam_vfe_bus_ver3_priv  *) priv;
 	update_buf =  (struct cam_isp_hw_get_cmd_update *) cmd_args;
@@ -2988,6 +2992,8 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 
 		wm_data = vfe_out_data->wm_res[i].res_priv;
 		ubwc_client = wm_data->hw_regs->ubwc_regs;
+		cam_isp_wm_shadow_begin(&wm_data->shadow);
+		refresh = !wm_data->shadow.num_regs;
 
 		/* Disable frame header in case it was previously enabled */
 		if ((wm_data->en_cfg) & (1 << 2))
@@ -3012,16 +3018,16 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 			}
 		}
 
-		CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
-			wm_data->hw_regs->cfg, wm_data->en_cfg);
+		cam_isp_wm_shadow_add_reg(&wm_data->shadow, reg_val_pair, &j,
+			&num_skipped, wm_data->hw_regs->cfg, wm_data->en_cfg);
 		CAM_DBG(CAM_ISP, "WM:%d en_cfg 0x%X",
-			wm_data->index, reg_val_pair[j-1]);
+			wm_data->index, wm_data->en_cfg);
 
 		val = (wm_data->height << 16) | wm_data->width;
-		CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
-			wm_data->hw_regs->image_cfg_0, val);
+		cam_isp_wm_shadow_add_reg(&wm_data->shadow, reg_val_pair, &j,
+			&num_skipped, wm_data->hw_regs->image_cfg_0, val);
 		CAM_DBG(CAM_ISP, "WM:%d image height and width 0x%X",
-			wm_data->index, reg_val_pair[j-1]);
+			wm_data->index, val);
 
 		/* For initial configuration program all bus registers */
 		val = io_cfg->planes[i].plane_stride;
@@ -3032,7 +3038,8 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 			CAM_WARN(CAM_ISP, "Warning stride %u expected %u",
 				io_cfg->planes[i].plane_stride, val);
 
-		if (wm_data->stride != val || !wm_data->init_cfg_done) {
+		if (wm_data->stride != val || !wm_data->init_cfg_done ||
+			refresh) {
 			CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
 				wm_data->hw_regs->image_cfg_2,
 				io_cfg->planes[i].plane_stride);
@@ -3047,7 +3054,7 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 					"No UBWC register to configure.");
 				return -EINVAL;
 			}
-			if (wm_data->ubwc_updated) {
+			if (wm_data->ubwc_updated || refresh) {
 				wm_data->ubwc_updated = false;
 				cam_vfe_bus_ver3_update_ubwc_regs(
 					wm_data, reg_val_pair, i, &j);
@@ -3079,10 +3086,11 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 		}
 
 		if (!(wm_data->en_cfg & (0x3 << 16))) {
-			CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
+			cam_isp_wm_shadow_add_reg(&wm_data->shadow,
+				reg_val_pair, &j, &num_skipped,
 				wm_data->hw_regs->image_cfg_1, wm_data->h_init);
 			CAM_DBG(CAM_ISP, "WM:%d h_init 0x%X",
-				wm_data->index, reg_val_pair[j-1]);
+				wm_data->index, wm_data->h_init);
 		}
 
 		/* WM Image address */
@@ -3110,10 +3118,10 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 		CAM_DBG(CAM_ISP, "WM:%d image address 0x%X",
 			wm_data->index, reg_val_pair[j-1]);
 
-		CAM_VFE_ADD_REG_VAL_PAIR(reg_val_pair, j,
-			wm_data->hw_regs->frame_incr, frame_inc);
+		cam_isp_wm_shadow_add_reg(&wm_data->shadow, reg_val_pair, &j,
+			&num_skipped, wm_data->hw_regs->frame_incr, frame_inc);
 		CAM_DBG(CAM_ISP, "WM:%d frame_inc %d",
-			wm_data->index, reg_val_pair[j-1]);
+			wm_data->index, frame_inc);
 
 
 		/* enable the WM */
@@ -3141,6 +3149,7 @@ static int cam_vfe_bus_ver3_update_wm(void *priv, void *cmd_args,
 
 	/* cdm util returns dwords, need to convert to bytes */
 	update_buf->cmd.used_bytes = size * 4;
+	update_buf->wm_update->skipped_regs = num_skipped;
 
 	return 0;
 }
@@ -3686,6 +3695,27 @@ static int __cam_vfe_bus_ver3_process_cmd(void *priv,
 	return cam_vfe_bus_ver3_process_cmd(priv, cmd_type, cmd_args, arg_size);
 }
 
+static int cam_vfe_bus_ver3_reset_wm_shadow(void *cmd_args)
+{
+	struct cam_isp_resource_node             *vfe_out = cmd_args;
+	struct cam_vfe_bus_ver3_vfe_out_data     *vfe_out_data;
+	struct cam_vfe_bus_ver3_wm_resource_data *wm_data;
+	uint32_t                                  i;
+
+	vfe_out_data = vfe_out->res_priv;
+	if (!vfe_out_data) {
+		CAM_ERR(CAM_ISP, "Failed! Invalid data");
+		return -EINVAL;
+	}
+
+	for (i = 0; i < vfe_out_data->num_wm; i++) {
+		wm_data = vfe_out_data->wm_res[i].res_priv;
+		cam_isp_wm_shadow_reset(&wm_data->shadow);
+	}
+
+	return 0;
+}
+
 static int cam_vfe_bus_ver3_process_cmd(
 	struct cam_isp_resource_node *priv,
 	uint32_t cmd_type, void *cmd_args, uint32_t arg_size)
@@ -3742,6 +3772,9 @@ static int cam_vfe_bus_ver3_process_cmd(
 	case CAM_ISP_HW_CMD_WM_CONFIG_UPDATE:
 		rc = cam_vfe_bus_ver3_update_wm_config(cmd_args);
 		break;
+	case CAM_ISP_HW_CMD_WM_SHADOW_RESET:
+		rc = cam_vfe_bus_ver3_reset_wm_shadow(cmd_args);
+		break;
 	case CAM_ISP_HW_CMD_UNMASK_BUS_WR_IRQ:
 		bus_priv = (struct cam_vfe_bus_ver3_priv *) priv;
 		top_mask_0 = cam_io_r_mb(bus_priv->common_data.mem_base +
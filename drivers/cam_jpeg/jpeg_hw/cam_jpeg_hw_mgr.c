@@ -13,6 +13,8 @@
 #include <linux/spinlock.h>
 #include <linux/timer.h>
 #include <linux/debugfs.h>
+#include <linux/ktime.h>
+#include <linux/math64.h>
 #include <media/cam_defs.h>
 #include <media/cam_jpeg.h>
 #include <media/cam_sync.h>
@@ -40,51 +42,26 @@ static struct cam_jpeg_hw_mgr g_jpeg_hw_mgr;
 static int32_t cam_jpeg_hw_mgr_cb(uint32_t irq_status,
 	int32_t result_size, void *data);
 static int cam_jpeg_mgr_process_cmd(void *priv, void *data);
+static void cam_jpeg_mgr_dispatch_pending(struct cam_jpeg_hw_mgr *hw_mgr);
+static struct cam_jpeg_hw_cfg_req *cam_jpeg_mgr_get_next_req(
+	struct cam_jpeg_hw_mgr *hw_mgr, uint32_t dev_type, uint32_t dev_idx,
+	bool *built);
 static int cam_jpeg_insert_cdm_change_base(
-	struct cam_hw_config_args *config_args,
-	struct cam_jpeg_hw_ctx_data *ctx_data,
+	struct cam_jpeg_hw_cfg_req *p_cfg_req,
 	struct cam_jpeg_hw_mgr *hw_mgr);
 
-static int cam_jpeg_process_next_hw_update(void *priv, void *data,
+static int cam_jpeg_mgr_build_hw_update(struct cam_jpeg_hw_mgr *hw_mgr,
+	struct cam_jpeg_hw_cfg_req *p_cfg_req,
 	struct cam_hw_done_event_data *buf_data)
 {
 	int rc;
-	int i = 0;
-	struct cam_jpeg_hw_mgr *hw_mgr = priv;
 	struct cam_hw_update_entry *cmd;
 	struct cam_cdm_bl_request *cdm_cmd;
-	struct cam_hw_config_args *config_args = NULL;
-	struct cam_jpeg_hw_ctx_data *ctx_data = NULL;
-	uint32_t dev_type;
-	struct cam_jpeg_hw_cfg_req *p_cfg_req = NULL;
+	struct cam_hw_config_args *config_args;
 	uint32_t cdm_cfg_to_insert = 0;
 
-	if (!data || !priv) {
-		CAM_ERR(CAM_JPEG, "Invalid data");
-		return -EINVAL;
-	}
-
-	ctx_data = (struct cam_jpeg_hw_ctx_data *)data;
-	dev_type = ctx_data->jpeg_dev_acquire_info.dev_type;
-	p_cfg_req = hw_mgr->dev_hw_cfg_args[dev_type][0];
-	config_args = (struct cam_hw_config_args *)&p_cfg_req->hw_cfg_args;
-
-	if (!hw_mgr->devices[dev_type][0]->hw_ops.reset) {
-		CAM_ERR(CAM_JPEG, "op reset null ");
-		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_INVLD_CMD;
-		rc = -EFAULT;
-		goto end_error;
-	}
-	rc = hw_mgr->devices[dev_type][0]->hw_ops.reset(
-		hw_mgr->devices[dev_type][0]->hw_priv,
-		NULL, 0);
-	if (rc) {
-		CAM_ERR(CAM_JPEG, "jpeg hw reset failed %d", rc);
-		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_HW_RESET_FAILED;
-		goto end_error;
-	}
-
-	cdm_cmd = ctx_data->cdm_cmd;
+	config_args = &p_cfg_req->hw_cfg_args;
+	cdm_cmd = p_cfg_req->cdm_cmd;
 	cdm_cmd->type = CAM_CDM_BL_CMD_TYPE_MEM_HANDLE;
 	cdm_cmd->flag = false;
 	cdm_cmd->userdata = NULL;
@@ -92,12 +69,11 @@ static int cam_jpeg_process_next_hw_update(void *priv, void *data,
 	cdm_cmd->cmd_arrary_count = 0;
 
 	/* insert cdm chage base cmd */
-	rc = cam_jpeg_insert_cdm_change_base(config_args,
-		ctx_data, hw_mgr);
+	rc = cam_jpeg_insert_cdm_change_base(p_cfg_req, hw_mgr);
 	if (rc) {
 		CAM_ERR(CAM_JPEG, "insert change base failed %d", rc);
 		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_CDM_CHANGE_BASE_ERR;
-		goto end_error;
+		return rc;
 	}
 
 	/* insert next cdm payload at index */
@@ -121,74 +97,235 @@ static int cam_jpeg_process_next_hw_update(void *priv, void *data,
 		cmd->offset;
 	cdm_cmd->cmd[cdm_cmd->cmd_arrary_count].len =
 		cmd->len;
-	CAM_DBG(CAM_JPEG, "i %d entry h %d o %d l %d",
-		i, cmd->handle, cmd->offset, cmd->len);
+	CAM_DBG(CAM_JPEG, "entry h %d o %d l %d",
+		cmd->handle, cmd->offset, cmd->len);
 	cdm_cmd->cmd_arrary_count++;
 
+	return 0;
+}
+
+static int cam_jpeg_mgr_start_hw_update(struct cam_jpeg_hw_mgr *hw_mgr,
+	struct cam_jpeg_hw_cfg_req *p_cfg_req,
+	struct cam_hw_done_event_data *buf_data)
+{
+	int rc;
+	uint32_t dev_type = p_cfg_req->dev_type;
+	uint32_t dev_idx = p_cfg_req->dev_idx;
+	struct cam_hw_intf *hw_intf = hw_mgr->devices[dev_type][dev_idx];
+
+	if (!hw_intf->hw_ops.reset) {
+		CAM_ERR(CAM_JPEG, "op reset null ");
+		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_INVLD_CMD;
+		return -EFAULT;
+	}
+	rc = hw_intf->hw_ops.reset(hw_intf->hw_priv, NULL, 0);
+	if (rc) {
+		CAM_ERR(CAM_JPEG, "jpeg hw reset failed %d", rc);
+		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_HW_RESET_FAILED;
+		return rc;
+	}
+
 	rc = cam_cdm_submit_bls(
-		hw_mgr->cdm_info[dev_type][0].cdm_handle,
-		cdm_cmd);
+		hw_mgr->cdm_info[dev_type][dev_idx].cdm_handle,
+		p_cfg_req->cdm_cmd);
 	if (rc) {
 		CAM_ERR(CAM_JPEG, "Failed to apply the configs %d", rc);
 		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_CDM_CONFIG_ERR;
-		goto end_error;
+		return rc;
 	}
 
-	if (!hw_mgr->devices[dev_type][0]->hw_ops.start) {
+	if (!hw_intf->hw_ops.start) {
 		CAM_ERR(CAM_JPEG, "op start null ");
 		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_INVLD_CMD;
-		rc = -EINVAL;
-		goto end_error;
+		return -EINVAL;
 	}
 
-	CAM_TRACE(CAM_JPEG, "Start JPEG ENC Req %llu", config_args->request_id);
+	CAM_TRACE(CAM_JPEG, "Start JPEG ENC Req %llu dev %u",
+		p_cfg_req->hw_cfg_args.request_id, dev_idx);
 
 	if (g_jpeg_hw_mgr.camnoc_misr_test) {
 		/* configure jpeg hw and camnoc misr */
-		rc = hw_mgr->devices[dev_type][0]->hw_ops.process_cmd(
-			hw_mgr->devices[dev_type][0]->hw_priv,
+		rc = hw_intf->hw_ops.process_cmd(hw_intf->hw_priv,
 			CAM_JPEG_CMD_CONFIG_HW_MISR,
 			&g_jpeg_hw_mgr.camnoc_misr_test,
 			sizeof(g_jpeg_hw_mgr.camnoc_misr_test));
 		if (rc) {
 			CAM_ERR(CAM_JPEG, "Failed to apply the configs %d", rc);
-			goto end_error;
+			buf_data->evt_param = CAM_SYNC_JPEG_EVENT_START_HW_ERR;
+			return rc;
 		}
 	}
 
-	rc = hw_mgr->devices[dev_type][0]->hw_ops.start(
-		hw_mgr->devices[dev_type][0]->hw_priv, NULL, 0);
+	rc = hw_intf->hw_ops.start(hw_intf->hw_priv, NULL, 0);
 	if (rc) {
 		CAM_ERR(CAM_JPEG, "Failed to apply the configs %d",
 			rc);
 		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_START_HW_ERR;
-		goto end_error;
+		return rc;
 	}
 
 	return 0;
-end_error:
-	return rc;
+}
+
+static int cam_jpeg_process_next_hw_update(struct cam_jpeg_hw_mgr *hw_mgr,
+	struct cam_jpeg_hw_cfg_req *p_cfg_req,
+	struct cam_hw_done_event_data *buf_data)
+{
+	int rc;
+
+	rc = cam_jpeg_mgr_build_hw_update(hw_mgr, p_cfg_req, buf_data);
+	if (rc)
+		return rc;
+
+	return cam_jpeg_mgr_start_hw_update(hw_mgr, p_cfg_req, buf_data);
+}
+
+static void cam_jpeg_mgr_kick_dispatch(struct cam_jpeg_hw_mgr *hw_mgr)
+{
+	int rc;
+	struct crm_workq_task *task;
+	struct cam_jpeg_process_frame_work_data_t *wq_task_data;
+
+	/*
+	 * Every task of this workq runs the dispatcher, so with no free task
+	 * one is already queued that will pick up the pending requests.
+	 */
+	task = cam_req_mgr_workq_get_task(hw_mgr->work_process_frame);
+	if (!task) {
+		CAM_DBG(CAM_JPEG, "dispatch already pending");
+		return;
+	}
+
+	wq_task_data = (struct cam_jpeg_process_frame_work_data_t *)
+		task->payload;
+	wq_task_data->data = NULL;
+	wq_task_data->request_id = 0;
+	wq_task_data->type = CAM_JPEG_WORKQ_TASK_CMD_TYPE;
+	task->process_cb = cam_jpeg_mgr_process_cmd;
+	rc = cam_req_mgr_workq_enqueue_task(task, hw_mgr,
+		CRM_TASK_PRIORITY_0);
+	if (rc)
+		CAM_ERR(CAM_JPEG, "could not enque task %d", rc);
+}
+
+static void cam_jpeg_mgr_release_dev(struct cam_jpeg_hw_mgr *hw_mgr,
+	uint32_t dev_type, uint32_t dev_idx)
+{
+	int rc;
+	struct cam_jpeg_set_irq_cb irq_cb;
+	struct cam_hw_intf *hw_intf = hw_mgr->devices[dev_type][dev_idx];
+
+	irq_cb.jpeg_hw_mgr_cb = cam_jpeg_hw_mgr_cb;
+	irq_cb.data = NULL;
+	irq_cb.b_set_cb = false;
+	if (hw_intf->hw_ops.process_cmd) {
+		rc = hw_intf->hw_ops.process_cmd(hw_intf->hw_priv,
+			CAM_JPEG_CMD_SET_IRQ_CB,
+			&irq_cb, sizeof(irq_cb));
+		if (rc)
+			CAM_ERR(CAM_JPEG, "CMD_SET_IRQ_CB failed %d", rc);
+	} else {
+		CAM_ERR(CAM_JPEG, "process_cmd null ");
+	}
+
+	if (hw_intf->hw_ops.deinit) {
+		rc = hw_intf->hw_ops.deinit(hw_intf->hw_priv, NULL, 0);
+		if (rc)
+			CAM_ERR(CAM_JPEG, "Failed to Deinit %u:%u HW",
+				dev_type, dev_idx);
+	}
+
+	hw_mgr->device_in_use[dev_type][dev_idx] = false;
+	hw_mgr->dev_hw_cfg_args[dev_type][dev_idx] = NULL;
+}
+
+static int cam_jpeg_mgr_start_dev(struct cam_jpeg_hw_mgr *hw_mgr,
+	struct cam_jpeg_hw_cfg_req *p_cfg_req,
+	struct cam_hw_done_event_data *buf_data)
+{
+	int rc;
+	uint64_t queue_ns;
+	struct cam_jpeg_set_irq_cb irq_cb;
+	struct cam_hw_intf *hw_intf =
+		hw_mgr->devices[p_cfg_req->dev_type][p_cfg_req->dev_idx];
+
+	irq_cb.jpeg_hw_mgr_cb = cam_jpeg_hw_mgr_cb;
+	irq_cb.data = (void *)p_cfg_req;
+	irq_cb.b_set_cb = true;
+	if (!hw_intf->hw_ops.process_cmd) {
+		CAM_ERR(CAM_JPEG, "op process_cmd null ");
+		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_INVLD_CMD;
+		return -EFAULT;
+	}
+	rc = hw_intf->hw_ops.process_cmd(hw_intf->hw_priv,
+		CAM_JPEG_CMD_SET_IRQ_CB,
+		&irq_cb, sizeof(irq_cb));
+	if (rc) {
+		CAM_ERR(CAM_JPEG, "SET_IRQ_CB failed %d", rc);
+		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_SET_IRQ_CB;
+		return rc;
+	}
+
+	rc = cam_jpeg_mgr_start_hw_update(hw_mgr, p_cfg_req, buf_data);
+	if (rc) {
+		CAM_ERR(CAM_JPEG, "next hw update failed %d", rc);
+		return rc;
+	}
+
+	p_cfg_req->submit_timestamp = ktime_get();
+	queue_ns = ktime_to_ns(ktime_sub(p_cfg_req->submit_timestamp,
+		p_cfg_req->enqueue_timestamp));
+	hw_mgr->stats.total_queue_ns += queue_ns;
+	if (queue_ns > hw_mgr->stats.max_queue_ns)
+		hw_mgr->stats.max_queue_ns = queue_ns;
+
+	return 0;
+}
+
+static void cam_jpeg_mgr_notify_err(struct cam_jpeg_hw_mgr *hw_mgr,
+	struct cam_jpeg_hw_cfg_req *p_cfg_req,
+	struct cam_hw_done_event_data *buf_data)
+{
+	int i;
+	struct cam_hw_config_args *hw_cfg_args = &p_cfg_req->hw_cfg_args;
+	struct cam_jpeg_hw_ctx_data *ctx_data =
+		(struct cam_jpeg_hw_ctx_data *)hw_cfg_args->ctxt_to_hw_map;
+
+	buf_data->num_handles = hw_cfg_args->num_out_map_entries;
+	for (i = 0; i < buf_data->num_handles; i++) {
+		buf_data->resource_handle[i] =
+			hw_cfg_args->out_map_entries[i].resource_handle;
+	}
+	buf_data->request_id = (uintptr_t)hw_cfg_args->priv;
+	ctx_data->ctxt_event_cb(ctx_data->context_priv,
+		CAM_CTX_EVT_ID_ERROR, buf_data);
+
+	mutex_lock(&hw_mgr->hw_mgr_mutex);
+	list_add_tail(&p_cfg_req->list, &hw_mgr->free_req_list);
+	mutex_unlock(&hw_mgr->hw_mgr_mutex);
 }
 
 static int cam_jpeg_mgr_process_irq(void *priv, void *data)
 {
-	int rc = 0;
+	int rc = 0, next_rc = 0;
 	int mem_hdl = 0;
 	struct cam_jpeg_process_irq_work_data_t *task_data;
 	struct cam_jpeg_hw_mgr *hw_mgr;
 	int32_t i;
 	struct cam_jpeg_hw_ctx_data *ctx_data = NULL;
 	struct cam_hw_done_event_data buf_data;
-	struct cam_jpeg_set_irq_cb irq_cb;
-	uintptr_t dev_type = 0;
+	struct cam_hw_done_event_data next_buf_data;
+	uint32_t dev_type, dev_idx;
 	uintptr_t kaddr;
 	uint32_t *cmd_buf_kaddr;
 	size_t cmd_buf_len;
+	uint64_t hw_ns;
 	struct cam_jpeg_config_inout_param_info *p_params;
 	struct cam_jpeg_hw_cfg_req *p_cfg_req = NULL;
-	struct crm_workq_task *task;
-	struct cam_jpeg_process_frame_work_data_t *wq_task_data;
+	struct cam_jpeg_hw_cfg_req *p_next_req = NULL;
 	struct cam_jpeg_misr_dump_args misr_args;
+	struct cam_hw_intf *hw_intf;
+	bool built = false;
 
 	if (!data || !priv) {
 		CAM_ERR(CAM_JPEG, "Invalid data");
@@ -198,25 +335,33 @@ static int cam_jpeg_mgr_process_irq(void *priv, void *data)
 	task_data = data;
 	hw_mgr = &g_jpeg_hw_mgr;
 
-	ctx_data = (struct cam_jpeg_hw_ctx_data *)task_data->data;
-	if (!ctx_data->in_use) {
-		CAM_ERR(CAM_JPEG, "ctx is not in use");
+	p_cfg_req = (struct cam_jpeg_hw_cfg_req *)task_data->data;
+	if (!p_cfg_req) {
+		CAM_ERR(CAM_JPEG, "irq without request");
 		return -EINVAL;
 	}
 
-	dev_type = ctx_data->jpeg_dev_acquire_info.dev_type;
-
 	mutex_lock(&g_jpeg_hw_mgr.hw_mgr_mutex);
 
-	p_cfg_req = hw_mgr->dev_hw_cfg_args[dev_type][0];
+	dev_type = p_cfg_req->dev_type;
+	dev_idx = p_cfg_req->dev_idx;
+	if (hw_mgr->device_in_use[dev_type][dev_idx] == false ||
+		hw_mgr->dev_hw_cfg_args[dev_type][dev_idx] != p_cfg_req) {
+		CAM_ERR(CAM_JPEG, "irq for old request on dev %u:%u",
+			dev_type, dev_idx);
+		mutex_unlock(&g_jpeg_hw_mgr.hw_mgr_mutex);
+		return -EINVAL;
+	}
 
-	if (hw_mgr->device_in_use[dev_type][0] == false ||
-		p_cfg_req == NULL) {
-		CAM_ERR(CAM_JPEG, "irq for old request %d", rc);
+	ctx_data = (struct cam_jpeg_hw_ctx_data *)
+		p_cfg_req->hw_cfg_args.ctxt_to_hw_map;
+	if (!ctx_data->in_use) {
+		CAM_ERR(CAM_JPEG, "ctx is not in use");
 		mutex_unlock(&g_jpeg_hw_mgr.hw_mgr_mutex);
 		return -EINVAL;
 	}
 
+	hw_intf = hw_mgr->devices[dev_type][dev_idx];
 	p_cfg_req->num_hw_entry_processed++;
 	CAM_DBG(CAM_JPEG, "hw entry processed %d Encoded size :%d",
 		p_cfg_req->num_hw_entry_processed, task_data->result_size);
@@ -228,8 +373,7 @@ static int cam_jpeg_mgr_process_irq(void *priv, void *data)
 			misr_args.req_id, misr_args.enable_bug);
 
 		/* dump jpeg hw and camnoc misr */
-		rc = hw_mgr->devices[dev_type][0]->hw_ops.process_cmd(
-			hw_mgr->devices[dev_type][0]->hw_priv,
+		rc = hw_intf->hw_ops.process_cmd(hw_intf->hw_priv,
 			CAM_JPEG_CMD_DUMP_HW_MISR_VAL, &misr_args,
 			sizeof(struct cam_jpeg_misr_dump_args));
 	}
@@ -238,7 +382,7 @@ static int cam_jpeg_mgr_process_irq(void *priv, void *data)
 		(p_cfg_req->num_hw_entry_processed <
 			p_cfg_req->hw_cfg_args.num_hw_update_entries - 2)) {
 		/* start processing next entry before marking device free */
-		rc  = cam_jpeg_process_next_hw_update(priv, ctx_data,
+		rc  = cam_jpeg_process_next_hw_update(hw_mgr, p_cfg_req,
 			&buf_data);
 		if (!rc) {
 			mutex_unlock(&g_jpeg_hw_mgr.hw_mgr_mutex);
@@ -246,58 +390,47 @@ static int cam_jpeg_mgr_process_irq(void *priv, void *data)
 		}
 	}
 
-	irq_cb.jpeg_hw_mgr_cb = cam_jpeg_hw_mgr_cb;
-	irq_cb.data = NULL;
-	irq_cb.b_set_cb = false;
-	if (!hw_mgr->devices[dev_type][0]->hw_ops.process_cmd) {
-		CAM_ERR(CAM_JPEG, "process_cmd null ");
-		mutex_unlock(&g_jpeg_hw_mgr.hw_mgr_mutex);
-		return -EINVAL;
-	}
-	rc = hw_mgr->devices[dev_type][0]->hw_ops.process_cmd(
-		hw_mgr->devices[dev_type][0]->hw_priv,
-		CAM_JPEG_CMD_SET_IRQ_CB,
-		&irq_cb, sizeof(irq_cb));
-	if (rc) {
-		CAM_ERR(CAM_JPEG, "CMD_SET_IRQ_CB failed %d", rc);
-		mutex_unlock(&g_jpeg_hw_mgr.hw_mgr_mutex);
-		return rc;
-	}
-
-	if (hw_mgr->devices[dev_type][0]->hw_ops.deinit) {
-		rc = hw_mgr->devices[dev_type][0]->hw_ops.deinit(
-			hw_mgr->devices[dev_type][0]->hw_priv, NULL, 0);
-		if (rc)
-			CAM_ERR(CAM_JPEG, "Failed to Deinit %lu HW", dev_type);
+	hw_ns = ktime_to_ns(ktime_sub(ktime_get(),
+		p_cfg_req->submit_timestamp));
+	hw_mgr->stats.num_req++;
+	hw_mgr->stats.num_dev_req[dev_type][dev_idx]++;
+	hw_mgr->stats.total_hw_ns += hw_ns;
+	if (hw_ns > hw_mgr->stats.max_hw_ns)
+		hw_mgr->stats.max_hw_ns = hw_ns;
+
+	/*
+	 * Start the next request on this core right away and keep the core
+	 * powered instead of going through deinit, the command workq and
+	 * init again.
+	 */
+	p_next_req = cam_jpeg_mgr_get_next_req(hw_mgr, dev_type, dev_idx,
+		&built);
+	if (p_next_req) {
+		hw_mgr->dev_hw_cfg_args[dev_type][dev_idx] = p_next_req;
+		if (!built) {
+			p_next_req->dev_idx = dev_idx;
+			next_rc = cam_jpeg_mgr_build_hw_update(hw_mgr,
+				p_next_req, &next_buf_data);
+		}
+		if (!next_rc)
+			next_rc = cam_jpeg_mgr_start_dev(hw_mgr, p_next_req,
+				&next_buf_data);
+		if (next_rc) {
+			CAM_ERR(CAM_JPEG, "next req %zu start failed %d",
+				p_next_req->req_id, next_rc);
+			cam_jpeg_mgr_release_dev(hw_mgr, dev_type, dev_idx);
+		} else if (built) {
+			hw_mgr->stats.num_prefetch++;
+		}
+	} else {
+		cam_jpeg_mgr_release_dev(hw_mgr, dev_type, dev_idx);
 	}
-
-	hw_mgr->device_in_use[dev_type][0] = false;
-	hw_mgr->dev_hw_cfg_args[dev_type][0] = NULL;
 	mutex_unlock(&g_jpeg_hw_mgr.hw_mgr_mutex);
 
-	task = cam_req_mgr_workq_get_task(
-		g_jpeg_hw_mgr.work_process_frame);
-	if (!task) {
-		CAM_ERR(CAM_JPEG, "no empty task");
-		return -EINVAL;
-	}
+	cam_jpeg_mgr_dispatch_pending(hw_mgr);
 
-	wq_task_data = (struct cam_jpeg_process_frame_work_data_t *)
-		task->payload;
-	if (!task_data) {
-		CAM_ERR(CAM_JPEG, "task_data is NULL");
-		return -EINVAL;
-	}
-	wq_task_data->data = (void *)dev_type;
-	wq_task_data->request_id = 0;
-	wq_task_data->type = CAM_JPEG_WORKQ_TASK_CMD_TYPE;
-	task->process_cb = cam_jpeg_mgr_process_cmd;
-	rc = cam_req_mgr_workq_enqueue_task(task, &g_jpeg_hw_mgr,
-		CRM_TASK_PRIORITY_0);
-	if (rc) {
-		CAM_ERR(CAM_JPEG, "could not enque task %d", rc);
-		return rc;
-	}
+	if (p_next_req && next_rc)
+		cam_jpeg_mgr_notify_err(hw_mgr, p_next_req, &next_buf_data);
 
 	mem_hdl =
 		p_cfg_req->hw_cfg_args.hw_update_entries[CAM_JPEG_PARAM].handle;
@@ -344,85 +477,13 @@ static int cam_jpeg_mgr_process_irq(void *priv, void *data)
 	return rc;
 }
 
-static int cam_jpeg_hw_mgr_cb(
-	uint32_t irq_status, int32_t result_size, void *data)
-{
-	int32_t rc;
-	unsigned long flags;
-	struct cam_jpeg_hw_mgr *hw_mgr = &g_jpeg_hw_mgr;
-	struct crm_workq_task *task;
-	struct cam_jpeg_process_irq_work_data_t *task_data;
-
-	spin_lock_irqsave(&hw_mgr->hw_mgr_lock, flags);
-	task = cam_req_mgr_workq_get_task(
-		g_jpeg_hw_mgr.work_process_irq_cb);
-	if (!task) {
-		CAM_ERR(CAM_JPEG, "no empty task");
-		spin_unlock_irqrestore(&hw_mgr->hw_mgr_lock, flags);
-		return -ENOMEM;
-	}
-
-	task_data = (struct cam_jpeg_process_irq_work_data_t *)task->payload;
-	task_data->data = data;
-	task_data->irq_status = irq_status;
-	task_data->result_size = result_size;
-	task_data->type = CAM_JPEG_WORKQ_TASK_MSG_TYPE;
-	task->process_cb = cam_jpeg_mgr_process_irq;
-
-	rc = cam_req_mgr_workq_enqueue_task(task, &g_jpeg_hw_mgr,
-		CRM_TASK_PRIORITY_0);
-	spin_unlock_irqrestore(&hw_mgr->hw_mgr_lock, flags);
-
-	return rc;
-}
-
-static int cam_jpeg_mgr_get_free_ctx(struct cam_jpeg_hw_mgr *hw_mgr)
-{
-	int i = 0;
-	int num_ctx = CAM_JPEG_CTX_MAX;
-
-	for (i = 0; i < num_ctx; i++) {
-		mutex_lock(&hw_mgr->ctx_data[i].ctx_mutex);
-		if (hw_mgr->ctx_data[i].in_use == false) {
-			hw_mgr->ctx_data[i].in_use = true;
-			mutex_unlock(&hw_mgr->ctx_data[i].ctx_mutex);
-			break;
-		}
-		mutex_unlock(&hw_mgr->ctx_data[i].ctx_mutex);
-	}
-
-	return i;
-}
-
-
-static int cam_jpeg_mgr_release_ctx(
-	struct cam_jpeg_hw_mgr *hw_mgr, struct cam_jpeg_hw_ctx_data *ctx_data)
-{
-	if (!ctx_data) {
-		CAM_ERR(CAM_JPEG, "invalid ctx_data %pK", ctx_data);
-		return -EINVAL;
-	}
-
-	mutex_lock(&ctx_data->ctx_mutex);
-	if (!ctx_data->in_use) {
-		CAM_ERR(CAM_JPEG, "ctx is already un-used: %pK", ctx_data);
-		mutex_unlock(&ctx_data->ctx_mutex);
-		return -EINVAL;
-	}
-
-	ctx_data->in_use = false;
-	mutex_unlock(&ctx_data->ctx_mutex);
-
-	return 0;
-}
-
 static int cam_jpeg_insert_cdm_change_base(
-	struct cam_hw_config_args *config_args,
-	struct cam_jpeg_hw_ctx_data *ctx_data,
+	struct cam_jpeg_hw_cfg_req *p_cfg_req,
 	struct cam_jpeg_hw_mgr *hw_mgr)
 {
 	int rc = 0;
-	uint32_t dev_type;
+	uint32_t dev_type, dev_idx;
+	struct cam_hw_config_args *config_args;
 	struct cam_cdm_bl_request *cdm_cmd;
 	uint32_t size;
 	uint32_t mem_cam_base;
@@ -430,6 +491,7 @@ static int cam_jpeg_insert_cdm_change_base(
 	uint32_t *ch_base_iova_addr;
 	size_t ch_base_len;
 
+	config_args = &p_cfg_req->hw_cfg_args;
 	rc = cam_mem_get_cpu_buf(
 		config_args->hw_update_entries[CAM_JPEG_CHBASE].handle,
 		&iova_addr, &ch_base_len);
@@ -456,14 +518,15 @@ static int cam_jpeg_insert_cdm_change_base(
 		(config_args->hw_update_entries[CAM_JPEG_CHBASE].offset /
 		sizeof(uint32_t)));
 
-	dev_type = ctx_data->jpeg_dev_acquire_info.dev_type;
-	mem_cam_base = hw_mgr->cdm_reg_map[dev_type][0]->mem_cam_base;
-	size =
-	hw_mgr->cdm_info[dev_type][0].cdm_ops->cdm_required_size_changebase();
-	hw_mgr->cdm_info[dev_type][0].cdm_ops->cdm_write_changebase(
+	dev_type = p_cfg_req->dev_type;
+	dev_idx = p_cfg_req->dev_idx;
+	mem_cam_base = hw_mgr->cdm_reg_map[dev_type][dev_idx]->mem_cam_base;
+	size = hw_mgr->cdm_info[dev_type][dev_idx].cdm_ops->
+		cdm_required_size_changebase();
+	hw_mgr->cdm_info[dev_type][dev_idx].cdm_ops->cdm_write_changebase(
 		ch_base_iova_addr, mem_cam_base);
 
-	cdm_cmd = ctx_data->cdm_cmd;
+	cdm_cmd = p_cfg_req->cdm_cmd;
 	cdm_cmd->cmd[cdm_cmd->cmd_arrary_count].bl_addr.mem_handle =
 		config_args->hw_update_entries[CAM_JPEG_CHBASE].handle;
 	cdm_cmd->cmd[cdm_cmd->cmd_arrary_count].offset =
@@ -483,149 +546,214 @@ static int cam_jpeg_insert_cdm_change_base(
 	return rc;
 }
 
-static int cam_jpeg_mgr_process_cmd(void *priv, void *data)
+/*
+ * Pick the least loaded core of a device type. An idle core starts the
+ * request right away, a busy core with a free prefetch slot takes it as
+ * the next request to run.
+ */
+static int cam_jpeg_mgr_get_free_dev(struct cam_jpeg_hw_mgr *hw_mgr,
+	uint32_t dev_type, bool *prefetch)
 {
-	int rc;
-	int i = 0;
-	struct cam_jpeg_hw_mgr *hw_mgr = priv;
-	struct cam_hw_config_args *config_args = NULL;
-	struct cam_jpeg_hw_ctx_data *ctx_data = NULL;
-	uintptr_t request_id = 0;
-	struct cam_jpeg_process_frame_work_data_t *task_data =
-		(struct cam_jpeg_process_frame_work_data_t *)data;
-	uint32_t dev_type;
-	struct cam_jpeg_set_irq_cb irq_cb;
-	struct cam_jpeg_hw_cfg_req *p_cfg_req = NULL;
-	struct cam_hw_done_event_data buf_data;
-	struct cam_hw_config_args *hw_cfg_args = NULL;
+	int i, dev_idx = -EBUSY;
+	uint32_t load, min_load = 2;
+
+	for (i = 0; i < hw_mgr->num_dev[dev_type]; i++) {
+		load = (hw_mgr->device_in_use[dev_type][i] ? 1 : 0) +
+			(hw_mgr->dev_next_cfg_args[dev_type][i] ? 1 : 0);
+		if (load < min_load) {
+			min_load = load;
+			dev_idx = i;
+		}
+	}
 
-	if (!hw_mgr || !task_data) {
-		CAM_ERR(CAM_JPEG, "Invalid arguments %pK %pK",
-			hw_mgr, task_data);
-		return -EINVAL;
+	if (dev_idx >= 0)
+		*prefetch = (min_load > 0);
+
+	return dev_idx;
+}
+
+static struct cam_jpeg_hw_cfg_req *cam_jpeg_mgr_dequeue_req(
+	struct cam_jpeg_hw_mgr *hw_mgr, uint32_t *dev_idx, bool *prefetch)
+{
+	int idx;
+	struct cam_jpeg_hw_cfg_req *p_cfg_req;
+
+	/*
+	 * Requests of a device type keep their order, but a busy type does
+	 * not hold back requests of the other type queued behind it.
+	 */
+	list_for_each_entry(p_cfg_req, &hw_mgr->hw_config_req_list, list) {
+		idx = cam_jpeg_mgr_get_free_dev(hw_mgr, p_cfg_req->dev_type,
+			prefetch);
+		if (idx < 0)
+			continue;
+
+		list_del_init(&p_cfg_req->list);
+		hw_mgr->stats.queue_depth--;
+		*dev_idx = idx;
+		return p_cfg_req;
 	}
 
-	mutex_lock(&hw_mgr->hw_mgr_mutex);
+	return NULL;
+}
 
-	if (list_empty(&hw_mgr->hw_config_req_list)) {
-		CAM_DBG(CAM_JPEG, "no available request");
-		rc = -EFAULT;
-		goto end;
+/*
+ * Next request for a core that just finished: its own prefetched request,
+ * else one prefetched on another core of the same type that has not
+ * started yet, else the oldest queued request of the type. @built tells
+ * whether the BLs were already built for this core.
+ */
+static struct cam_jpeg_hw_cfg_req *cam_jpeg_mgr_get_next_req(
+	struct cam_jpeg_hw_mgr *hw_mgr, uint32_t dev_type, uint32_t dev_idx,
+	bool *built)
+{
+	int i;
+	struct cam_jpeg_hw_cfg_req *p_cfg_req, *req_temp;
+	struct cam_jpeg_hw_ctx_data *ctx_data;
+
+	*built = false;
+	p_cfg_req = hw_mgr->dev_next_cfg_args[dev_type][dev_idx];
+	if (p_cfg_req) {
+		hw_mgr->dev_next_cfg_args[dev_type][dev_idx] = NULL;
+		*built = true;
+		return p_cfg_req;
 	}
 
-	p_cfg_req = list_first_entry(&hw_mgr->hw_config_req_list,
-		struct cam_jpeg_hw_cfg_req, list);
-	if (!p_cfg_req) {
-		CAM_ERR(CAM_JPEG, "no request");
-		rc = -EFAULT;
-		goto end;
+	for (i = 0; i < hw_mgr->num_dev[dev_type]; i++) {
+		p_cfg_req = hw_mgr->dev_next_cfg_args[dev_type][i];
+		if (!p_cfg_req)
+			continue;
+
+		CAM_DBG(CAM_JPEG, "req %zu moved from dev %u:%d to %u",
+			p_cfg_req->req_id, dev_type, i, dev_idx);
+		hw_mgr->dev_next_cfg_args[dev_type][i] = NULL;
+		return p_cfg_req;
 	}
 
-	if (false == hw_mgr->device_in_use[p_cfg_req->dev_type][0]) {
-		hw_mgr->device_in_use[p_cfg_req->dev_type][0] = true;
-		hw_mgr->dev_hw_cfg_args[p_cfg_req->dev_type][0] = p_cfg_req;
+	list_for_each_entry_safe(p_cfg_req, req_temp,
+		&hw_mgr->hw_config_req_list, list) {
+		if (p_cfg_req->dev_type != dev_type)
+			continue;
+
 		list_del_init(&p_cfg_req->list);
-	} else {
-		CAM_DBG(CAM_JPEG, "Not dequeing, just return");
-		rc = -EFAULT;
-		goto end;
-	}
+		hw_mgr->stats.queue_depth--;
+		ctx_data = (struct cam_jpeg_hw_ctx_data *)
+			p_cfg_req->hw_cfg_args.ctxt_to_hw_map;
+		if (!ctx_data->in_use) {
+			CAM_ERR(CAM_JPEG, "ctx is not in use");
+			list_add_tail(&p_cfg_req->list,
+				&hw_mgr->free_req_list);
+			continue;
+		}
 
-	config_args = (struct cam_hw_config_args *)&p_cfg_req->hw_cfg_args;
-	request_id = task_data->request_id;
-	if (request_id != (uintptr_t)config_args->priv) {
-		CAM_DBG(CAM_JPEG, "not a recent req %zd %zd",
-			request_id, (uintptr_t)config_args->priv);
+		return p_cfg_req;
 	}
 
-	if (!config_args->num_hw_update_entries) {
-		CAM_ERR(CAM_JPEG, "No hw update enteries are available");
-		mutex_unlock(&hw_mgr->hw_mgr_mutex);
-		rc = -EINVAL;
-		goto end_unusedev;
-	}
+	return NULL;
+}
 
-	ctx_data = (struct cam_jpeg_hw_ctx_data *)config_args->ctxt_to_hw_map;
-	if (!ctx_data->in_use) {
-		CAM_ERR(CAM_JPEG, "ctx is not in use");
-		mutex_unlock(&hw_mgr->hw_mgr_mutex);
-		rc = -EINVAL;
-		goto end_unusedev;
-	}
+static int cam_jpeg_mgr_dispatch_req(struct cam_jpeg_hw_mgr *hw_mgr,
+	struct cam_jpeg_hw_cfg_req *p_cfg_req, uint32_t dev_idx,
+	bool prefetch, struct cam_hw_done_event_data *buf_data)
+{
+	int rc;
+	uint32_t dev_type = p_cfg_req->dev_type;
+	struct cam_hw_intf *hw_intf = hw_mgr->devices[dev_type][dev_idx];
+	struct cam_jpeg_hw_ctx_data *ctx_data =
+		(struct cam_jpeg_hw_ctx_data *)
+		p_cfg_req->hw_cfg_args.ctxt_to_hw_map;
 
-	dev_type = ctx_data->jpeg_dev_acquire_info.dev_type;
+	p_cfg_req->dev_idx = dev_idx;
+
+	/* insert one of the cdm payloads */
+	rc = cam_jpeg_mgr_build_hw_update(hw_mgr, p_cfg_req, buf_data);
+	if (rc)
+		return rc;
 
-	if (dev_type != p_cfg_req->dev_type)
-		CAM_WARN(CAM_JPEG, "dev types not same something wrong");
+	if (prefetch) {
+		CAM_DBG(CAM_JPEG, "req %zu prefetched on dev %u:%u",
+			p_cfg_req->req_id, dev_type, dev_idx);
+		hw_mgr->dev_next_cfg_args[dev_type][dev_idx] = p_cfg_req;
+		return 0;
+	}
 
-	if (!hw_mgr->devices[dev_type][0]->hw_ops.init) {
+	if (!hw_intf->hw_ops.init) {
 		CAM_ERR(CAM_JPEG, "hw op init null ");
-		rc = -EFAULT;
-		goto end;
+		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_INVLD_CMD;
+		return -EFAULT;
 	}
-	rc = hw_mgr->devices[dev_type][0]->hw_ops.init(
-		hw_mgr->devices[dev_type][0]->hw_priv,
+	rc = hw_intf->hw_ops.init(hw_intf->hw_priv,
 		ctx_data,
 		sizeof(ctx_data));
 	if (rc) {
-		CAM_ERR(CAM_JPEG, "Failed to Init %d HW", dev_type);
-		goto end;
-	}
-
-	irq_cb.jpeg_hw_mgr_cb = cam_jpeg_hw_mgr_cb;
-	irq_cb.data = (void *)ctx_data;
-	irq_cb.b_set_cb = true;
-	if (!hw_mgr->devices[dev_type][0]->hw_ops.process_cmd) {
-		CAM_ERR(CAM_JPEG, "op process_cmd null ");
-		buf_data.evt_param = CAM_SYNC_JPEG_EVENT_INVLD_CMD;
-		rc = -EFAULT;
-		goto end_callcb;
-	}
-	rc = hw_mgr->devices[dev_type][0]->hw_ops.process_cmd(
-		hw_mgr->devices[dev_type][0]->hw_priv,
-		CAM_JPEG_CMD_SET_IRQ_CB,
-		&irq_cb, sizeof(irq_cb));
-	if (rc) {
-		CAM_ERR(CAM_JPEG, "SET_IRQ_CB failed %d", rc);
-		buf_data.evt_param = CAM_SYNC_JPEG_EVENT_SET_IRQ_CB;
-		goto end_callcb;
+		CAM_ERR(CAM_JPEG, "Failed to Init %u:%u HW",
+			dev_type, dev_idx);
+		buf_data->evt_param = CAM_SYNC_JPEG_EVENT_START_HW_ERR;
+		return rc;
 	}
 
-	/* insert one of the cdm payloads */
-	rc = cam_jpeg_process_next_hw_update(priv, ctx_data, &buf_data);
-	if (rc) {
-		CAM_ERR(CAM_JPEG, "next hw update failed %d", rc);
-		goto end_callcb;
-	}
+	hw_mgr->device_in_use[dev_type][dev_idx] = true;
+	hw_mgr->dev_hw_cfg_args[dev_type][dev_idx] = p_cfg_req;
 
-	p_cfg_req->submit_timestamp = ktime_get();
+	rc = cam_jpeg_mgr_start_dev(hw_mgr, p_cfg_req, buf_data);
+	if (rc)
+		cam_jpeg_mgr_release_dev(hw_mgr, dev_type, dev_idx);
 
-	mutex_unlock(&hw_mgr->hw_mgr_mutex);
 	return rc;
+}
 
-end_callcb:
-	mutex_unlock(&hw_mgr->hw_mgr_mutex);
-	if (p_cfg_req) {
-		hw_cfg_args = &p_cfg_req->hw_cfg_args;
-		buf_data.num_handles =
-			hw_cfg_args->num_out_map_entries;
-		for (i = 0; i < buf_data.num_handles; i++) {
-			buf_data.resource_handle[i] =
-			hw_cfg_args->out_map_entries[i].resource_handle;
+static void cam_jpeg_mgr_dispatch_pending(struct cam_jpeg_hw_mgr *hw_mgr)
+{
+	int rc;
+	uint32_t dev_idx;
+	bool prefetch;
+	struct cam_jpeg_hw_ctx_data *ctx_data = NULL;
+	struct cam_jpeg_hw_cfg_req *p_cfg_req = NULL;
+	struct cam_hw_done_event_data buf_data;
+
+	mutex_lock(&hw_mgr->hw_mgr_mutex);
+
+	while ((p_cfg_req = cam_jpeg_mgr_dequeue_req(hw_mgr, &dev_idx,
+		&prefetch))) {
+		ctx_data = (struct cam_jpeg_hw_ctx_data *)
+			p_cfg_req->hw_cfg_args.ctxt_to_hw_map;
+		if (!ctx_data->in_use) {
+			CAM_ERR(CAM_JPEG, "ctx is not in use");
+			list_add_tail(&p_cfg_req->list,
+				&hw_mgr->free_req_list);
+			continue;
 		}
-		buf_data.request_id =
-			(uintptr_t)p_cfg_req->hw_cfg_args.priv;
-		ctx_data->ctxt_event_cb(ctx_data->context_priv,
-			CAM_CTX_EVT_ID_ERROR, &buf_data);
+
+		rc = cam_jpeg_mgr_dispatch_req(hw_mgr, p_cfg_req, dev_idx,
+			prefetch, &buf_data);
+		if (!rc)
+			continue;
+
+		CAM_ERR(CAM_JPEG, "dispatch of req %zu failed %d",
+			p_cfg_req->req_id, rc);
+		mutex_unlock(&hw_mgr->hw_mgr_mutex);
+		cam_jpeg_mgr_notify_err(hw_mgr, p_cfg_req, &buf_data);
+		mutex_lock(&hw_mgr->hw_mgr_mutex);
 	}
-end_unusedev:
-	mutex_lock(&hw_mgr->hw_mgr_mutex);
-	hw_mgr->device_in_use[p_cfg_req->dev_type][0] = false;
-	hw_mgr->dev_hw_cfg_args[p_cfg_req->dev_type][0] = NULL;
 
-end:
 	mutex_unlock(&hw_mgr->hw_mgr_mutex);
-	return rc;
+}
+
+static int cam_jpeg_mgr_process_cmd(void *priv, void *data)
+{
+	struct cam_jpeg_hw_mgr *hw_mgr = priv;
+	struct cam_jpeg_process_frame_work_data_t *task_data =
+		(struct cam_jpeg_process_frame_work_data_t *)data;
+
+	if (!hw_mgr || !task_data) {
+		CAM_ERR(CAM_JPEG, "Invalid arguments %pK %pK",
+			hw_mgr, task_data);
+		return -EINVAL;
+	}
+
+	cam_jpeg_mgr_dispatch_pending(hw_mgr);
+
+	return 0;
 }
 
 static int cam_jpeg_mgr_config_hw(void *hw_mgr_priv, void *config_hw_args)
@@ -639,6 +767,7 @@ static int cam_jpeg_mgr_config_hw(void *hw_mgr_priv, void *config_hw_args)
 	struct crm_workq_task *task;
 	struct cam_jpeg_process_frame_work_data_t *task_data;
 	struct cam_jpeg_hw_cfg_req *p_cfg_req = NULL;
+	struct cam_jpeg_hw_cfg_req *cfg_req = NULL;
 
 	if (!hw_mgr || !config_args) {
 		CAM_ERR(CAM_JPEG, "Invalid arguments %pK %pK",
@@ -673,6 +802,7 @@ static int cam_jpeg_mgr_config_hw(void *hw_mgr_priv, void *config_hw_args)
 	/* Update Currently Processing Config Request */
 	p_cfg_req->hw_cfg_args = *config_args;
 	p_cfg_req->dev_type = ctx_data->jpeg_dev_acquire_info.dev_type;
+	p_cfg_req->dev_idx = 0;
 
 	request_id = (uintptr_t)config_args->priv;
 	p_cfg_req->req_id = request_id;
@@ -701,7 +831,11 @@ static int cam_jpeg_mgr_config_hw(void *hw_mgr_priv, void *config_hw_args)
 		p_cfg_req->hw_cfg_args.hw_update_entries,
 		p_cfg_req->hw_cfg_args.num_hw_update_entries);
 
+	p_cfg_req->enqueue_timestamp = ktime_get();
 	list_add_tail(&p_cfg_req->list, &hw_mgr->hw_config_req_list);
+	hw_mgr->stats.queue_depth++;
+	if (hw_mgr->stats.queue_depth > hw_mgr->stats.max_queue_depth)
+		hw_mgr->stats.max_queue_depth = hw_mgr->stats.queue_depth;
 	mutex_unlock(&hw_mgr->hw_mgr_mutex);
 
 	task_data->data = (void *)(uintptr_t)p_cfg_req->dev_type;
@@ -719,7 +853,21 @@ static int cam_jpeg_mgr_config_hw(void *hw_mgr_priv, void *config_hw_args)
 	return rc;
 
 err_after_get_task:
-	list_del_init(&p_cfg_req->list);
+	/* A dispatch kicked by another completion may own it already */
+	mutex_lock(&hw_mgr->hw_mgr_mutex);
+	list_for_each_entry(cfg_req, &hw_mgr->hw_config_req_list, list) {
+		if (cfg_req != p_cfg_req)
+			continue;
+
+		list_del_init(&p_cfg_req->list);
+		hw_mgr->stats.queue_depth--;
+		list_add_tail(&p_cfg_req->list, &hw_mgr->free_req_list);
+		mutex_unlock(&hw_mgr->hw_mgr_mutex);
+		return rc;
+	}
+	mutex_unlock(&hw_mgr->hw_mgr_mutex);
+
+	return 0;
 err_after_dq_free_list:
 	list_add_tail(&p_cfg_req->list, &hw_mgr->free_req_list);
 
@@ -859,18 +1007,18 @@ static int cam_jpeg_mgr_prepare_hw_update(void *hw_mgr_priv,
 }
 
 static void cam_jpeg_mgr_stop_deinit_dev(struct cam_jpeg_hw_mgr *hw_mgr,
-	struct cam_jpeg_hw_cfg_req *p_cfg_req, uint32_t dev_type)
+	uint32_t dev_type, uint32_t dev_idx)
 {
 	int rc = 0;
 	struct cam_jpeg_set_irq_cb irq_cb;
+	struct cam_hw_intf *hw_intf = hw_mgr->devices[dev_type][dev_idx];
 
 	/* stop reset Unregister CB and deinit */
 	irq_cb.jpeg_hw_mgr_cb = cam_jpeg_hw_mgr_cb;
 	irq_cb.data = NULL;
 	irq_cb.b_set_cb = false;
-	if (hw_mgr->devices[dev_type][0]->hw_ops.process_cmd) {
-		rc = hw_mgr->devices[dev_type][0]->hw_ops.process_cmd(
-			hw_mgr->devices[dev_type][0]->hw_priv,
+	if (hw_intf->hw_ops.process_cmd) {
+		rc = hw_intf->hw_ops.process_cmd(hw_intf->hw_priv,
 			CAM_JPEG_CMD_SET_IRQ_CB,
 			&irq_cb, sizeof(irq_cb));
 		if (rc)
@@ -879,20 +1027,16 @@ static void cam_jpeg_mgr_stop_deinit_dev(struct cam_jpeg_hw_mgr *hw_mgr,
 		CAM_ERR(CAM_JPEG, "process_cmd null %d", dev_type);
 	}
 
-	if (hw_mgr->devices[dev_type][0]->hw_ops.stop) {
-		rc = hw_mgr->devices[dev_type][0]->hw_ops.stop(
-			hw_mgr->devices[dev_type][0]->hw_priv,
-			NULL, 0);
+	if (hw_intf->hw_ops.stop) {
+		rc = hw_intf->hw_ops.stop(hw_intf->hw_priv, NULL, 0);
 		if (rc)
 			CAM_ERR(CAM_JPEG, "stop fail %d", rc);
 	} else {
 		CAM_ERR(CAM_JPEG, "op stop null %d", dev_type);
 	}
 
-	if (hw_mgr->devices[dev_type][0]->hw_ops.deinit) {
-		rc = hw_mgr->devices[dev_type][0]->hw_ops.deinit(
-			hw_mgr->devices[dev_type][0]->hw_priv,
-			NULL, 0);
+	if (hw_intf->hw_ops.deinit) {
+		rc = hw_intf->hw_ops.deinit(hw_intf->hw_priv, NULL, 0);
 		if (rc)
 			CAM_ERR(CAM_JPEG, "Failed to Deinit %d HW %d",
 				dev_type, rc);
@@ -900,8 +1044,24 @@ static void cam_jpeg_mgr_stop_deinit_dev(struct cam_jpeg_hw_mgr *hw_mgr,
 		CAM_ERR(CAM_JPEG, "op deinit null %d", dev_type);
 	}
 
-	hw_mgr->device_in_use[dev_type][0] = false;
-	hw_mgr->dev_hw_cfg_args[dev_type][0] = NULL;
+	hw_mgr->device_in_use[dev_type][dev_idx] = false;
+	hw_mgr->dev_hw_cfg_args[dev_type][dev_idx] = NULL;
+}
+
+static void cam_jpeg_mgr_requeue_next_req(struct cam_jpeg_hw_mgr *hw_mgr,
+	uint32_t dev_type, uint32_t dev_idx)
+{
+	struct cam_jpeg_hw_cfg_req *p_cfg_req;
+
+	p_cfg_req = hw_mgr->dev_next_cfg_args[dev_type][dev_idx];
+	if (!p_cfg_req)
+		return;
+
+	/* Core was stopped under its prefetched request, dispatch it again */
+	hw_mgr->dev_next_cfg_args[dev_type][dev_idx] = NULL;
+	list_add(&p_cfg_req->list, &hw_mgr->hw_config_req_list);
+	hw_mgr->stats.queue_depth++;
+	cam_jpeg_mgr_kick_dispatch(hw_mgr);
 }
 
 static int cam_jpeg_mgr_flush(void *hw_mgr_priv,
@@ -909,6 +1069,7 @@ static int cam_jpeg_mgr_flush(void *hw_mgr_priv,
 {
 	struct cam_jpeg_hw_mgr *hw_mgr = hw_mgr_priv;
 	uint32_t dev_type;
+	int i;
 	struct cam_jpeg_hw_cfg_req *p_cfg_req = NULL;
 	struct cam_jpeg_hw_cfg_req *cfg_req = NULL, *req_temp = NULL;
 
@@ -921,17 +1082,30 @@ static int cam_jpeg_mgr_flush(void *hw_mgr_priv,
 
 	dev_type = ctx_data->jpeg_dev_acquire_info.dev_type;
 
-	p_cfg_req = hw_mgr->dev_hw_cfg_args[dev_type][0];
-	if (hw_mgr->device_in_use[dev_type][0] == true &&
-		p_cfg_req != NULL) {
-		if ((struct cam_jpeg_hw_ctx_data *)
+	for (i = 0; i < hw_mgr->num_dev[dev_type]; i++) {
+		p_cfg_req = hw_mgr->dev_next_cfg_args[dev_type][i];
+		if (p_cfg_req && (struct cam_jpeg_hw_ctx_data *)
 			p_cfg_req->hw_cfg_args.ctxt_to_hw_map == ctx_data) {
-			cam_jpeg_mgr_stop_deinit_dev(hw_mgr, p_cfg_req,
-				dev_type);
-			list_del_init(&p_cfg_req->list);
+			hw_mgr->dev_next_cfg_args[dev_type][i] = NULL;
 			list_add_tail(&p_cfg_req->list,
 				&hw_mgr->free_req_list);
 		}
+
+		p_cfg_req = hw_mgr->dev_hw_cfg_args[dev_type][i];
+		if (hw_mgr->device_in_use[dev_type][i] == true &&
+			p_cfg_req != NULL) {
+			if ((struct cam_jpeg_hw_ctx_data *)
+				p_cfg_req->hw_cfg_args.ctxt_to_hw_map ==
+				ctx_data) {
+				cam_jpeg_mgr_stop_deinit_dev(hw_mgr,
+					dev_type, i);
+				list_del_init(&p_cfg_req->list);
+				list_add_tail(&p_cfg_req->list,
+					&hw_mgr->free_req_list);
+				cam_jpeg_mgr_requeue_next_req(hw_mgr,
+					dev_type, i);
+			}
+		}
 	}
 
 	list_for_each_entry_safe(cfg_req, req_temp,
@@ -941,6 +1115,7 @@ static int cam_jpeg_mgr_flush(void *hw_mgr_priv,
 			continue;
 
 		list_del_init(&cfg_req->list);
+		hw_mgr->stats.queue_depth--;
 		list_add_tail(&cfg_req->list, &hw_mgr->free_req_list);
 	}
 
@@ -958,6 +1133,7 @@ static int cam_jpeg_mgr_flush_req(void *hw_mgr_priv,
 	struct cam_jpeg_hw_cfg_req *req_temp = NULL;
 	long request_id = 0;
 	uint32_t dev_type;
+	int i;
 	struct cam_jpeg_hw_cfg_req *p_cfg_req = NULL;
 	bool b_req_found = false;
 
@@ -983,18 +1159,34 @@ static int cam_jpeg_mgr_flush_req(void *hw_mgr_priv,
 
 	dev_type = ctx_data->jpeg_dev_acquire_info.dev_type;
 
-	p_cfg_req = hw_mgr->dev_hw_cfg_args[dev_type][0];
-	if (hw_mgr->device_in_use[dev_type][0] == true &&
-		p_cfg_req != NULL) {
-		if (((struct cam_jpeg_hw_ctx_data *)
+	for (i = 0; i < hw_mgr->num_dev[dev_type] && !b_req_found; i++) {
+		p_cfg_req = hw_mgr->dev_next_cfg_args[dev_type][i];
+		if (p_cfg_req && ((struct cam_jpeg_hw_ctx_data *)
 			p_cfg_req->hw_cfg_args.ctxt_to_hw_map == ctx_data) &&
 			(p_cfg_req->req_id == request_id)) {
-			cam_jpeg_mgr_stop_deinit_dev(hw_mgr, p_cfg_req,
-				dev_type);
-			list_del_init(&p_cfg_req->list);
+			hw_mgr->dev_next_cfg_args[dev_type][i] = NULL;
 			list_add_tail(&p_cfg_req->list,
 				&hw_mgr->free_req_list);
 			b_req_found = true;
+			break;
+		}
+
+		p_cfg_req = hw_mgr->dev_hw_cfg_args[dev_type][i];
+		if (hw_mgr->device_in_use[dev_type][i] == true &&
+			p_cfg_req != NULL) {
+			if (((struct cam_jpeg_hw_ctx_data *)
+				p_cfg_req->hw_cfg_args.ctxt_to_hw_map ==
+				ctx_data) &&
+				(p_cfg_req->req_id == request_id)) {
+				cam_jpeg_mgr_stop_deinit_dev(hw_mgr,
+					dev_type, i);
+				list_del_init(&p_cfg_req->list);
+				list_add_tail(&p_cfg_req->list,
+					&hw_mgr->free_req_list);
+				cam_jpeg_mgr_requeue_next_req(hw_mgr,
+					dev_type, i);
+				b_req_found = true;
+			}
 		}
 	}
 
@@ -1008,6 +1200,7 @@ static int cam_jpeg_mgr_flush_req(void *hw_mgr_priv,
 			continue;
 
 		list_del_init(&cfg_req->list);
+		hw_mgr->stats.queue_depth--;
 		list_add_tail(&cfg_req->list, &hw_mgr->free_req_list);
 		b_req_found = true;
 		break;
@@ -1101,9 +1294,91 @@ static int cam_jpeg_mgr_hw_stop(void *hw_mgr_priv, void *stop_hw_args)
 	return rc;
 }
 
+static void cam_jpeg_mgr_put_cdm(struct cam_jpeg_hw_mgr *hw_mgr,
+	uint32_t dev_type, uint32_t dev_idx)
+{
+	struct cam_jpeg_hw_cdm_info_t *cdm_info =
+		&hw_mgr->cdm_info[dev_type][dev_idx];
+
+	if (--cdm_info->ref_cnt)
+		return;
+
+	if (cam_cdm_stream_off(cdm_info->cdm_handle)) {
+		CAM_ERR(CAM_JPEG, "CDM stream off failed %d",
+			cdm_info->cdm_handle);
+	}
+	/* release cdm handle */
+	cam_cdm_release(cdm_info->cdm_handle);
+}
+
+static int cam_jpeg_mgr_get_cdm(struct cam_jpeg_hw_mgr *hw_mgr,
+	uint32_t dev_type, struct cam_jpeg_hw_ctx_data *ctx_data)
+{
+	int i, rc = 0;
+	struct cam_cdm_acquire_data cdm_acquire;
+	struct cam_jpeg_hw_cdm_info_t *cdm_info;
+
+	/* Each core is driven through its own cdm */
+	for (i = 0; i < hw_mgr->num_dev[dev_type]; i++) {
+		cdm_info = &hw_mgr->cdm_info[dev_type][i];
+		if (cdm_info->ref_cnt) {
+			cdm_info->ref_cnt++;
+			continue;
+		}
+
+		memset(&cdm_acquire, 0, sizeof(cdm_acquire));
+		if (dev_type == CAM_JPEG_RES_TYPE_ENC) {
+			memcpy(cdm_acquire.identifier,
+				"jpegenc", sizeof("jpegenc"));
+		} else {
+			memcpy(cdm_acquire.identifier,
+				"jpegdma", sizeof("jpegdma"));
+		}
+		cdm_acquire.cell_index = i;
+		cdm_acquire.handle = 0;
+		cdm_acquire.userdata = ctx_data;
+		if (hw_mgr->cdm_reg_map[dev_type][i]) {
+			cdm_acquire.base_array[0] =
+				hw_mgr->cdm_reg_map[dev_type][i];
+		}
+		cdm_acquire.base_array_cnt = 1;
+		cdm_acquire.id = CAM_CDM_VIRTUAL;
+		cdm_acquire.cam_cdm_callback = NULL;
+		cdm_acquire.priority = CAM_CDM_BL_FIFO_0;
+
+		rc = cam_cdm_acquire(&cdm_acquire);
+		if (rc) {
+			CAM_ERR(CAM_JPEG, "Failed to acquire the CDM HW %d",
+				rc);
+			rc = -EFAULT;
+			goto put_cdm;
+		}
+
+		if (cam_cdm_stream_on(cdm_acquire.handle)) {
+			CAM_ERR(CAM_JPEG, "Can not start cdm (%d)!",
+				cdm_acquire.handle);
+			cam_cdm_release(cdm_acquire.handle);
+			rc = -EFAULT;
+			goto put_cdm;
+		}
+
+		cdm_info->cdm_handle = cdm_acquire.handle;
+		cdm_info->cdm_ops = cdm_acquire.ops;
+		cdm_info->ref_cnt++;
+	}
+
+	return 0;
+
+put_cdm:
+	for (--i; i >= 0; i--)
+		cam_jpeg_mgr_put_cdm(hw_mgr, dev_type, i);
+
+	return rc;
+}
+
 static int cam_jpeg_mgr_release_hw(void *hw_mgr_priv, void *release_hw_args)
 {
-	int rc;
+	int rc, i;
 	struct cam_hw_release_args *release_hw = release_hw_args;
 	struct cam_jpeg_hw_mgr *hw_mgr = hw_mgr_priv;
 	struct cam_jpeg_hw_ctx_data *ctx_data = NULL;
@@ -1117,7 +1392,6 @@ static int cam_jpeg_mgr_release_hw(void *hw_mgr_priv, void *release_hw_args)
 	ctx_data = (struct cam_jpeg_hw_ctx_data *)release_hw->ctxt_to_hw_map;
 	if (!ctx_data->in_use) {
 		CAM_ERR(CAM_JPEG, "ctx is not in use");
-		mutex_unlock(&hw_mgr->hw_mgr_mutex);
 		return -EINVAL;
 	}
 	dev_type = ctx_data->jpeg_dev_acquire_info.dev_type;
@@ -1129,31 +1403,17 @@ static int cam_jpeg_mgr_release_hw(void *hw_mgr_priv, void *release_hw_args)
 		return -EFAULT;
 	}
 
-	hw_mgr->cdm_info[dev_type][0].ref_cnt--;
-	if (!(hw_mgr->cdm_info[dev_type][0].ref_cnt)) {
-		if (cam_cdm_stream_off(
-			hw_mgr->cdm_info[dev_type][0].cdm_handle)) {
-			CAM_ERR(CAM_JPEG, "CDM stream off failed %d",
-				hw_mgr->cdm_info[dev_type][0].cdm_handle);
-		}
-		/* release cdm handle */
-		cam_cdm_release(hw_mgr->cdm_info[dev_type][0].cdm_handle);
-	}
+	for (i = 0; i < hw_mgr->num_dev[dev_type]; i++)
+		cam_jpeg_mgr_put_cdm(hw_mgr, dev_type, i);
 
 	mutex_unlock(&hw_mgr->hw_mgr_mutex);
 
 	rc = cam_jpeg_mgr_release_ctx(hw_mgr, ctx_data);
 	if (rc) {
-		mutex_unlock(&hw_mgr->hw_mgr_mutex);
 		CAM_ERR(CAM_JPEG, "JPEG release ctx failed");
-		kfree(ctx_data->cdm_cmd);
-		ctx_data->cdm_cmd = NULL;
-
 		return -EINVAL;
 	}
 
-	kfree(ctx_data->cdm_cmd);
-	ctx_data->cdm_cmd = NULL;
 	CAM_DBG(CAM_JPEG, "handle %llu", ctx_data);
 
 	return rc;
@@ -1162,14 +1422,13 @@ static int cam_jpeg_mgr_release_hw(void *hw_mgr_priv, void *release_hw_args)
 static int cam_jpeg_mgr_acquire_hw(void *hw_mgr_priv, void *acquire_hw_args)
 {
 	int rc = 0;
+	int i;
 	int32_t ctx_id = 0;
 	struct cam_jpeg_hw_mgr *hw_mgr = hw_mgr_priv;
 	struct cam_jpeg_hw_ctx_data *ctx_data = NULL;
 	struct cam_hw_acquire_args *args = acquire_hw_args;
 	struct cam_jpeg_acquire_dev_info jpeg_dev_acquire_info;
-	struct cam_cdm_acquire_data cdm_acquire;
 	uint32_t dev_type;
-	uint32_t size = 0;
 
 	if ((!hw_mgr_priv) || (!acquire_hw_args)) {
 		CAM_ERR(CAM_JPEG, "Invalid params: %pK %pK", hw_mgr_priv,
@@ -1201,15 +1460,6 @@ static int cam_jpeg_mgr_acquire_hw(void *hw_mgr_priv, void *acquire_hw_args)
 
 	ctx_data = &hw_mgr->ctx_data[ctx_id];
 
-	ctx_data->cdm_cmd =
-		kzalloc(((sizeof(struct cam_cdm_bl_request)) +
-			((CAM_JPEG_HW_ENTRIES_MAX - 1) *
-			sizeof(struct cam_cdm_bl_cmd))), GFP_KERNEL);
-	if (!ctx_data->cdm_cmd) {
-		rc = -ENOMEM;
-		goto jpeg_release_ctx;
-	}
-
 	mutex_lock(&ctx_data->ctx_mutex);
 	ctx_data->jpeg_dev_acquire_info = jpeg_dev_acquire_info;
 	mutex_unlock(&ctx_data->ctx_mutex);
@@ -1217,55 +1467,13 @@ static int cam_jpeg_mgr_acquire_hw(void *hw_mgr_priv, void *acquire_hw_args)
 	if (ctx_data->jpeg_dev_acquire_info.dev_type >=
 		CAM_JPEG_RES_TYPE_MAX) {
 		rc = -EINVAL;
-		goto acq_cdm_hdl_failed;
+		goto jpeg_release_ctx;
 	}
 	dev_type = ctx_data->jpeg_dev_acquire_info.dev_type;
-	if (!hw_mgr->cdm_info[dev_type][0].ref_cnt) {
-
-		if (dev_type == CAM_JPEG_RES_TYPE_ENC) {
-			memcpy(cdm_acquire.identifier,
-				"jpegenc", sizeof("jpegenc"));
-		} else {
-			memcpy(cdm_acquire.identifier,
-				"jpegdma", sizeof("jpegdma"));
-		}
-		cdm_acquire.cell_index = 0;
-		cdm_acquire.handle = 0;
-		cdm_acquire.userdata = ctx_data;
-		if (hw_mgr->cdm_reg_map[dev_type][0]) {
-			cdm_acquire.base_array[0] =
-				hw_mgr->cdm_reg_map[dev_type][0];
-		}
-		cdm_acquire.base_array_cnt = 1;
-		cdm_acquire.id = CAM_CDM_VIRTUAL;
-		cdm_acquire.cam_cdm_callback = NULL;
-		cdm_acquire.priority = CAM_CDM_BL_FIFO_0;
-
-		rc = cam_cdm_acquire(&cdm_acquire);
-		if (rc) {
-			CAM_ERR(CAM_JPEG, "Failed to acquire the CDM HW %d",
-				rc);
-			rc = -EFAULT;
-			goto acq_cdm_hdl_failed;
-		}
-		hw_mgr->cdm_info[dev_type][0].cdm_handle = cdm_acquire.handle;
-		hw_mgr->cdm_info[dev_type][0].cdm_ops = cdm_acquire.ops;
-		hw_mgr->cdm_info[dev_type][0].ref_cnt++;
-	} else {
-		hw_mgr->cdm_info[dev_type][0].ref_cnt++;
-	}
-
-	size =
-	hw_mgr->cdm_info[dev_type][0].cdm_ops->cdm_required_size_changebase();
 
-	if (hw_mgr->cdm_info[dev_type][0].ref_cnt == 1)
-		if (cam_cdm_stream_on(
-			hw_mgr->cdm_info[dev_type][0].cdm_handle)) {
-			CAM_ERR(CAM_JPEG, "Can not start cdm (%d)!",
-				hw_mgr->cdm_info[dev_type][0].cdm_handle);
-			rc = -EFAULT;
-			goto start_cdm_hdl_failed;
-		}
+	rc = cam_jpeg_mgr_get_cdm(hw_mgr, dev_type, ctx_data);
+	if (rc)
+		goto jpeg_release_ctx;
 
 	mutex_lock(&ctx_data->ctx_mutex);
 	ctx_data->context_priv = args->context_data;
@@ -1290,14 +1498,8 @@ static int cam_jpeg_mgr_acquire_hw(void *hw_mgr_priv, void *acquire_hw_args)
 	return rc;
 
 copy_to_user_failed:
-	if (hw_mgr->cdm_info[dev_type][0].ref_cnt == 1)
-		cam_cdm_stream_off(hw_mgr->cdm_info[dev_type][0].cdm_handle);
-start_cdm_hdl_failed:
-	if (hw_mgr->cdm_info[dev_type][0].ref_cnt == 1)
-		cam_cdm_release(hw_mgr->cdm_info[dev_type][0].cdm_handle);
-	hw_mgr->cdm_info[dev_type][0].ref_cnt--;
-acq_cdm_hdl_failed:
-	kfree(ctx_data->cdm_cmd);
+	for (i = 0; i < hw_mgr->num_dev[dev_type]; i++)
+		cam_jpeg_mgr_put_cdm(hw_mgr, dev_type, i);
 jpeg_release_ctx:
 	cam_jpeg_mgr_release_ctx(hw_mgr, ctx_data);
 	mutex_unlock(&hw_mgr->hw_mgr_mutex);
@@ -1399,6 +1601,14 @@ static int cam_jpeg_setup_workqs(void)
 	INIT_LIST_HEAD(&g_jpeg_hw_mgr.hw_config_req_list);
 	INIT_LIST_HEAD(&g_jpeg_hw_mgr.free_req_list);
 	for (i = 0; i < CAM_JPEG_HW_CFG_Q_MAX; i++) {
+		g_jpeg_hw_mgr.req_list[i].cdm_cmd =
+			kzalloc(((sizeof(struct cam_cdm_bl_request)) +
+			((CAM_JPEG_HW_ENTRIES_MAX - 1) *
+			sizeof(struct cam_cdm_bl_cmd))), GFP_KERNEL);
+		if (!g_jpeg_hw_mgr.req_list[i].cdm_cmd) {
+			rc = -ENOMEM;
+			goto cdm_cmd_failed;
+		}
 		INIT_LIST_HEAD(&(g_jpeg_hw_mgr.req_list[i].list));
 		list_add_tail(&(g_jpeg_hw_mgr.req_list[i].list),
 			&(g_jpeg_hw_mgr.free_req_list));
@@ -1406,6 +1616,12 @@ static int cam_jpeg_setup_workqs(void)
 
 	return rc;
 
+cdm_cmd_failed:
+	for (i = 0; i < CAM_JPEG_HW_CFG_Q_MAX; i++) {
+		kfree(g_jpeg_hw_mgr.req_list[i].cdm_cmd);
+		g_jpeg_hw_mgr.req_list[i].cdm_cmd = NULL;
+	}
+	kfree(g_jpeg_hw_mgr.process_irq_cb_work_data);
 work_process_irq_cb_data_failed:
 	kfree(g_jpeg_hw_mgr.process_frame_work_data);
 work_process_frame_data_failed:
@@ -1451,6 +1667,11 @@ static int cam_jpeg_init_devices(struct device_node *of_node,
 		CAM_ERR(CAM_JPEG, "read num enc devices failed %d", rc);
 		goto num_enc_failed;
 	}
+	if (!num_dev || num_dev > CAM_JPEG_DEV_PER_TYPE_MAX) {
+		CAM_ERR(CAM_JPEG, "invalid num enc devices %u", num_dev);
+		rc = -EINVAL;
+		goto num_enc_failed;
+	}
 	g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_ENC] = kzalloc(
 		sizeof(struct cam_hw_intf *) * num_dev, GFP_KERNEL);
 	if (!g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_ENC]) {
@@ -1464,6 +1685,11 @@ static int cam_jpeg_init_devices(struct device_node *of_node,
 		CAM_ERR(CAM_JPEG, "get num dma dev nodes failed %d", rc);
 		goto num_dma_failed;
 	}
+	if (!num_dma_dev || num_dma_dev > CAM_JPEG_DEV_PER_TYPE_MAX) {
+		CAM_ERR(CAM_JPEG, "invalid num dma devices %u", num_dma_dev);
+		rc = -EINVAL;
+		goto num_dma_failed;
+	}
 
 	g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_DMA] = kzalloc(
 		sizeof(struct cam_hw_intf *) * num_dma_dev, GFP_KERNEL);
@@ -1524,16 +1750,33 @@ static int cam_jpeg_init_devices(struct device_node *of_node,
 		of_node_put(child_node);
 	}
 
-	enc_hw = (struct cam_hw_info *)
-		g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_ENC][0]->hw_priv;
-	enc_soc_info = &enc_hw->soc_info;
-	g_jpeg_hw_mgr.cdm_reg_map[CAM_JPEG_DEV_ENC][0] =
-		&enc_soc_info->reg_map[0];
-	dma_hw = (struct cam_hw_info *)
-		g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_DMA][0]->hw_priv;
-	dma_soc_info = &dma_hw->soc_info;
-	g_jpeg_hw_mgr.cdm_reg_map[CAM_JPEG_DEV_DMA][0] =
-		&dma_soc_info->reg_map[0];
+	for (i = 0; i < num_dev; i++) {
+		if (!g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_ENC][i]) {
+			CAM_ERR(CAM_JPEG, "enc dev %d not found", i);
+			rc = -ENODEV;
+			goto compat_hw_name_failed;
+		}
+		enc_hw = (struct cam_hw_info *)
+			g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_ENC][i]->hw_priv;
+		enc_soc_info = &enc_hw->soc_info;
+		g_jpeg_hw_mgr.cdm_reg_map[CAM_JPEG_DEV_ENC][i] =
+			&enc_soc_info->reg_map[0];
+	}
+
+	for (i = 0; i < num_dma_dev; i++) {
+		if (!g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_DMA][i]) {
+			CAM_ERR(CAM_JPEG, "dma dev %d not found", i);
+			rc = -ENODEV;
+			goto compat_hw_name_failed;
+		}
+		dma_hw = (struct cam_hw_info *)
+			g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_DMA][i]->hw_priv;
+		dma_soc_info = &dma_hw->soc_info;
+		g_jpeg_hw_mgr.cdm_reg_map[CAM_JPEG_DEV_DMA][i] =
+			&dma_soc_info->reg_map[0];
+	}
+	g_jpeg_hw_mgr.num_dev[CAM_JPEG_DEV_ENC] = num_dev;
+	g_jpeg_hw_mgr.num_dev[CAM_JPEG_DEV_DMA] = num_dma_dev;
 
 	rc = g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_ENC][0]->hw_ops.process_cmd(
 		g_jpeg_hw_mgr.devices[CAM_JPEG_DEV_ENC][0]->hw_priv,
@@ -1570,6 +1813,7 @@ static int cam_jpeg_mgr_hw_dump(void *hw_mgr_priv, void *dump_hw_args)
 	size_t                          remain_len;
 	uint32_t                        min_len;
 	uint32_t                        dev_type;
+	uint32_t                        dev_idx;
 	uint64_t                        diff;
 	uint64_t                       *addr, *start;
 	struct timespec64               cur_ts;
@@ -1606,8 +1850,11 @@ static int cam_jpeg_mgr_hw_dump(void *hw_mgr_priv, void *dump_hw_args)
 
 	dev_type = ctx_data->jpeg_dev_acquire_info.dev_type;
 
-	if (true == hw_mgr->device_in_use[dev_type][0]) {
-		p_cfg_req = hw_mgr->dev_hw_cfg_args[dev_type][0];
+	for (dev_idx = 0; dev_idx < hw_mgr->num_dev[dev_type]; dev_idx++) {
+		if (false == hw_mgr->device_in_use[dev_type][dev_idx])
+			continue;
+
+		p_cfg_req = hw_mgr->dev_hw_cfg_args[dev_type][dev_idx];
 		if (p_cfg_req  && p_cfg_req->req_id ==
 			    (uintptr_t)dump_args->request_id)
 			goto hw_dump;
@@ -1687,9 +1934,9 @@ hw_dump:
 	jpeg_dump_args.request_id = dump_args->request_id;
 	jpeg_dump_args.offset = dump_args->offset;
 
-	if (hw_mgr->devices[dev_type][0]->hw_ops.process_cmd) {
-		rc = hw_mgr->devices[dev_type][0]->hw_ops.process_cmd(
-			hw_mgr->devices[dev_type][0]->hw_priv,
+	if (hw_mgr->devices[dev_type][dev_idx]->hw_ops.process_cmd) {
+		rc = hw_mgr->devices[dev_type][dev_idx]->hw_ops.process_cmd(
+			hw_mgr->devices[dev_type][dev_idx]->hw_priv,
 			CAM_JPEG_CMD_HW_DUMP,
 			&jpeg_dump_args, sizeof(jpeg_dump_args));
 	}
@@ -1730,13 +1977,20 @@ static void cam_jpeg_mgr_dump_pf_data(
 		goto iodump;
 	}
 
-	rc = hw_mgr->devices[dev_type][0]->hw_ops.process_cmd(
-		hw_mgr->devices[dev_type][0]->hw_priv,
-		CAM_JPEG_CMD_MATCH_PID_MID,
-		&jpeg_pid_mid_args, sizeof(jpeg_pid_mid_args));
-	if (rc) {
-		CAM_ERR(CAM_JPEG, "CAM_JPEG_CMD_MATCH_PID_MID failed %d", rc);
-		return;
+	jpeg_pid_mid_args.pid_match_found = false;
+	for (i = 0; i < hw_mgr->num_dev[dev_type]; i++) {
+		rc = hw_mgr->devices[dev_type][i]->hw_ops.process_cmd(
+			hw_mgr->devices[dev_type][i]->hw_priv,
+			CAM_JPEG_CMD_MATCH_PID_MID,
+			&jpeg_pid_mid_args, sizeof(jpeg_pid_mid_args));
+		if (rc) {
+			CAM_ERR(CAM_JPEG,
+				"CAM_JPEG_CMD_MATCH_PID_MID failed %d", rc);
+			return;
+		}
+
+		if (jpeg_pid_mid_args.pid_match_found)
+			break;
 	}
 
 	if (!jpeg_pid_mid_args.pid_match_found) {
@@ -1856,6 +2110,59 @@ static int cam_jpeg_get_bug_on_misr(void *data, u64 *val)
 DEFINE_DEBUGFS_ATTRIBUTE(bug_on_misr_mismatch, cam_jpeg_get_bug_on_misr,
 	cam_jpeg_set_bug_on_misr, "%08llu");
 
+static ssize_t cam_jpeg_req_stats_read(struct file *file,
+	char __user *ubuf, size_t size, loff_t *ppos)
+{
+	struct cam_jpeg_hw_mgr_stats stats;
+	char t_char[384];
+	int len, i, j;
+
+	mutex_lock(&g_jpeg_hw_mgr.hw_mgr_mutex);
+	stats = g_jpeg_hw_mgr.stats;
+	mutex_unlock(&g_jpeg_hw_mgr.hw_mgr_mutex);
+
+	len = scnprintf(t_char, sizeof(t_char),
+		"req %llu prefetch %llu queue_depth %u max_queue_depth %u\n",
+		stats.num_req, stats.num_prefetch, stats.queue_depth,
+		stats.max_queue_depth);
+	len += scnprintf(t_char + len, sizeof(t_char) - len,
+		"queue avg_ns %llu max_ns %llu\nhw avg_ns %llu max_ns %llu\n",
+		stats.num_req ?
+		div64_u64(stats.total_queue_ns, stats.num_req) : 0,
+		stats.max_queue_ns,
+		stats.num_req ? div64_u64(stats.total_hw_ns, stats.num_req) : 0,
+		stats.max_hw_ns);
+	for (i = 0; i < CAM_JPEG_DEV_TYPE_MAX; i++)
+		for (j = 0; j < g_jpeg_hw_mgr.num_dev[i]; j++)
+			len += scnprintf(t_char + len, sizeof(t_char) - len,
+				"%s%d req %llu\n",
+				(i == CAM_JPEG_DEV_ENC) ? "enc" : "dma", j,
+				stats.num_dev_req[i][j]);
+
+	return simple_read_from_buffer(ubuf, size, ppos, t_char, len);
+}
+
+static ssize_t cam_jpeg_req_stats_write(struct file *file,
+	const char __user *ubuf, size_t size, loff_t *ppos)
+{
+	uint32_t queue_depth;
+
+	mutex_lock(&g_jpeg_hw_mgr.hw_mgr_mutex);
+	queue_depth = g_jpeg_hw_mgr.stats.queue_depth;
+	memset(&g_jpeg_hw_mgr.stats, 0, sizeof(g_jpeg_hw_mgr.stats));
+	g_jpeg_hw_mgr.stats.queue_depth = queue_depth;
+	g_jpeg_hw_mgr.stats.max_queue_depth = queue_depth;
+	mutex_unlock(&g_jpeg_hw_mgr.hw_mgr_mutex);
+
+	return size;
+}
+
+static const struct file_operations cam_jpeg_req_stats_fops = {
+	.open = simple_open,
+	.read = cam_jpeg_req_stats_read,
+	.write = cam_jpeg_req_stats_write,
+};
+
 static int cam_jpeg_mgr_create_debugfs_entry(void)
 {
 	int rc = 0;
@@ -1876,6 +2183,9 @@ static int cam_jpeg_mgr_create_debugfs_entry(void)
 	dbgfileptr = debugfs_create_file("bug_on_misr_mismatch", 0644,
 		g_jpeg_hw_mgr.dentry, NULL, &bug_on_misr_mismatch);
 
+	dbgfileptr = debugfs_create_file("req_stats", 0644,
+		g_jpeg_hw_mgr.dentry, NULL, &cam_jpeg_req_stats_fops);
+
 	if (IS_ERR(dbgfileptr)) {
 		if (PTR_ERR(dbgfileptr) == -ENODEV)
 			CAM_WARN(CAM_JPEG, "DebugFS not enabled in kernel!");
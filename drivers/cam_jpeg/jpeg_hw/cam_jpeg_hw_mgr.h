@@ -74,17 +74,48 @@ struct cam_jpeg_hw_cdm_info_t {
  * @list_head: List head
  * @hw_cfg_args: Hw config args
  * @dev_type: Dev type for cfg request
+ * @dev_idx: Core the request is dispatched to
  * @req_id: Request Id
  * @submit_timestamp: Timestamp of submitting request
+ * @enqueue_timestamp: Timestamp of queueing request for a core
  * @num_hw_entry_processed: Cdm payloads already processed
+ * @cdm_cmd: Cdm BLs of the hw update entry being processed
  */
 struct cam_jpeg_hw_cfg_req {
 	struct list_head list;
 	struct cam_hw_config_args hw_cfg_args;
 	uint32_t dev_type;
+	uint32_t dev_idx;
 	uintptr_t req_id;
 	ktime_t    submit_timestamp;
+	ktime_t    enqueue_timestamp;
 	uint32_t num_hw_entry_processed;
+	struct cam_cdm_bl_request *cdm_cmd;
+};
+
+/**
+ * struct cam_jpeg_hw_mgr_stats
+ *
+ * @num_req: Requests completed by hw
+ * @num_prefetch: Requests started from a core prefetch slot
+ * @total_queue_ns: Sum of time requests waited for a core
+ * @max_queue_ns: Longest time a request waited for a core
+ * @total_hw_ns: Sum of time from hw start to done
+ * @max_hw_ns: Longest time from hw start to done
+ * @queue_depth: Requests currently waiting for a core
+ * @max_queue_depth: Highest number of requests waiting for a core
+ * @num_dev_req: Requests completed per core
+ */
+struct cam_jpeg_hw_mgr_stats {
+	uint64_t num_req;
+	uint64_t num_prefetch;
+	uint64_t total_queue_ns;
+	uint64_t max_queue_ns;
+	uint64_t total_hw_ns;
+	uint64_t max_hw_ns;
+	uint32_t queue_depth;
+	uint32_t max_queue_depth;
+	uint64_t num_dev_req[CAM_JPEG_DEV_TYPE_MAX][CAM_JPEG_DEV_PER_TYPE_MAX];
 };
 
 /**
@@ -97,7 +128,6 @@ struct cam_jpeg_hw_cfg_req {
  * @ctxt_event_cb: Context callback function
  * @in_use: Flag for context usage
  * @wait_complete: Completion info
- * @cdm_cmd: Cdm cmd submitted for that context.
  */
 struct cam_jpeg_hw_ctx_data {
 	void *context_priv;
@@ -106,7 +136,6 @@ struct cam_jpeg_hw_ctx_data {
 	cam_hw_event_cb_func ctxt_event_cb;
 	bool in_use;
 	struct completion wait_complete;
-	struct cam_cdm_bl_request *cdm_cmd;
 };
 
 /**
@@ -128,14 +157,17 @@ struct cam_jpeg_hw_ctx_data {
  * @camnoc_misr_test : debugfs entry to select camnoc_misr for read or write path
  * @bug_on_misr : enable/disable bug on when misr mismatch is seen
  * @devices: Core hw Devices of JPEG hardware manager
+ * @num_dev: Number of cores per device type
  * @cdm_info: Cdm info for each core device.
  * @cdm_reg_map: Regmap of each device for cdm.
  * @device_in_use: Flag device being used for an active request
  * @dev_hw_cfg_args: Current cfg request per core dev
+ * @dev_next_cfg_args: Request prefetched to run next on a core dev
  * @hw_config_req_list: Pending hw update requests list
  * @free_req_list: Free nodes for above list
  * @req_list: Nodes of hw update list
  * @num_pid: num of pids supported in the device
+ * @stats: Request latency and queue depth statistics
  */
 struct cam_jpeg_hw_mgr {
 	struct mutex hw_mgr_mutex;
@@ -155,19 +187,23 @@ struct cam_jpeg_hw_mgr {
 	u64 bug_on_misr;
 
 	struct cam_hw_intf **devices[CAM_JPEG_DEV_TYPE_MAX];
+	uint32_t num_dev[CAM_JPEG_DEV_TYPE_MAX];
 	struct cam_jpeg_hw_cdm_info_t cdm_info[CAM_JPEG_DEV_TYPE_MAX]
-		[CAM_JPEG_NUM_DEV_PER_RES_MAX];
+		[CAM_JPEG_DEV_PER_TYPE_MAX];
 	struct cam_soc_reg_map *cdm_reg_map[CAM_JPEG_DEV_TYPE_MAX]
-		[CAM_JPEG_NUM_DEV_PER_RES_MAX];
+		[CAM_JPEG_DEV_PER_TYPE_MAX];
 	uint32_t device_in_use[CAM_JPEG_DEV_TYPE_MAX]
-		[CAM_JPEG_NUM_DEV_PER_RES_MAX];
+		[CAM_JPEG_DEV_PER_TYPE_MAX];
 	struct cam_jpeg_hw_cfg_req *dev_hw_cfg_args[CAM_JPEG_DEV_TYPE_MAX]
-		[CAM_JPEG_NUM_DEV_PER_RES_MAX];
+		[CAM_JPEG_DEV_PER_TYPE_MAX];
+	struct cam_jpeg_hw_cfg_req *dev_next_cfg_args[CAM_JPEG_DEV_TYPE_MAX]
+		[CAM_JPEG_DEV_PER_TYPE_MAX];
 
 	struct list_head hw_config_req_list;
 	struct list_head free_req_list;
 	struct cam_jpeg_hw_cfg_req req_list[CAM_JPEG_HW_CFG_Q_MAX];
 	uint32_t num_pid[CAM_JPEG_DEV_TYPE_MAX];
+	struct cam_jpeg_hw_mgr_stats stats;
 };
 
 #endif /* CAM_JPEG_HW_MGR_H */
@@ -9,7 +9,7 @@
 
 #include "cam_cpas_api.h"
 
-#define CAM_JPEG_DEV_PER_TYPE_MAX     1
+#define CAM_JPEG_DEV_PER_TYPE_MAX     2
 
 #define CAM_JPEG_CMD_BUF_MAX_SIZE     128
 #define CAM_JPEG_MSG_BUF_MAX_SIZE     CAM_JPEG_CMD_BUF_MAX_SIZE
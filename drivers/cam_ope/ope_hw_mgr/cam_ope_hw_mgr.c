@@ -178,14 +178,102 @@ static int cam_ope_mgr_reset_hw(void)
 	return rc;
 }
 
-static void cam_ope_free_io_config(struct cam_ope_request *req)
+static struct ope_io_buf *cam_ope_get_io_buf(struct cam_ope_ctx *ctx_data)
+{
+	struct ope_io_buf *io_buf = NULL;
+
+	spin_lock(&ctx_data->io_buf_pool_lock);
+	if (!list_empty(&ctx_data->io_buf_pool)) {
+		io_buf = list_first_entry(&ctx_data->io_buf_pool,
+			struct ope_io_buf, list);
+		list_del_init(&io_buf->list);
+		ctx_data->io_buf_pool_cnt--;
+	}
+	spin_unlock(&ctx_data->io_buf_pool_lock);
+
+	if (io_buf) {
+		atomic64_inc(&ope_hw_mgr->io_buf_pool_hit);
+		return io_buf;
+	}
+
+	atomic64_inc(&ope_hw_mgr->io_buf_pool_miss);
+	io_buf = kzalloc(sizeof(struct ope_io_buf), GFP_KERNEL);
+	if (io_buf)
+		INIT_LIST_HEAD(&io_buf->list);
+
+	return io_buf;
+}
+
+static void cam_ope_put_io_buf(struct cam_ope_ctx *ctx_data,
+	struct ope_io_buf *io_buf)
+{
+	/* Pooled buffers are handed out clean, as kzalloc would */
+	memset(io_buf, 0, offsetof(struct ope_io_buf, list));
+
+	spin_lock(&ctx_data->io_buf_pool_lock);
+	if (ctx_data->io_buf_pool_cnt < OPE_IO_BUF_POOL_MAX) {
+		list_add(&io_buf->list, &ctx_data->io_buf_pool);
+		ctx_data->io_buf_pool_cnt++;
+		io_buf = NULL;
+	}
+	spin_unlock(&ctx_data->io_buf_pool_lock);
+
+	kfree(io_buf);
+}
+
+static void cam_ope_fill_io_buf_pool(struct cam_ope_ctx *ctx_data)
+{
+	struct ope_io_buf *io_buf;
+	uint32_t depth;
+
+	depth = (ctx_data->ope_acquire.num_in_res +
+		ctx_data->ope_acquire.num_out_res) *
+		max_t(uint32_t, ctx_data->ope_acquire.batch_size, 1);
+	depth = min_t(uint32_t, depth, OPE_IO_BUF_POOL_MAX);
+
+	while (ctx_data->io_buf_pool_cnt < depth) {
+		io_buf = kzalloc(sizeof(struct ope_io_buf), GFP_KERNEL);
+		if (!io_buf) {
+			/* Not fatal, the pool grows on demand */
+			CAM_DBG(CAM_OPE, "ctx %u io buf pool at %u of %u",
+				ctx_data->ctx_id, ctx_data->io_buf_pool_cnt,
+				depth);
+			return;
+		}
+
+		spin_lock(&ctx_data->io_buf_pool_lock);
+		list_add(&io_buf->list, &ctx_data->io_buf_pool);
+		ctx_data->io_buf_pool_cnt++;
+		spin_unlock(&ctx_data->io_buf_pool_lock);
+	}
+}
+
+static void cam_ope_free_io_buf_pool(struct cam_ope_ctx *ctx_data)
+{
+	struct ope_io_buf *io_buf, *tmp;
+	LIST_HEAD(free_list);
+
+	spin_lock(&ctx_data->io_buf_pool_lock);
+	list_splice_init(&ctx_data->io_buf_pool, &free_list);
+	ctx_data->io_buf_pool_cnt = 0;
+	spin_unlock(&ctx_data->io_buf_pool_lock);
+
+	list_for_each_entry_safe(io_buf, tmp, &free_list, list) {
+		list_del(&io_buf->list);
+		kzfree(io_buf);
+	}
+}
+
+static void cam_ope_free_io_config(struct cam_ope_ctx *ctx_data,
+	struct cam_ope_request *req)
 {
 	int i, j;
 
 	for (i = 0; i < OPE_MAX_BATCH_SIZE; i++) {
 		for (j = 0; j < OPE_MAX_IO_BUFS; j++) {
 			if (req->io_buf[i][j]) {
-				kzfree(req->io_buf[i][j]);
+				cam_ope_put_io_buf(ctx_data,
+					req->io_buf[i][j]);
 				req->io_buf[i][j] = NULL;
 			}
 		}
@@ -1722,7 +1810,7 @@ static void cam_ope_ctx_cdm_callback(uint32_t handle, void *userdata,
 	ope_req->request_id = 0;
 	kzfree(ctx->req_list[cookie]->cdm_cmd);
 	ctx->req_list[cookie]->cdm_cmd = NULL;
-	cam_ope_free_io_config(ctx->req_list[cookie]);
+	cam_ope_free_io_config(ctx, ctx->req_list[cookie]);
 	kzfree(ctx->req_list[cookie]);
 	ctx->req_list[cookie] = NULL;
 	clear_bit(cookie, ctx->bitmap);
@@ -1783,14 +1871,20 @@ static int cam_ope_mgr_create_kmd_buf(struct cam_ope_hw_mgr *hw_mgr,
 	prepare_req.frame_process =
 		(struct ope_frame_process *)ope_cmd_buf_addr;
 
-	for (i = 0; i < ope_hw_mgr->num_ope; i++)
+	/*
+	 * Every core appends to the same context KMD buffer through
+	 * prepare_req.kmd_buf_offset, so the cores are prepared in order.
+	 */
+	for (i = 0; i < ope_hw_mgr->num_ope; i++) {
 		rc = hw_mgr->ope_dev_intf[i]->hw_ops.process_cmd(
 			hw_mgr->ope_dev_intf[i]->hw_priv,
 			OPE_HW_PREPARE, &prepare_req, sizeof(prepare_req));
 		if (rc) {
-			CAM_ERR(CAM_OPE, "OPE Dev prepare failed: %d", rc);
+			CAM_ERR(CAM_OPE, "OPE Dev %d prepare failed: %d",
+				i, rc);
 			goto end;
 		}
+	}
 
 end:
 	return rc;
@@ -1977,11 +2071,11 @@ static int cam_ope_mgr_process_cmd_io_buf_req(struct cam_ope_hw_mgr *hw_mgr,
 		for (j = 0; j < in_frame_set->num_io_bufs; j++) {
 			in_io_buf = &in_frame_set->io_buf[j];
 			ope_request->io_buf[i][j] =
-				kzalloc(sizeof(struct ope_io_buf), GFP_KERNEL);
+				cam_ope_get_io_buf(ctx_data);
 			if (!ope_request->io_buf[i][j]) {
 				CAM_ERR(CAM_OPE,
 					"IO config allocation failure");
-				cam_ope_free_io_config(ope_request);
+				cam_ope_free_io_config(ctx_data, ope_request);
 				return -ENOMEM;
 			}
 			io_buf = ope_request->io_buf[i][j];
@@ -2798,6 +2892,7 @@ static int cam_ope_mgr_acquire_hw(void *hw_priv, void *hw_acquire_args)
 	args->ctxt_to_hw_map = ctx;
 	ctx->ctxt_event_cb = args->event_cb;
 	cam_ope_ctx_clk_info_init(ctx);
+	cam_ope_fill_io_buf_pool(ctx);
 	ctx->ctx_state = OPE_CTX_STATE_ACQUIRED;
 	kzfree(cdm_acquire);
 	cdm_acquire = NULL;
@@ -2970,12 +3065,14 @@ static int cam_ope_mgr_release_ctx(struct cam_ope_hw_mgr *hw_mgr, int ctx_id)
 			kzfree(hw_mgr->ctx[ctx_id].req_list[i]->cdm_cmd);
 			hw_mgr->ctx[ctx_id].req_list[i]->cdm_cmd = NULL;
 		}
-		cam_ope_free_io_config(hw_mgr->ctx[ctx_id].req_list[i]);
+		cam_ope_free_io_config(&hw_mgr->ctx[ctx_id],
+			hw_mgr->ctx[ctx_id].req_list[i]);
 		kzfree(hw_mgr->ctx[ctx_id].req_list[i]);
 		hw_mgr->ctx[ctx_id].req_list[i] = NULL;
 		clear_bit(i, hw_mgr->ctx[ctx_id].bitmap);
 	}
 
+	cam_ope_free_io_buf_pool(&hw_mgr->ctx[ctx_id]);
 	cam_ope_req_timer_stop(&hw_mgr->ctx[ctx_id]);
 	hw_mgr->ctx[ctx_id].ope_cdm.cdm_handle = 0;
 	hw_mgr->ctx[ctx_id].req_cnt = 0;
@@ -3373,7 +3470,7 @@ static int cam_ope_mgr_handle_config_err(
 	ope_req->request_id = 0;
 	kzfree(ctx_data->req_list[req_idx]->cdm_cmd);
 	ctx_data->req_list[req_idx]->cdm_cmd = NULL;
-	cam_ope_free_io_config(ctx_data->req_list[req_idx]);
+	cam_ope_free_io_config(ctx_data, ctx_data->req_list[req_idx]);
 	kzfree(ctx_data->req_list[req_idx]);
 	ctx_data->req_list[req_idx] = NULL;
 	clear_bit(req_idx, ctx_data->bitmap);
@@ -3561,7 +3658,7 @@ static int cam_ope_mgr_flush_req(struct cam_ope_ctx *ctx_data,
 		ctx_data->req_list[idx]->request_id = 0;
 		kzfree(ctx_data->req_list[idx]->cdm_cmd);
 		ctx_data->req_list[idx]->cdm_cmd = NULL;
-		cam_ope_free_io_config(ctx_data->req_list[idx]);
+		cam_ope_free_io_config(ctx_data, ctx_data->req_list[idx]);
 		kzfree(ctx_data->req_list[idx]);
 		ctx_data->req_list[idx] = NULL;
 		clear_bit(idx, ctx_data->bitmap);
@@ -3594,7 +3691,7 @@ static int cam_ope_mgr_flush_all(struct cam_ope_ctx *ctx_data,
 		ctx_data->req_list[i]->request_id = 0;
 		kzfree(ctx_data->req_list[i]->cdm_cmd);
 		ctx_data->req_list[i]->cdm_cmd = NULL;
-		cam_ope_free_io_config(ctx_data->req_list[i]);
+		cam_ope_free_io_config(ctx_data, ctx_data->req_list[i]);
 		kzfree(ctx_data->req_list[i]);
 		ctx_data->req_list[i] = NULL;
 		clear_bit(i, ctx_data->bitmap);
@@ -3933,6 +4030,34 @@ cmd_work_failed:
 	return rc;
 }
 
+static ssize_t cam_ope_io_buf_pool_stats_read(struct file *file,
+	char __user *ubuf, size_t size, loff_t *ppos)
+{
+	char t_char[64];
+	int len;
+
+	len = scnprintf(t_char, sizeof(t_char), "hit %lld miss %lld\n",
+		atomic64_read(&ope_hw_mgr->io_buf_pool_hit),
+		atomic64_read(&ope_hw_mgr->io_buf_pool_miss));
+
+	return simple_read_from_buffer(ubuf, size, ppos, t_char, len);
+}
+
+static ssize_t cam_ope_io_buf_pool_stats_write(struct file *file,
+	const char __user *ubuf, size_t size, loff_t *ppos)
+{
+	atomic64_set(&ope_hw_mgr->io_buf_pool_hit, 0);
+	atomic64_set(&ope_hw_mgr->io_buf_pool_miss, 0);
+
+	return size;
+}
+
+static const struct file_operations cam_ope_io_buf_pool_stats_fops = {
+	.open = simple_open,
+	.read = cam_ope_io_buf_pool_stats_read,
+	.write = cam_ope_io_buf_pool_stats_write,
+};
+
 static int cam_ope_create_debug_fs(void)
 {
 	ope_hw_mgr->dentry = debugfs_create_dir("camera_ope",
@@ -3961,6 +4086,15 @@ static int cam_ope_create_debug_fs(void)
 		goto err;
 	}
 
+	if (!debugfs_create_file("io_buf_pool_stats",
+		0644,
+		ope_hw_mgr->dentry, NULL,
+		&cam_ope_io_buf_pool_stats_fops)) {
+		CAM_ERR(CAM_OPE,
+			"failed to create io_buf_pool_stats");
+		goto err;
+	}
+
 	return 0;
 err:
 	debugfs_remove_recursive(ope_hw_mgr->dentry);
@@ -4025,6 +4159,8 @@ int cam_ope_hw_mgr_init(struct device_node *of_node, uint64_t *hw_mgr_hdl,
 		ope_hw_mgr->ctx[i].bits = ope_hw_mgr->ctx[i].bitmap_size *
 			BITS_PER_BYTE;
 		mutex_init(&ope_hw_mgr->ctx[i].ctx_mutex);
+		INIT_LIST_HEAD(&ope_hw_mgr->ctx[i].io_buf_pool);
+		spin_lock_init(&ope_hw_mgr->ctx[i].io_buf_pool_lock);
 	}
 
 	rc = cam_ope_mgr_init_devs(of_node);
@@ -8,6 +8,9 @@
 
 #include <linux/types.h>
 #include <linux/completion.h>
+#include <linux/list.h>
+#include <linux/spinlock.h>
+#include <linux/atomic.h>
 #include <media/cam_ope.h>
 #include "ope_hw.h"
 #include "cam_hw_mgr_intf.h"
@@ -63,6 +66,8 @@
 #define OPE_REQUEST_RT_TIMEOUT        200
 #define OPE_REQUEST_NRT_TIMEOUT        400
 
+#define OPE_IO_BUF_POOL_MAX        32
+
 /**
  * struct cam_ope_clk_bw_request_v2
  * @budget_ns: Time required to process frame
@@ -357,6 +362,7 @@ struct ope_stripe_io {
  * @num_planes:    Number of planes
  * @num_stripes:   Number of stripes
  * @s_io:          Stripe info
+ * @list:          Entry in the context io buffer pool
  */
 struct ope_io_buf {
 	uint32_t direction;
@@ -367,6 +373,7 @@ struct ope_io_buf {
 	uint32_t pix_pattern;
 	uint32_t num_stripes[OPE_MAX_PLANES];
 	struct ope_stripe_io s_io[OPE_MAX_PLANES][OPE_MAX_STRIPES];
+	struct list_head list;
 };
 
 /**
@@ -449,6 +456,9 @@ struct cam_ope_cdm {
  * @clk_watch_dog_reset_counter: Reset counter
  * @last_flush_req: last flush req for this ctx
  * @req_timer_timeout: req timer timeout value
+ * @io_buf_pool:     Free io buffers kept for reuse by later requests
+ * @io_buf_pool_cnt: Number of io buffers in the pool
+ * @io_buf_pool_lock: Lock for the io buffer pool
  */
 struct cam_ope_ctx {
 	void *context_priv;
@@ -473,6 +483,9 @@ struct cam_ope_ctx {
 	uint64_t last_flush_req;
 	bool pf_mid_found;
 	uint64_t req_timer_timeout;
+	struct list_head io_buf_pool;
+	uint32_t io_buf_pool_cnt;
+	spinlock_t io_buf_pool_lock;
 };
 
 /**
@@ -525,6 +538,8 @@ struct cam_ope_hw_intf_data {
  * @dentry:               Pointer to OPE debugfs directory
  * @frame_dump_enable:    OPE frame setting dump enablement
  * @dump_req_data_enable: OPE hang dump enablement
+ * @io_buf_pool_hit:      IO buffers served from a context pool
+ * @io_buf_pool_miss:     IO buffers that had to be allocated
  */
 struct cam_ope_hw_mgr {
 	int32_t             open_cnt;
@@ -559,6 +574,8 @@ struct cam_ope_hw_mgr {
 	struct dentry *dentry;
 	bool   frame_dump_enable;
 	bool   dump_req_data_enable;
+	atomic64_t io_buf_pool_hit;
+	atomic64_t io_buf_pool_miss;
 };
 
 /**
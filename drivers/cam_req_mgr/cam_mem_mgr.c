@@ -23,6 +23,8 @@
 static struct cam_mem_table tbl;
 static atomic_t cam_mem_mgr_state = ATOMIC_INIT(CAM_MEM_MGR_UNINITIALIZED);
 
+static void cam_mem_util_unmap(struct kref *kref);
+
 static void cam_mem_mgr_print_tbl(void)
 {
 	int i;
@@ -185,6 +187,9 @@ int cam_mem_mgr_init(void)
 	for (i = 1; i < CAM_MEM_BUFQ_MAX; i++) {
 		tbl.bufq[i].fd = -1;
 		tbl.bufq[i].buf_handle = -1;
+		seqlock_init(&tbl.bufq[i].snap_lock);
+		tbl.bufq[i].snap.buf_handle = -1;
+		tbl.bufq[i].snap.fd = -1;
 	}
 	mutex_init(&tbl.m_lock);
 
@@ -197,24 +202,68 @@ int cam_mem_mgr_init(void)
 
 static int32_t cam_mem_get_slot(void)
 {
-	int32_t idx;
+	int32_t idx = 1;
 
-	mutex_lock(&tbl.m_lock);
-	idx = find_first_zero_bit(tbl.bitmap, tbl.bits);
-	if (idx >= CAM_MEM_BUFQ_MAX || idx <= 0) {
-		mutex_unlock(&tbl.m_lock);
-		return -ENOMEM;
-	}
+	/* Slots are claimed with an atomic bit op, no table lock needed */
+	do {
+		idx = find_next_zero_bit(tbl.bitmap, CAM_MEM_BUFQ_MAX, idx);
+		if (idx >= CAM_MEM_BUFQ_MAX || idx <= 0)
+			return -ENOMEM;
+	} while (test_and_set_bit(idx, tbl.bitmap));
 
-	set_bit(idx, tbl.bitmap);
 	tbl.bufq[idx].active = true;
 	ktime_get_real_ts64(&(tbl.bufq[idx].timestamp));
 	mutex_init(&tbl.bufq[idx].q_lock);
-	mutex_unlock(&tbl.m_lock);
 
 	return idx;
 }
 
+static void cam_mem_util_publish_slot(int32_t idx)
+{
+	struct cam_mem_buf_queue *bufq = &tbl.bufq[idx];
+
+	write_seqlock(&bufq->snap_lock);
+	bufq->snap.buf_handle = bufq->buf_handle;
+	bufq->snap.fd = bufq->fd;
+	bufq->snap.flags = bufq->flags;
+	bufq->snap.len = bufq->len;
+	bufq->snap.kmdvaddr = bufq->kmdvaddr;
+	write_sequnlock(&bufq->snap_lock);
+}
+
+static void cam_mem_util_unpublish_slot(int32_t idx)
+{
+	struct cam_mem_buf_queue *bufq = &tbl.bufq[idx];
+
+	write_seqlock(&bufq->snap_lock);
+	memset(&bufq->snap, 0, sizeof(bufq->snap));
+	bufq->snap.buf_handle = -1;
+	bufq->snap.fd = -1;
+	write_sequnlock(&bufq->snap_lock);
+}
+
+static bool cam_mem_util_read_slot_seq(int32_t idx, int32_t buf_handle,
+	struct cam_mem_buf_snapshot *snap, unsigned int *seq_ptr)
+{
+	unsigned int seq;
+
+	do {
+		seq = read_seqbegin(&tbl.bufq[idx].snap_lock);
+		*snap = tbl.bufq[idx].snap;
+	} while (read_seqretry(&tbl.bufq[idx].snap_lock, seq));
+
+	*seq_ptr = seq;
+	return snap->buf_handle == buf_handle;
+}
+
+static bool cam_mem_util_read_slot(int32_t idx, int32_t buf_handle,
+	struct cam_mem_buf_snapshot *snap)
+{
+	unsigned int seq;
+
+	return cam_mem_util_read_slot_seq(idx, buf_handle, snap, &seq);
+}
+
 static void cam_mem_put_slot(int32_t idx)
 {
 	mutex_lock(&tbl.m_lock);
@@ -232,6 +281,8 @@ int cam_mem_get_io_buf(int32_t buf_handle, int32_t mmu_handle,
 	dma_addr_t *iova_ptr, size_t *len_ptr)
 {
 	int rc = 0, idx;
+	unsigned int seq;
+	struct cam_mem_buf_snapshot snap;
 
 	*len_ptr = 0;
 
@@ -250,34 +301,42 @@ int cam_mem_get_io_buf(int32_t buf_handle, int32_t mmu_handle,
 		return -EAGAIN;
 	}
 
-	mutex_lock(&tbl.bufq[idx].q_lock);
-	if (buf_handle != tbl.bufq[idx].buf_handle) {
-		rc = -EINVAL;
-		goto handle_mismatch;
-	}
+	if (!cam_mem_util_read_slot_seq(idx, buf_handle, &snap, &seq))
+		return -EINVAL;
 
 	if (CAM_MEM_MGR_IS_SECURE_HDL(buf_handle))
 		rc = cam_smmu_get_stage2_iova(mmu_handle,
-			tbl.bufq[idx].fd,
+			snap.fd,
 			iova_ptr,
 			len_ptr);
 	else
 		rc = cam_smmu_get_iova(mmu_handle,
-			tbl.bufq[idx].fd,
+			snap.fd,
 			iova_ptr,
 			len_ptr);
 	if (rc) {
 		CAM_ERR(CAM_MEM,
 			"fail to map buf_hdl:0x%x, mmu_hdl: 0x%x for fd:%d",
-			buf_handle, mmu_handle, tbl.bufq[idx].fd);
-		goto handle_mismatch;
+			buf_handle, mmu_handle, snap.fd);
+		return rc;
+	}
+
+	/*
+	 * The lookup runs without q_lock, if the buffer was released in the
+	 * meantime its fd may already name another mapping.
+	 */
+	if (read_seqretry(&tbl.bufq[idx].snap_lock, seq)) {
+		CAM_ERR(CAM_MEM,
+			"buf_hdl:0x%x released during lookup of fd:%d",
+			buf_handle, snap.fd);
+		*iova_ptr = 0;
+		*len_ptr = 0;
+		return -EINVAL;
 	}
 
 	CAM_DBG(CAM_MEM,
 		"handle:0x%x fd:%d iova_ptr:%pK len_ptr:%llu",
-		mmu_handle, tbl.bufq[idx].fd, iova_ptr, *len_ptr);
-handle_mismatch:
-	mutex_unlock(&tbl.bufq[idx].q_lock);
+		mmu_handle, snap.fd, iova_ptr, *len_ptr);
 	return rc;
 }
 EXPORT_SYMBOL(cam_mem_get_io_buf);
@@ -285,6 +344,7 @@ EXPORT_SYMBOL(cam_mem_get_io_buf);
 int cam_mem_get_cpu_buf(int32_t buf_handle, uintptr_t *vaddr_ptr, size_t *len)
 {
 	int idx;
+	struct cam_mem_buf_snapshot snap;
 
 	if (!atomic_read(&cam_mem_mgr_state)) {
 		CAM_ERR(CAM_MEM, "failed. mem_mgr not initialized");
@@ -310,27 +370,36 @@ int cam_mem_get_cpu_buf(int32_t buf_handle, uintptr_t *vaddr_ptr, size_t *len)
 		return -EPERM;
 	}
 
-	if (buf_handle != tbl.bufq[idx].buf_handle) {
+	if (!cam_mem_util_read_slot(idx, buf_handle, &snap)) {
 		CAM_ERR(CAM_MEM, "idx: %d Invalid buf handle %d",
 				idx, buf_handle);
 		return -EINVAL;
 	}
 
-	if (!(tbl.bufq[idx].flags & CAM_MEM_FLAG_KMD_ACCESS)) {
+	if (!(snap.flags & CAM_MEM_FLAG_KMD_ACCESS)) {
 		CAM_ERR(CAM_MEM, "idx: %d Invalid flag 0x%x",
-					idx, tbl.bufq[idx].flags);
+					idx, snap.flags);
 		return -EINVAL;
 	}
 
-	if (tbl.bufq[idx].kmdvaddr && kref_get_unless_zero(&tbl.bufq[idx].krefcount)) {
-		*vaddr_ptr = tbl.bufq[idx].kmdvaddr;
-		*len = tbl.bufq[idx].len;
-	} else {
+	if (!snap.kmdvaddr ||
+		!kref_get_unless_zero(&tbl.bufq[idx].krefcount)) {
 		CAM_ERR(CAM_MEM, "No KMD access requested, kmdvddr= %p, idx= %d, buf_handle= %d",
-			tbl.bufq[idx].kmdvaddr, idx, buf_handle);
+			snap.kmdvaddr, idx, buf_handle);
 		return -EINVAL;
 	}
 
+	/* The slot may have been released and reused before the ref was taken */
+	if (!cam_mem_util_read_slot(idx, buf_handle, &snap)) {
+		kref_put(&tbl.bufq[idx].krefcount, cam_mem_util_unmap);
+		CAM_ERR(CAM_MEM, "idx: %d buf handle %d released", idx,
+			buf_handle);
+		return -EINVAL;
+	}
+
+	*vaddr_ptr = snap.kmdvaddr;
+	*len = snap.len;
+
 	return 0;
 }
 EXPORT_SYMBOL(cam_mem_get_cpu_buf);
@@ -770,6 +839,7 @@ int cam_mem_mgr_alloc_and_map(struct cam_mem_mgr_alloc_cmd *cmd)
 	tbl.bufq[idx].is_imported = false;
 	kref_init(&tbl.bufq[idx].krefcount);
 	tbl.bufq[idx].smmu_mapping_client = CAM_SMMU_MAPPING_USER;
+	cam_mem_util_publish_slot(idx);
 	mutex_unlock(&tbl.bufq[idx].q_lock);
 
 	cmd->out.buf_handle = tbl.bufq[idx].buf_handle;
@@ -905,6 +975,7 @@ int cam_mem_mgr_map(struct cam_mem_mgr_map_cmd *cmd)
 	tbl.bufq[idx].is_internal = is_internal;
 	kref_init(&tbl.bufq[idx].krefcount);
 	tbl.bufq[idx].smmu_mapping_client = CAM_SMMU_MAPPING_USER;
+	cam_mem_util_publish_slot(idx);
 	mutex_unlock(&tbl.bufq[idx].q_lock);
 
 	cmd->out.buf_handle = tbl.bufq[idx].buf_handle;
@@ -1022,6 +1093,7 @@ static int cam_mem_mgr_cleanup_table(void)
 		}
 
 		mutex_lock(&tbl.bufq[i].q_lock);
+		cam_mem_util_unpublish_slot(i);
 		if (tbl.bufq[i].dma_buf) {
 			dma_buf_put(tbl.bufq[i].dma_buf);
 			tbl.bufq[i].dma_buf = NULL;
@@ -1093,6 +1165,7 @@ static void cam_mem_util_unmap(struct kref *kref)
 
 	/* Deactivate the buffer queue to prevent multiple unmap */
 	mutex_lock(&tbl.bufq[idx].q_lock);
+	cam_mem_util_unpublish_slot(idx);
 	tbl.bufq[idx].active = false;
 	tbl.bufq[idx].vaddr = 0;
 	mutex_unlock(&tbl.bufq[idx].q_lock);
@@ -1356,6 +1429,7 @@ int cam_mem_mgr_request_mem(struct cam_mem_mgr_request_desc *inp,
 	tbl.bufq[idx].is_imported = false;
 	kref_init(&tbl.bufq[idx].krefcount);
 	tbl.bufq[idx].smmu_mapping_client = CAM_SMMU_MAPPING_KERNEL;
+	cam_mem_util_publish_slot(idx);
 	mutex_unlock(&tbl.bufq[idx].q_lock);
 
 	out->kva = kvaddr;
@@ -1512,6 +1586,7 @@ int cam_mem_mgr_reserve_memory_region(struct cam_mem_mgr_request_desc *inp,
 	tbl.bufq[idx].is_imported = false;
 	kref_init(&tbl.bufq[idx].krefcount);
 	tbl.bufq[idx].smmu_mapping_client = CAM_SMMU_MAPPING_KERNEL;
+	cam_mem_util_publish_slot(idx);
 	mutex_unlock(&tbl.bufq[idx].q_lock);
 
 	out->kva = 0;
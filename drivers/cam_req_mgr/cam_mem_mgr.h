@@ -8,6 +8,7 @@
 #define _CAM_MEM_MGR_H_
 
 #include <linux/mutex.h>
+#include <linux/seqlock.h>
 #include <linux/dma-buf.h>
 #include <media/cam_req_mgr.h>
 #include "cam_mem_mgr_api.h"
@@ -24,6 +25,23 @@ enum cam_smmu_mapping_client {
 	CAM_SMMU_MAPPING_KERNEL,
 };
 
+/**
+ * struct cam_mem_buf_snapshot
+ *
+ * @buf_handle:     unique handle for buffer, -1 when not published
+ * @fd:             file descriptor of buffer
+ * @flags:          attributes of buffer
+ * @len:            size of buffer
+ * @kmdvaddr:       Kernel virtual address
+ */
+struct cam_mem_buf_snapshot {
+	int32_t buf_handle;
+	int32_t fd;
+	uint32_t flags;
+	size_t len;
+	uintptr_t kmdvaddr;
+};
+
 /**
  * struct cam_mem_buf_queue
  *
@@ -45,6 +63,9 @@ enum cam_smmu_mapping_client {
  * @krefcount:      Reference counter to track whether the buffer is
  *                  mapped and in use
  * @smmu_mapping_client: Client buffer (User or kernel)
+ * @snap_lock:      seqlock protecting the published snapshot
+ * @snap:           copy of the fields lookups need, published once the
+ *                  buffer is fully set up so readers need not take q_lock
  */
 struct cam_mem_buf_queue {
 	struct dma_buf *dma_buf;
@@ -64,6 +85,8 @@ struct cam_mem_buf_queue {
 	struct timespec64 timestamp;
 	struct kref krefcount;
 	enum cam_smmu_mapping_client smmu_mapping_client;
+	seqlock_t snap_lock;
+	struct cam_mem_buf_snapshot snap;
 };
 
 /**
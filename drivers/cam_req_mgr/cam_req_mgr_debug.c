@@ -4,8 +4,10 @@
  */
 
 #include "cam_req_mgr_debug.h"
+#include "cam_req_mgr_workq.h"
 
 #define MAX_SESS_INFO_LINE_BUFF_LEN 256
+#define CAM_REQ_MGR_WORKQ_STATS_BUF_SIZE (16 * 1024)
 
 static char sess_info_buffer[MAX_SESS_INFO_LINE_BUFF_LEN];
 static int cam_debug_mgr_delay_detect;
@@ -111,6 +113,40 @@ static const struct file_operations session_info = {
 	.write = session_info_write,
 };
 
+static ssize_t workq_stats_read(struct file *t_file, char *t_char,
+	size_t t_size_t, loff_t *t_loff_t)
+{
+	char *out_buffer;
+	ssize_t rc;
+	int len;
+
+	out_buffer = kzalloc(CAM_REQ_MGR_WORKQ_STATS_BUF_SIZE, GFP_KERNEL);
+	if (!out_buffer)
+		return -ENOMEM;
+
+	len = cam_req_mgr_workq_dump_stats(out_buffer,
+		CAM_REQ_MGR_WORKQ_STATS_BUF_SIZE);
+	rc = simple_read_from_buffer(t_char, t_size_t,
+		t_loff_t, out_buffer, len);
+	kfree(out_buffer);
+
+	return rc;
+}
+
+static ssize_t workq_stats_write(struct file *t_file,
+	const char *t_char, size_t t_size_t, loff_t *t_loff_t)
+{
+	cam_req_mgr_workq_reset_stats();
+
+	return t_size_t;
+}
+
+static const struct file_operations workq_stats = {
+	.open = session_info_open,
+	.read = workq_stats_read,
+	.write = workq_stats_write,
+};
+
 static struct dentry *debugfs_root;
 int cam_req_mgr_debug_register(struct cam_req_mgr_core_device *core_dev)
 {
@@ -132,6 +168,8 @@ int cam_req_mgr_debug_register(struct cam_req_mgr_core_device *core_dev)
 		debugfs_root, core_dev, &bubble_recovery);
 	dbgfileptr = debugfs_create_bool("recovery_on_apply_fail", 0644,
 		debugfs_root, &core_dev->recovery_on_apply_fail);
+	dbgfileptr = debugfs_create_file("workq_stats", 0644,
+		debugfs_root, core_dev, &workq_stats);
 	dbgfileptr = debugfs_create_u32("delay_detect_count", 0644,
 		debugfs_root, &cam_debug_mgr_delay_detect);
 	if (IS_ERR(dbgfileptr)) {
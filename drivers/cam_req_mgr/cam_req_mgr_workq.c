@@ -21,47 +21,82 @@
 		spin_unlock_bh(&(workq)->lock_bh); \
 }
 
+static LIST_HEAD(g_workq_list);
+static DEFINE_MUTEX(g_workq_list_lock);
+
+static inline void cam_req_mgr_workq_update_max(atomic_t *max, int val)
+{
+	int old = atomic_read(max), prev;
+
+	while (val > old) {
+		prev = atomic_cmpxchg(max, old, val);
+		if (prev == old)
+			break;
+		old = prev;
+	}
+}
+
+static void cam_req_mgr_workq_update_depth(
+	struct cam_req_mgr_core_workq *workq, int depth)
+{
+	int bucket;
+
+	if (depth <= 0)
+		return;
+
+	bucket = min_t(int, fls(depth) - 1, CAM_WORKQ_DEPTH_BUCKETS - 1);
+	atomic_inc(&workq->stats.depth[bucket]);
+	cam_req_mgr_workq_update_max(&workq->stats.max_depth, depth);
+}
+
+static void cam_req_mgr_workq_update_latency(
+	struct cam_req_mgr_core_workq *workq, ktime_t enqueue_ts)
+{
+	int64_t lat_us = ktime_us_delta(ktime_get(), enqueue_ts);
+	int bucket;
+
+	if (lat_us < 0)
+		lat_us = 0;
+
+	bucket = min_t(int, fls64(lat_us >> 6),
+		CAM_WORKQ_LATENCY_BUCKETS - 1);
+	atomic_inc(&workq->stats.latency[bucket]);
+	cam_req_mgr_workq_update_max(&workq->stats.max_lat_us,
+		(int)min_t(int64_t, lat_us, INT_MAX));
+}
+
 struct crm_workq_task *cam_req_mgr_workq_get_task(
 	struct cam_req_mgr_core_workq *workq)
 {
-	struct crm_workq_task *task = NULL;
-	unsigned long flags = 0;
+	uint32_t idx = 0;
 
 	if (!workq)
 		return NULL;
 
-	WORKQ_ACQUIRE_LOCK(workq, flags);
-	if (list_empty(&workq->task.empty_head))
-		goto end;
+	do {
+		idx = find_next_zero_bit(workq->task.used_map,
+			workq->task.num_task, idx);
+		if (idx >= workq->task.num_task) {
+			atomic_inc(&workq->stats.get_fail);
+			return NULL;
+		}
+	} while (test_and_set_bit(idx, workq->task.used_map));
 
-	task = list_first_entry(&workq->task.empty_head,
-		struct crm_workq_task, entry);
-	if (task) {
-		atomic_sub(1, &workq->task.free_cnt);
-		list_del_init(&task->entry);
-	}
+	atomic_sub(1, &workq->task.free_cnt);
 
-end:
-	WORKQ_RELEASE_LOCK(workq, flags);
-
-	return task;
+	return &workq->task.pool[idx];
 }
 
 static void cam_req_mgr_workq_put_task(struct crm_workq_task *task)
 {
 	struct cam_req_mgr_core_workq *workq =
 		(struct cam_req_mgr_core_workq *)task->parent;
-	unsigned long flags = 0;
 
-	list_del_init(&task->entry);
 	task->cancel = 0;
 	task->process_cb = NULL;
 	task->priv = NULL;
-	WORKQ_ACQUIRE_LOCK(workq, flags);
-	list_add_tail(&task->entry,
-		&workq->task.empty_head);
 	atomic_add(1, &workq->task.free_cnt);
-	WORKQ_RELEASE_LOCK(workq, flags);
+	clear_bit_unlock(task - workq->task.pool, workq->task.used_map);
 }
 
 /**
@@ -92,9 +127,9 @@ static int cam_req_mgr_process_task(struct crm_workq_task *task)
 void cam_req_mgr_process_workq(struct work_struct *w)
 {
 	struct cam_req_mgr_core_workq *workq = NULL;
-	struct crm_workq_task         *task;
+	struct crm_workq_task         *task, *next;
+	struct llist_node             *batch;
 	int32_t                        i = CRM_TASK_PRIORITY_0;
-	unsigned long                  flags = 0;
 	ktime_t                        curr_time;
 
 	if (!w) {
@@ -110,20 +145,26 @@ void cam_req_mgr_process_workq(struct work_struct *w)
 		CAM_WORKQ_SCHEDULE_TIME_THRESHOLD);
 	curr_time = ktime_get();
 	while (i < CRM_TASK_PRIORITY_MAX) {
-		WORKQ_ACQUIRE_LOCK(workq, flags);
-		while (!list_empty(&workq->task.process_head[i])) {
-			task = list_first_entry(&workq->task.process_head[i],
-				struct crm_workq_task, entry);
+		batch = llist_del_all(&workq->task.process_head[i]);
+		if (!batch) {
+			i++;
+			continue;
+		}
+
+		/* llist hands back newest first, restore FIFO order */
+		batch = llist_reverse_order(batch);
+		atomic_inc(&workq->stats.batches);
+		llist_for_each_entry_safe(task, next, batch, node) {
 			atomic_sub(1, &workq->task.pending_cnt);
-			list_del_init(&task->entry);
-			WORKQ_RELEASE_LOCK(workq, flags);
+			cam_req_mgr_workq_update_latency(workq,
+				task->enqueue_ts);
 			cam_req_mgr_process_task(task);
 			CAM_DBG(CAM_CRM, "processed task %pK free_cnt %d",
 				task, atomic_read(&workq->task.free_cnt));
-			WORKQ_ACQUIRE_LOCK(workq, flags);
 		}
-		WORKQ_RELEASE_LOCK(workq, flags);
-		i++;
+
+		/* Higher priority tasks may have arrived meanwhile */
+		i = CRM_TASK_PRIORITY_0;
 	}
 	cam_common_util_thread_switch_delay_detect(
 		"CRM workq execution",
@@ -134,7 +175,7 @@ void cam_req_mgr_process_workq(struct work_struct *w)
 int cam_req_mgr_workq_enqueue_task(struct crm_workq_task *task,
 	void *priv, int32_t prio)
 {
-	int rc = 0;
+	int rc = 0, depth;
 	struct cam_req_mgr_core_workq *workq = NULL;
 	unsigned long flags = 0;
 
@@ -156,27 +197,39 @@ int cam_req_mgr_workq_enqueue_task(struct crm_workq_task *task,
 		rc = 0;
 		goto end;
 	}
+
+	WORKQ_ACQUIRE_LOCK(workq, flags);
+	if (!workq->job) {
+		WORKQ_RELEASE_LOCK(workq, flags);
+		rc = -EINVAL;
+		goto end;
+	}
+	WORKQ_RELEASE_LOCK(workq, flags);
+
 	task->priv = priv;
 	task->priority =
 		(prio < CRM_TASK_PRIORITY_MAX && prio >= CRM_TASK_PRIORITY_0)
 		? prio : CRM_TASK_PRIORITY_0;
+	task->enqueue_ts = ktime_get();
+
+	depth = atomic_add_return(1, &workq->task.pending_cnt);
+	cam_req_mgr_workq_update_depth(workq, depth);
+	CAM_DBG(CAM_CRM, "enq task %pK pending_cnt %d", task, depth);
+
+	/*
+	 * Only the producer that makes a list non-empty needs to kick
+	 * the worker, anyone else is picked up by the pending drain.
+	 */
+	if (!llist_add(&task->node,
+		&workq->task.process_head[task->priority]))
+		goto end;
 
+	/* A workq destroyed meanwhile frees its task pool with the task */
 	WORKQ_ACQUIRE_LOCK(workq, flags);
-		if (!workq->job) {
-			rc = -EINVAL;
-			WORKQ_RELEASE_LOCK(workq, flags);
-			goto end;
-		}
-
-	list_add_tail(&task->entry,
-		&workq->task.process_head[task->priority]);
-
-	atomic_add(1, &workq->task.pending_cnt);
-	CAM_DBG(CAM_CRM, "enq task %pK pending_cnt %d",
-		task, atomic_read(&workq->task.pending_cnt));
-
-	queue_work(workq->job, &workq->work);
-	workq->workq_scheduled_ts = ktime_get();
+	if (workq->job) {
+		queue_work(workq->job, &workq->work);
+		workq->workq_scheduled_ts = ktime_get();
+	}
 	WORKQ_RELEASE_LOCK(workq, flags);
 end:
 	return rc;
@@ -187,7 +240,6 @@ int cam_req_mgr_workq_create(char *name, int32_t num_tasks,
 	int flags, void (*func)(struct work_struct *w))
 {
 	int32_t i, wq_flags = 0, max_active_tasks = 0;
-	struct crm_workq_task  *task;
 	struct cam_req_mgr_core_workq *crm_workq = NULL;
 	char buf[128] = "crm_workq-";
 
@@ -221,29 +273,37 @@ int cam_req_mgr_workq_create(char *name, int32_t num_tasks,
 
 		/* Task attributes initialization */
 		atomic_set(&crm_workq->task.pending_cnt, 0);
-		atomic_set(&crm_workq->task.free_cnt, 0);
 		for (i = CRM_TASK_PRIORITY_0; i < CRM_TASK_PRIORITY_MAX; i++)
-			INIT_LIST_HEAD(&crm_workq->task.process_head[i]);
-		INIT_LIST_HEAD(&crm_workq->task.empty_head);
+			init_llist_head(&crm_workq->task.process_head[i]);
 		crm_workq->in_irq = in_irq;
 		crm_workq->task.num_task = num_tasks;
 		crm_workq->task.pool = kcalloc(crm_workq->task.num_task,
 				sizeof(struct crm_workq_task), GFP_KERNEL);
-		if (!crm_workq->task.pool) {
+		crm_workq->task.used_map = kcalloc(
+			BITS_TO_LONGS(crm_workq->task.num_task),
+			sizeof(long), GFP_KERNEL);
+		if (!crm_workq->task.pool || !crm_workq->task.used_map) {
 			CAM_WARN(CAM_CRM, "Insufficient memory %zu",
 				sizeof(struct crm_workq_task) *
 				crm_workq->task.num_task);
+			kfree(crm_workq->task.used_map);
+			kfree(crm_workq->task.pool);
+			destroy_workqueue(crm_workq->job);
 			kfree(crm_workq);
 			return -ENOMEM;
 		}
 
-		for (i = 0; i < crm_workq->task.num_task; i++) {
-			task = &crm_workq->task.pool[i];
-			task->parent = (void *)crm_workq;
-			/* Put all tasks in free pool */
-			INIT_LIST_HEAD(&task->entry);
-			cam_req_mgr_workq_put_task(task);
-		}
+		/* All tasks start out free */
+		for (i = 0; i < crm_workq->task.num_task; i++)
+			crm_workq->task.pool[i].parent = (void *)crm_workq;
+		atomic_set(&crm_workq->task.free_cnt,
+			crm_workq->task.num_task);
+
+		strlcpy(crm_workq->name, name, sizeof(crm_workq->name));
+		mutex_lock(&g_workq_list_lock);
+		list_add_tail(&crm_workq->list, &g_workq_list);
+		mutex_unlock(&g_workq_list_lock);
+
 		*workq = crm_workq;
 		CAM_DBG(CAM_CRM, "free tasks %d",
 			atomic_read(&crm_workq->task.free_cnt));
@@ -259,6 +319,10 @@ void cam_req_mgr_workq_destroy(struct cam_req_mgr_core_workq **crm_workq)
 
 	CAM_DBG(CAM_CRM, "destroy workque %pK", crm_workq);
 	if (*crm_workq) {
+		mutex_lock(&g_workq_list_lock);
+		list_del_init(&(*crm_workq)->list);
+		mutex_unlock(&g_workq_list_lock);
+
 		WORKQ_ACQUIRE_LOCK(*crm_workq, flags);
 		if ((*crm_workq)->job) {
 			job = (*crm_workq)->job;
@@ -273,7 +337,55 @@ void cam_req_mgr_workq_destroy(struct cam_req_mgr_core_workq **crm_workq)
 		kfree((*crm_workq)->task.pool[0].payload);
 		(*crm_workq)->task.pool[0].payload = NULL;
 		kfree((*crm_workq)->task.pool);
+		kfree((*crm_workq)->task.used_map);
 		kfree(*crm_workq);
 		*crm_workq = NULL;
 	}
 }
+
+int cam_req_mgr_workq_dump_stats(char *buf, size_t size)
+{
+	struct cam_req_mgr_core_workq *workq;
+	int len = 0, i;
+
+	mutex_lock(&g_workq_list_lock);
+	list_for_each_entry(workq, &g_workq_list, list) {
+		len += scnprintf(buf + len, size - len,
+			"%s: pending %d free %d/%u batches %d get_fail %d max_lat %dus max_depth %d\n",
+			workq->name, atomic_read(&workq->task.pending_cnt),
+			atomic_read(&workq->task.free_cnt),
+			workq->task.num_task,
+			atomic_read(&workq->stats.batches),
+			atomic_read(&workq->stats.get_fail),
+			atomic_read(&workq->stats.max_lat_us),
+			atomic_read(&workq->stats.max_depth));
+
+		len += scnprintf(buf + len, size - len, "  lat_us");
+		for (i = 0; i < CAM_WORKQ_LATENCY_BUCKETS - 1; i++)
+			len += scnprintf(buf + len, size - len, " <%d:%d",
+				64 << i, atomic_read(&workq->stats.latency[i]));
+		len += scnprintf(buf + len, size - len, " >=%d:%d\n",
+			64 << (CAM_WORKQ_LATENCY_BUCKETS - 2),
+			atomic_read(&workq->stats.latency[i]));
+
+		len += scnprintf(buf + len, size - len, "  depth");
+		for (i = 0; i < CAM_WORKQ_DEPTH_BUCKETS - 1; i++)
+			len += scnprintf(buf + len, size - len, " %d:%d",
+				1 << i, atomic_read(&workq->stats.depth[i]));
+		len += scnprintf(buf + len, size - len, " %d+:%d\n",
+			1 << i, atomic_read(&workq->stats.depth[i]));
+	}
+	mutex_unlock(&g_workq_list_lock);
+
+	return len;
+}
+
+void cam_req_mgr_workq_reset_stats(void)
+{
+	struct cam_req_mgr_core_workq *workq;
+
+	mutex_lock(&g_workq_list_lock);
+	list_for_each_entry(workq, &g_workq_list, list)
+		memset(&workq->stats, 0, sizeof(workq->stats));
+	mutex_unlock(&g_workq_list_lock);
+}
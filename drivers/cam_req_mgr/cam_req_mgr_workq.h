@@ -13,6 +13,7 @@
 #include <linux/workqueue.h>
 #include <linux/slab.h>
 #include <linux/timer.h>
+#include <linux/llist.h>
 
 #include "cam_req_mgr_core.h"
 
@@ -32,6 +33,21 @@
  */
 #define CAM_WORKQ_FLAG_SERIAL                    (1 << 1)
 
+/* Max length of workq name kept for stats */
+#define CAM_WORKQ_NAME_LEN                       64
+
+/*
+ * Enqueue to execute latency histogram, bucket n counts tasks
+ * with latency below (64us << n), last bucket is open ended
+ */
+#define CAM_WORKQ_LATENCY_BUCKETS                8
+
+/*
+ * Queue depth histogram sampled at enqueue, bucket n counts
+ * depths in [2^n, 2^(n+1)), last bucket is open ended
+ */
+#define CAM_WORKQ_DEPTH_BUCKETS                  6
+
 /* Task priorities, lower the number higher the priority*/
 enum crm_task_priority {
 	CRM_TASK_PRIORITY_0,
@@ -52,7 +68,8 @@ enum crm_workq_context {
  * @process_cb : registered callback called by workq when task enqueued is
  *               ready for processing in workq thread context
  * @parent     : workq's parent is link which is enqqueing taks to this workq
- * @entry      : list head of this list entry is worker's empty_head
+ * @node       : node on one of the worker's per priority process lists
+ * @enqueue_ts : time the task was enqueued, used for latency stats
  * @cancel     : if caller has got free task from pool but wants to abort
  *               or put back without using it
  * @priv       : when task is enqueuer caller can attach priv along which
@@ -64,25 +81,46 @@ struct crm_workq_task {
 	void                      *payload;
 	int32_t                  (*process_cb)(void *priv, void *data);
 	void                      *parent;
-	struct list_head           entry;
+	struct llist_node          node;
+	ktime_t                    enqueue_ts;
 	uint8_t                    cancel;
 	void                      *priv;
 	int32_t                    ret;
 };
 
+/** struct cam_req_mgr_workq_stats
+ * @latency     : enqueue to execute latency histogram
+ * @depth       : pending task count histogram sampled at enqueue
+ * @max_lat_us  : worst enqueue to execute latency seen
+ * @max_depth   : deepest queue seen
+ * @batches     : number of batches drained by the worker
+ * @get_fail    : get_task calls that found the pool empty
+ */
+struct cam_req_mgr_workq_stats {
+	atomic_t                   latency[CAM_WORKQ_LATENCY_BUCKETS];
+	atomic_t                   depth[CAM_WORKQ_DEPTH_BUCKETS];
+	atomic_t                   max_lat_us;
+	atomic_t                   max_depth;
+	atomic_t                   batches;
+	atomic_t                   get_fail;
+};
+
 /** struct cam_req_mgr_core_workq
  * @work        : work token used by workqueue
  * @job         : workqueue internal job struct
- * @lock_bh     : lock for task structs
+ * @lock_bh     : lock serializing work scheduling against destroy
  * @in_irq      : set true if workque can be used in irq context
  * @workq_scheduled_ts: enqueue time of workq
+ * @name        : name of the workq, used in stats dump
+ * @list        : entry in the global list of workqs
+ * @stats       : depth and latency histograms
  * task -
  * @lock        : Current task's lock handle
  * @pending_cnt : # of tasks left in queue
  * @free_cnt    : # of free/available tasks
- * @process_head:
- * @empty_head  : list  head of available taska which can be used
- *                or acquired in order to enqueue a task to workq
+ * @process_head: lock free multi producer lists, one per priority,
+ *                drained in batches by the worker
+ * @used_map    : bitmap of tasks in use, claimed with atomic bit ops
  * @pool        : pool of tasks used for handling events in workq context
  * @num_task    : size of tasks pool
  */
@@ -92,6 +130,9 @@ struct cam_req_mgr_core_workq {
 	spinlock_t                 lock_bh;
 	uint32_t                   in_irq;
 	ktime_t                    workq_scheduled_ts;
+	char                       name[CAM_WORKQ_NAME_LEN];
+	struct list_head           list;
+	struct cam_req_mgr_workq_stats stats;
 
 	/* tasks */
 	struct {
@@ -99,8 +140,8 @@ struct cam_req_mgr_core_workq {
 		atomic_t               pending_cnt;
 		atomic_t               free_cnt;
 
-		struct list_head       process_head[CRM_TASK_PRIORITY_MAX];
-		struct list_head       empty_head;
+		struct llist_head      process_head[CRM_TASK_PRIORITY_MAX];
+		unsigned long         *used_map;
 		struct crm_workq_task *pool;
 		uint32_t               num_task;
 	} task;
@@ -158,4 +199,19 @@ int cam_req_mgr_workq_enqueue_task(struct crm_workq_task *task,
 struct crm_workq_task *cam_req_mgr_workq_get_task(
 	struct cam_req_mgr_core_workq *workq);
 
+/**
+ * cam_req_mgr_workq_dump_stats()
+ * @brief: Print depth and latency histograms of all workqs
+ * @buf  : output buffer
+ * @size : size of output buffer
+ * Returns number of bytes written
+ */
+int cam_req_mgr_workq_dump_stats(char *buf, size_t size);
+
+/**
+ * cam_req_mgr_workq_reset_stats()
+ * @brief: Clear depth and latency histograms of all workqs
+ */
+void cam_req_mgr_workq_reset_stats(void);
+
 #endif
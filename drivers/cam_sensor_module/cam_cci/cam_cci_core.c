@@ -8,6 +8,7 @@
 #include "cam_cci_dev.h"
 #include "cam_req_mgr_workq.h"
 #include "cam_common_util.h"
+#include "cam_compat.h"
 
 static int32_t cam_cci_convert_type_to_num_bytes(
 	enum camera_sensor_i2c_type type)
@@ -1496,13 +1497,75 @@ ERROR:
 	return rc;
 }
 
-static void cam_cci_write_async_helper(struct work_struct *work)
+static void cam_cci_write_async_helper(struct kthread_work *work);
+
+static struct cci_write_async *cam_cci_async_get_entry(
+	struct cci_device *cci_dev, enum cci_i2c_master_t master,
+	enum cci_i2c_queue_t queue)
+{
+	struct cam_cci_async_ring *ring = cci_dev->async_ring[master][queue];
+	struct cam_cci_async_stats *stats =
+		&cci_dev->async_stats[master][queue];
+	struct cci_write_async *write_async;
+	int idx;
+
+	if (ring) {
+		for (idx = 0; idx < CCI_ASYNC_RING_SIZE; idx++) {
+			if (test_and_set_bit_lock(idx, &ring->used_map))
+				continue;
+			return &ring->slot[idx];
+		}
+	}
+
+	/* Ring exhausted, keep the write rather than drop it */
+	atomic64_inc(&stats->overflow);
+	write_async = kzalloc(sizeof(*write_async), GFP_KERNEL);
+	if (!write_async)
+		return NULL;
+
+	write_async->slot = -1;
+	kthread_init_work(&write_async->work, cam_cci_write_async_helper);
+
+	return write_async;
+}
+
+static void cam_cci_async_put_entry(struct cci_device *cci_dev,
+	enum cci_i2c_master_t master, struct cci_write_async *write_async)
+{
+	struct cam_sensor_i2c_reg_setting *i2c_msg =
+		&write_async->c_ctrl.cfg.cci_i2c_write_cfg;
+
+	if (i2c_msg->reg_setting != write_async->regs)
+		kfree(i2c_msg->reg_setting);
+	i2c_msg->reg_setting = NULL;
+
+	if (write_async->slot < 0)
+		kfree(write_async);
+	else
+		clear_bit_unlock(write_async->slot,
+			&cci_dev->async_ring[master][write_async->queue]->used_map);
+}
+
+static void cam_cci_async_update_latency(struct cam_cci_async_stats *stats,
+	ktime_t enqueue_ts)
+{
+	uint64_t lat_us;
+	int bucket;
+
+	lat_us = ktime_us_delta(ktime_get(), enqueue_ts);
+	bucket = min_t(int, fls64(lat_us >> 6),
+		CCI_ASYNC_LATENCY_BUCKETS - 1);
+	atomic_inc(&stats->latency[bucket]);
+	if (lat_us > (uint32_t)atomic_read(&stats->max_lat_us))
+		atomic_set(&stats->max_lat_us, (int)lat_us);
+}
+
+static void cam_cci_write_async_helper(struct kthread_work *work)
 {
 	int rc;
 	struct cci_device *cci_dev;
 	struct cci_write_async *write_async =
 		container_of(work, struct cci_write_async, work);
-	struct cam_sensor_i2c_reg_setting *i2c_msg;
 	enum cci_i2c_master_t master;
 	struct cam_cci_master_info *cci_master_info;
 
@@ -1511,77 +1574,95 @@ static void cam_cci_write_async_helper(struct work_struct *work)
 		write_async->workq_scheduled_ts,
 		CAM_WORKQ_SCHEDULE_TIME_THRESHOLD);
 	cci_dev = write_async->cci_dev;
-	i2c_msg = &write_async->c_ctrl.cfg.cci_i2c_write_cfg;
 	master = write_async->c_ctrl.cci_info->cci_i2c_master;
 	cci_master_info = &cci_dev->cci_master_info[master];
 
 	mutex_lock(&cci_master_info->mutex_q[write_async->queue]);
+	cam_cci_async_update_latency(
+		&cci_dev->async_stats[master][write_async->queue],
+		write_async->workq_scheduled_ts);
 	rc = cam_cci_i2c_write(&(cci_dev->v4l2_dev_str.sd),
 		&write_async->c_ctrl, write_async->queue, write_async->sync_en);
 	mutex_unlock(&cci_master_info->mutex_q[write_async->queue]);
 	if (rc < 0)
 		CAM_ERR(CAM_CCI, "Failed rc: %d", rc);
 
-	kfree(write_async->c_ctrl.cfg.cci_i2c_write_cfg.reg_setting);
-	kfree(write_async);
+	atomic_dec(&cci_dev->async_stats[master][write_async->queue].depth);
+	cam_cci_async_put_entry(cci_dev, master, write_async);
 }
 
 static int32_t cam_cci_i2c_write_async(struct v4l2_subdev *sd,
 	struct cam_cci_ctrl *c_ctrl, enum cci_i2c_queue_t queue,
 	enum cci_i2c_sync sync_en)
 {
-	int32_t rc = 0;
 	struct cci_write_async *write_async;
 	struct cci_device *cci_dev;
 	struct cam_sensor_i2c_reg_setting *cci_i2c_write_cfg;
 	struct cam_sensor_i2c_reg_setting *cci_i2c_write_cfg_w;
+	struct cam_cci_async_stats *stats;
+	enum cci_i2c_master_t master;
+	int depth;
 
 	cci_dev = v4l2_get_subdevdata(sd);
+	master = c_ctrl->cci_info->cci_i2c_master;
+	cci_i2c_write_cfg = &c_ctrl->cfg.cci_i2c_write_cfg;
+	stats = &cci_dev->async_stats[master][queue];
 
-	write_async = kzalloc(sizeof(*write_async), GFP_KERNEL);
+	if (cci_i2c_write_cfg->size == 0)
+		return -EINVAL;
+
+	if (!cci_dev->write_worker[master]) {
+		CAM_ERR(CAM_CCI, "No write worker for master: %d", master);
+		return -ENODEV;
+	}
+
+	write_async = cam_cci_async_get_entry(cci_dev, master, queue);
 	if (!write_async) {
 		CAM_ERR(CAM_CCI, "Memory allocation failed for write_async");
+		atomic64_inc(&stats->drops);
 		return -ENOMEM;
 	}
 
-
-	INIT_WORK(&write_async->work, cam_cci_write_async_helper);
 	write_async->cci_dev = cci_dev;
 	write_async->c_ctrl = *c_ctrl;
 	write_async->queue = queue;
 	write_async->sync_en = sync_en;
 
-	cci_i2c_write_cfg = &c_ctrl->cfg.cci_i2c_write_cfg;
 	cci_i2c_write_cfg_w = &write_async->c_ctrl.cfg.cci_i2c_write_cfg;
 
-	if (cci_i2c_write_cfg->size == 0) {
-		kfree(write_async);
-		return -EINVAL;
-	}
-
-	cci_i2c_write_cfg_w->reg_setting =
-		kzalloc(sizeof(struct cam_sensor_i2c_reg_array)*
-		cci_i2c_write_cfg->size, GFP_KERNEL);
-	if (!cci_i2c_write_cfg_w->reg_setting) {
-		CAM_ERR(CAM_CCI, "Couldn't allocate memory for reg_setting");
-		kfree(write_async);
-		return -ENOMEM;
+	if (cci_i2c_write_cfg->size <= CCI_ASYNC_INLINE_REGS) {
+		cci_i2c_write_cfg_w->reg_setting = write_async->regs;
+	} else {
+		cci_i2c_write_cfg_w->reg_setting =
+			kmalloc_array(cci_i2c_write_cfg->size,
+			sizeof(struct cam_sensor_i2c_reg_array), GFP_KERNEL);
+		if (!cci_i2c_write_cfg_w->reg_setting) {
+			CAM_ERR(CAM_CCI,
+				"Couldn't allocate memory for reg_setting");
+			atomic64_inc(&stats->drops);
+			cam_cci_async_put_entry(cci_dev, master, write_async);
+			return -ENOMEM;
+		}
 	}
 	memcpy(cci_i2c_write_cfg_w->reg_setting,
 		cci_i2c_write_cfg->reg_setting,
 		(sizeof(struct cam_sensor_i2c_reg_array)*
 						cci_i2c_write_cfg->size));
 
-	cci_i2c_write_cfg_w->addr_type = cci_i2c_write_cfg->addr_type;
 	cci_i2c_write_cfg_w->addr_type = cci_i2c_write_cfg->addr_type;
 	cci_i2c_write_cfg_w->data_type = cci_i2c_write_cfg->data_type;
 	cci_i2c_write_cfg_w->size = cci_i2c_write_cfg->size;
 	cci_i2c_write_cfg_w->delay = cci_i2c_write_cfg->delay;
 
+	depth = atomic_inc_return(&stats->depth);
+	if (depth > atomic_read(&stats->max_depth))
+		atomic_set(&stats->max_depth, depth);
+	atomic64_inc(&stats->queued);
+
 	write_async->workq_scheduled_ts = ktime_get();
-	queue_work(cci_dev->write_wq[write_async->queue], &write_async->work);
+	kthread_queue_work(cci_dev->write_worker[master], &write_async->work);
 
-	return rc;
+	return 0;
 }
 
 static int32_t cam_cci_read_bytes_v_1_2(struct v4l2_subdev *sd,
@@ -1916,3 +1997,117 @@ int32_t cam_cci_core_cfg(struct v4l2_subdev *sd,
 
 	return rc;
 }
+
+int cam_cci_async_init(struct cci_device *cci_dev)
+{
+	struct cam_cci_async_ring *ring;
+	struct kthread_worker *worker;
+	int i, j, k;
+
+	for (i = 0; i < MASTER_MAX; i++) {
+		worker = kthread_create_worker(0, "cam_cci_w%u_m%d",
+			cci_dev->soc_info.index, i);
+		if (IS_ERR(worker)) {
+			CAM_ERR(CAM_CCI, "Failed to create write worker: %ld",
+				PTR_ERR(worker));
+			goto free_resources;
+		}
+		cam_set_rt_sched(worker->task);
+		cci_dev->write_worker[i] = worker;
+
+		for (j = 0; j < NUM_QUEUES; j++) {
+			ring = kzalloc(sizeof(*ring), GFP_KERNEL);
+			if (!ring)
+				goto free_resources;
+
+			for (k = 0; k < CCI_ASYNC_RING_SIZE; k++) {
+				ring->slot[k].slot = k;
+				kthread_init_work(&ring->slot[k].work,
+					cam_cci_write_async_helper);
+			}
+			cci_dev->async_ring[i][j] = ring;
+		}
+	}
+
+	return 0;
+
+free_resources:
+	cam_cci_async_deinit(cci_dev);
+	return -ENOMEM;
+}
+
+void cam_cci_async_deinit(struct cci_device *cci_dev)
+{
+	int i, j;
+
+	for (i = 0; i < MASTER_MAX; i++) {
+		if (cci_dev->write_worker[i]) {
+			kthread_destroy_worker(cci_dev->write_worker[i]);
+			cci_dev->write_worker[i] = NULL;
+		}
+
+		for (j = 0; j < NUM_QUEUES; j++) {
+			kfree(cci_dev->async_ring[i][j]);
+			cci_dev->async_ring[i][j] = NULL;
+		}
+	}
+}
+
+void cam_cci_async_flush(struct cci_device *cci_dev,
+	enum cci_i2c_master_t master)
+{
+	if (cci_dev->write_worker[master])
+		kthread_flush_worker(cci_dev->write_worker[master]);
+}
+
+int cam_cci_async_dump_stats(struct cci_device *cci_dev,
+	char *buf, size_t size)
+{
+	struct cam_cci_async_stats *stats;
+	int i, j, k, len = 0;
+
+	for (i = 0; i < MASTER_MAX; i++) {
+		for (j = 0; j < NUM_QUEUES; j++) {
+			stats = &cci_dev->async_stats[i][j];
+			len += scnprintf(buf + len, size - len,
+				"cci%u master %d queue %d: queued %lld depth %d max_depth %d overflow %lld drops %lld max_lat %dus\n",
+				cci_dev->soc_info.index, i, j,
+				atomic64_read(&stats->queued),
+				atomic_read(&stats->depth),
+				atomic_read(&stats->max_depth),
+				atomic64_read(&stats->overflow),
+				atomic64_read(&stats->drops),
+				atomic_read(&stats->max_lat_us));
+			len += scnprintf(buf + len, size - len, "  lat_us");
+			for (k = 0; k < CCI_ASYNC_LATENCY_BUCKETS - 1; k++)
+				len += scnprintf(buf + len, size - len,
+					" <%d:%d", 64 << k,
+					atomic_read(&stats->latency[k]));
+			len += scnprintf(buf + len, size - len, " >=%d:%d\n",
+				64 << (CCI_ASYNC_LATENCY_BUCKETS - 2),
+				atomic_read(&stats->latency[k]));
+		}
+	}
+
+	return len;
+}
+
+void cam_cci_async_reset_stats(struct cci_device *cci_dev)
+{
+	struct cam_cci_async_stats *stats;
+	int i, j, k;
+
+	for (i = 0; i < MASTER_MAX; i++) {
+		for (j = 0; j < NUM_QUEUES; j++) {
+			stats = &cci_dev->async_stats[i][j];
+			atomic_set(&stats->max_depth,
+				atomic_read(&stats->depth));
+			atomic64_set(&stats->queued, 0);
+			atomic64_set(&stats->overflow, 0);
+			atomic64_set(&stats->drops, 0);
+			atomic_set(&stats->max_lat_us, 0);
+			for (k = 0; k < CCI_ASYNC_LATENCY_BUCKETS; k++)
+				atomic_set(&stats->latency[k], 0);
+		}
+	}
+}
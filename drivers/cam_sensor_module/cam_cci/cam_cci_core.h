@@ -36,4 +36,45 @@ int32_t cam_cci_core_cfg(struct v4l2_subdev *sd,
  */
 irqreturn_t cam_cci_irq(int irq_num, void *data);
 
+/**
+ * @cci_dev: CCI device structure
+ *
+ * This API creates the per master write workers and the
+ * preallocated async write rings
+ */
+int cam_cci_async_init(struct cci_device *cci_dev);
+
+/**
+ * @cci_dev: CCI device structure
+ *
+ * This API destroys the write workers and frees the async rings
+ */
+void cam_cci_async_deinit(struct cci_device *cci_dev);
+
+/**
+ * @cci_dev: CCI device structure
+ * @master: CCI master
+ *
+ * This API waits for all queued async writes on a master
+ */
+void cam_cci_async_flush(struct cci_device *cci_dev,
+	enum cci_i2c_master_t master);
+
+/**
+ * @cci_dev: CCI device structure
+ * @buf: Output buffer
+ * @size: Size of the output buffer
+ *
+ * This API prints the async write statistics and returns the length
+ */
+int cam_cci_async_dump_stats(struct cci_device *cci_dev,
+	char *buf, size_t size);
+
+/**
+ * @cci_dev: CCI device structure
+ *
+ * This API clears the async write statistics
+ */
+void cam_cci_async_reset_stats(struct cci_device *cci_dev);
+
 #endif /* _CAM_CCI_CORE_H_ */
@@ -406,6 +406,45 @@ DEFINE_DEBUGFS_ATTRIBUTE(cam_cci_debug,
 	cam_cci_get_debug,
 	cam_cci_set_debug, "%16llu\n");
 
+#define CAM_CCI_ASYNC_STATS_BUF_SIZE 2048
+
+static ssize_t cam_cci_async_stats_read(struct file *t_file, char *t_char,
+	size_t t_size_t, loff_t *t_loff_t)
+{
+	struct cci_device *cci_dev = t_file->private_data;
+	char *out_buffer;
+	ssize_t rc;
+	int len;
+
+	out_buffer = kzalloc(CAM_CCI_ASYNC_STATS_BUF_SIZE, GFP_KERNEL);
+	if (!out_buffer)
+		return -ENOMEM;
+
+	len = cam_cci_async_dump_stats(cci_dev, out_buffer,
+		CAM_CCI_ASYNC_STATS_BUF_SIZE);
+	rc = simple_read_from_buffer(t_char, t_size_t,
+		t_loff_t, out_buffer, len);
+	kfree(out_buffer);
+
+	return rc;
+}
+
+static ssize_t cam_cci_async_stats_write(struct file *t_file,
+	const char *t_char, size_t t_size_t, loff_t *t_loff_t)
+{
+	struct cci_device *cci_dev = t_file->private_data;
+
+	cam_cci_async_reset_stats(cci_dev);
+
+	return t_size_t;
+}
+
+static const struct file_operations cam_cci_async_stats = {
+	.open = simple_open,
+	.read = cam_cci_async_stats_read,
+	.write = cam_cci_async_stats_write,
+};
+
 static int cam_cci_create_debugfs_entry(struct cci_device *cci_dev)
 {
 	int rc = 0;
@@ -421,6 +460,14 @@ static int cam_cci_create_debugfs_entry(struct cci_device *cci_dev)
 		debugfs_root = dbgfileptr;
 	}
 
+	dbgfileptr = debugfs_create_file(cci_dev->soc_info.index ?
+		"async_stats_cci1" : "async_stats_cci0", 0644,
+		debugfs_root, cci_dev, &cam_cci_async_stats);
+	if (IS_ERR(dbgfileptr) && PTR_ERR(dbgfileptr) != -ENODEV) {
+		rc = PTR_ERR(dbgfileptr);
+		goto end;
+	}
+
 	if (cci_dev->soc_info.index == 0) {
 		dbgfileptr = debugfs_create_file("en_dump_cci0", 0644,
 			debugfs_root, cci_dev, &cam_cci_debug);
@@ -19,6 +19,7 @@
 #include <linux/debugfs.h>
 #include <linux/platform_device.h>
 #include <linux/semaphore.h>
+#include <linux/kthread.h>
 #include <media/cam_sensor.h>
 #include <media/v4l2-event.h>
 #include <media/v4l2-ioctl.h>
@@ -56,6 +57,12 @@
 
 #define CAMX_CCI_DEV_NAME "cam-cci-driver"
 
+/* Preallocated async write slots per master per queue */
+#define CCI_ASYNC_RING_SIZE 8
+/* Registers stored inline in an async slot, larger tables go to the heap */
+#define CCI_ASYNC_INLINE_REGS 32
+#define CCI_ASYNC_LATENCY_BUCKETS 8
+
 #define MAX_CCI 2
 
 #define PRIORITY_QUEUE (QUEUE_0)
@@ -158,6 +165,28 @@ enum cam_cci_state_t {
 	CCI_STATE_DISABLED,
 };
 
+/**
+ * struct cam_cci_async_stats
+ * @depth:       Writes currently queued or running
+ * @max_depth:   Highest @depth seen
+ * @queued:      Total writes queued
+ * @overflow:    Writes that found the ring full and used the heap
+ * @drops:       Writes dropped because no entry could be found
+ * @latency:     Enqueue to bus latency histogram, log2 buckets from 64us
+ * @max_lat_us:  Highest enqueue to bus latency
+ */
+struct cam_cci_async_stats {
+	atomic_t depth;
+	atomic_t max_depth;
+	atomic64_t queued;
+	atomic64_t overflow;
+	atomic64_t drops;
+	atomic_t latency[CCI_ASYNC_LATENCY_BUCKETS];
+	atomic_t max_lat_us;
+};
+
+struct cam_cci_async_ring;
+
 /**
  * struct cci_device
  * @pdev:                       Platform device
@@ -182,7 +211,9 @@ enum cam_cci_state_t {
  * @cci_reg_ptr:                CCI individual regulator structure
  * @regulator_count:            Regulator count
  * @support_seq_write:          Set this flag when sequential write is enabled
- * @write_wq:                   Work queue structure
+ * @write_worker:               Per master RT kthread worker for async writes
+ * @async_ring:                 Preallocated async write slots
+ * @async_stats:                Async write queue statistics
  * @valid_sync:                 Is it a valid sync with CSID
  * @v4l2_dev_str:               V4L2 device structure
  * @cci_wait_sync_cfg:          CCI sync config
@@ -213,7 +244,9 @@ struct cci_device {
 	struct msm_pinctrl_info cci_pinctrl;
 	uint8_t cci_pinctrl_status;
 	uint8_t support_seq_write;
-	struct workqueue_struct *write_wq[MASTER_MAX];
+	struct kthread_worker *write_worker[MASTER_MAX];
+	struct cam_cci_async_ring *async_ring[MASTER_MAX][NUM_QUEUES];
+	struct cam_cci_async_stats async_stats[MASTER_MAX][NUM_QUEUES];
 	struct cam_cci_wait_sync_cfg cci_wait_sync_cfg;
 	uint8_t valid_sync;
 	struct cam_subdev v4l2_dev_str;
@@ -288,13 +321,37 @@ struct cam_cci_ctrl {
 	} cfg;
 };
 
+/**
+ * struct cci_write_async
+ * @cci_dev:            CCI device the write belongs to
+ * @c_ctrl:             Copy of the caller's control, reg_setting points
+ *                      either at @regs or at a heap copy
+ * @queue:              CCI queue to write on
+ * @work:               Work item run on the master's write worker
+ * @workq_scheduled_ts: Enqueue timestamp
+ * @sync_en:            Sync mode
+ * @slot:               Ring slot index, -1 if the entry itself is on the heap
+ * @regs:               Inline register storage
+ */
 struct cci_write_async {
 	struct cci_device *cci_dev;
 	struct cam_cci_ctrl c_ctrl;
 	enum cci_i2c_queue_t queue;
-	struct work_struct work;
+	struct kthread_work work;
 	ktime_t workq_scheduled_ts;
 	enum cci_i2c_sync sync_en;
+	int32_t slot;
+	struct cam_sensor_i2c_reg_array regs[CCI_ASYNC_INLINE_REGS];
+};
+
+/**
+ * struct cam_cci_async_ring
+ * @slot:     Preallocated async write entries
+ * @used_map: Bit n set while @slot[n] is in flight
+ */
+struct cam_cci_async_ring {
+	struct cci_write_async slot[CCI_ASYNC_RING_SIZE];
+	unsigned long used_map;
 };
 
 irqreturn_t cam_cci_irq(int irq_num, void *data);
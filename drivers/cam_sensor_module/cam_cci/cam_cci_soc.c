@@ -60,7 +60,7 @@ static int cam_cci_init_master(struct cci_device *cci_dev,
 			return rc;
 		}
 
-		flush_workqueue(cci_dev->write_wq[master]);
+		cam_cci_async_flush(cci_dev, master);
 
 		/* Setting up the queue size for master */
 		cci_dev->cci_i2c_queue_info[master][QUEUE_0].max_queue_size
@@ -119,8 +119,8 @@ int cam_cci_init(struct v4l2_subdev *sd,
 		return -EINVAL;
 	}
 
-	if (!cci_dev->write_wq[master]) {
-		CAM_ERR(CAM_CCI, "Null memory for write wq[:%d]", master);
+	if (!cci_dev->write_worker[master]) {
+		CAM_ERR(CAM_CCI, "Null memory for write worker[:%d]", master);
 		rc = -ENOMEM;
 		return rc;
 	}
@@ -211,6 +211,7 @@ void cam_cci_soc_remove(struct platform_device *pdev,
 {
 	struct cam_hw_soc_info *soc_info = &cci_dev->soc_info;
 
+	cam_cci_async_deinit(cci_dev);
 	cam_soc_util_release_platform_resource(soc_info);
 }
 
@@ -364,7 +365,7 @@ static void cam_cci_init_clk_params(struct cci_device *cci_dev)
 int cam_cci_parse_dt_info(struct platform_device *pdev,
 	struct cci_device *new_cci_dev)
 {
-	int rc = 0, i = 0;
+	int rc = 0;
 	struct cam_hw_soc_info *soc_info =
 		&new_cci_dev->soc_info;
 
@@ -386,12 +387,8 @@ int cam_cci_parse_dt_info(struct platform_device *pdev,
 	cam_cci_init_cci_params(new_cci_dev);
 	cam_cci_init_clk_params(new_cci_dev);
 
-	for (i = 0; i < MASTER_MAX; i++) {
-		new_cci_dev->write_wq[i] = create_singlethread_workqueue(
-			"cam_cci_wq");
-		if (!new_cci_dev->write_wq[i])
-			CAM_ERR(CAM_CCI, "Failed to create write wq");
-	}
+	if (cam_cci_async_init(new_cci_dev))
+		CAM_ERR(CAM_CCI, "Failed to create async write workers");
 	CAM_DBG(CAM_CCI, "Exit");
 	return 0;
 }
@@ -424,8 +421,7 @@ int cam_cci_soc_release(struct cci_device *cci_dev,
 	}
 
 	for (i = 0; i < MASTER_MAX; i++) {
-		if (cci_dev->write_wq[i])
-			flush_workqueue(cci_dev->write_wq[i]);
+		cam_cci_async_flush(cci_dev, i);
 		cci_dev->i2c_freq_mode[i] = I2C_MAX_MODES;
 	}
 
@@ -16,24 +16,257 @@
 
 #define MAX_READ_SIZE  0x7FFFF
 
+/**
+ * struct cam_eeprom_cache_entry - calibration data kept across opens
+ * @list:     Link in the cache list
+ * @cell_idx: EEPROM cell index the data was read from
+ * @map_crc:  CRC of the memory map used for the read
+ * @data_crc: CRC of @data, checked before every hit
+ * @num_data: Size of @data
+ * @data:     Calibration data
+ */
+struct cam_eeprom_cache_entry {
+	struct list_head list;
+	uint32_t cell_idx;
+	uint32_t map_crc;
+	uint32_t data_crc;
+	uint32_t num_data;
+	uint8_t *data;
+};
+
+static LIST_HEAD(cam_eeprom_cache_list);
+static DEFINE_MUTEX(cam_eeprom_cache_mutex);
+static struct cam_eeprom_read_stats cam_eeprom_stats;
+bool cam_eeprom_cache_en = true;
+
+static inline uint32_t cam_eeprom_map_crc(
+	struct cam_eeprom_memory_block_t *block)
+{
+	return crc32_le(~0, (uint8_t *)block->map,
+		block->num_map * sizeof(struct cam_eeprom_memory_map_t));
+}
+
+static struct cam_eeprom_cache_entry *cam_eeprom_cache_find(
+	uint32_t cell_idx)
+{
+	struct cam_eeprom_cache_entry *entry;
+
+	list_for_each_entry(entry, &cam_eeprom_cache_list, list) {
+		if (entry->cell_idx == cell_idx)
+			return entry;
+	}
+
+	return NULL;
+}
+
+static void cam_eeprom_cache_free_entry(struct cam_eeprom_cache_entry *entry)
+{
+	list_del(&entry->list);
+	vfree(entry->data);
+	kfree(entry);
+}
+
+/**
+ * cam_eeprom_cache_lookup - fill a block from the calibration cache
+ * @e_ctrl: ctrl structure
+ * @block:  block with the memory map set and mapdata allocated
+ *
+ * Returns true if @block->mapdata was filled from the cache
+ */
+static bool cam_eeprom_cache_lookup(struct cam_eeprom_ctrl_t *e_ctrl,
+	struct cam_eeprom_memory_block_t *block)
+{
+	struct cam_eeprom_cache_entry *entry;
+	bool hit = false;
+
+	if (!READ_ONCE(cam_eeprom_cache_en) || !block->mapdata)
+		return false;
+
+	mutex_lock(&cam_eeprom_cache_mutex);
+	entry = cam_eeprom_cache_find(e_ctrl->soc_info.index);
+	if (!entry || entry->num_data != block->num_data ||
+		entry->map_crc != cam_eeprom_map_crc(block))
+		goto end;
+
+	if (crc32_le(~0, entry->data, entry->num_data) != entry->data_crc) {
+		CAM_WARN(CAM_EEPROM, "Cached data corrupt for cell %u",
+			entry->cell_idx);
+		cam_eeprom_cache_free_entry(entry);
+		goto end;
+	}
+
+	memcpy(block->mapdata, entry->data, entry->num_data);
+	hit = true;
+end:
+	mutex_unlock(&cam_eeprom_cache_mutex);
+	atomic64_inc(hit ? &cam_eeprom_stats.hits : &cam_eeprom_stats.misses);
+	CAM_DBG(CAM_EEPROM, "cell %u cache %s", e_ctrl->soc_info.index,
+		hit ? "hit" : "miss");
+
+	return hit;
+}
+
+static void cam_eeprom_cache_insert(struct cam_eeprom_ctrl_t *e_ctrl,
+	struct cam_eeprom_memory_block_t *block)
+{
+	struct cam_eeprom_cache_entry *entry, *old;
+
+	if (!READ_ONCE(cam_eeprom_cache_en) || !block->num_data)
+		return;
+
+	entry = kzalloc(sizeof(*entry), GFP_KERNEL);
+	if (!entry)
+		return;
+
+	entry->data = vmalloc(block->num_data);
+	if (!entry->data) {
+		kfree(entry);
+		return;
+	}
+
+	memcpy(entry->data, block->mapdata, block->num_data);
+	entry->cell_idx = e_ctrl->soc_info.index;
+	entry->num_data = block->num_data;
+	entry->map_crc = cam_eeprom_map_crc(block);
+	entry->data_crc = crc32_le(~0, entry->data, entry->num_data);
+
+	mutex_lock(&cam_eeprom_cache_mutex);
+	old = cam_eeprom_cache_find(entry->cell_idx);
+	if (old)
+		cam_eeprom_cache_free_entry(old);
+	list_add(&entry->list, &cam_eeprom_cache_list);
+	mutex_unlock(&cam_eeprom_cache_mutex);
+}
+
+static void cam_eeprom_cache_invalidate(uint32_t cell_idx)
+{
+	struct cam_eeprom_cache_entry *entry;
+
+	mutex_lock(&cam_eeprom_cache_mutex);
+	entry = cam_eeprom_cache_find(cell_idx);
+	if (entry)
+		cam_eeprom_cache_free_entry(entry);
+	mutex_unlock(&cam_eeprom_cache_mutex);
+}
+
+void cam_eeprom_cache_flush(void)
+{
+	struct cam_eeprom_cache_entry *entry, *temp;
+
+	mutex_lock(&cam_eeprom_cache_mutex);
+	list_for_each_entry_safe(entry, temp, &cam_eeprom_cache_list, list)
+		cam_eeprom_cache_free_entry(entry);
+	mutex_unlock(&cam_eeprom_cache_mutex);
+}
+
+int cam_eeprom_dump_read_stats(char *buf, size_t size)
+{
+	struct cam_eeprom_cache_entry *entry;
+	int len;
+
+	len = scnprintf(buf, size,
+		"hits %lld misses %lld reads %lld bus_reads %lld page_toggles %lld bytes %lld last_us %lld max_us %lld\n",
+		atomic64_read(&cam_eeprom_stats.hits),
+		atomic64_read(&cam_eeprom_stats.misses),
+		atomic64_read(&cam_eeprom_stats.reads),
+		atomic64_read(&cam_eeprom_stats.bus_reads),
+		atomic64_read(&cam_eeprom_stats.page_toggles),
+		atomic64_read(&cam_eeprom_stats.bytes),
+		atomic64_read(&cam_eeprom_stats.last_us),
+		atomic64_read(&cam_eeprom_stats.max_us));
+
+	mutex_lock(&cam_eeprom_cache_mutex);
+	list_for_each_entry(entry, &cam_eeprom_cache_list, list)
+		len += scnprintf(buf + len, size - len,
+			"cell %u: %u bytes map_crc 0x%x data_crc 0x%x\n",
+			entry->cell_idx, entry->num_data, entry->map_crc,
+			entry->data_crc);
+	mutex_unlock(&cam_eeprom_cache_mutex);
+
+	return len;
+}
+
+void cam_eeprom_reset_read_stats(void)
+{
+	atomic64_set(&cam_eeprom_stats.hits, 0);
+	atomic64_set(&cam_eeprom_stats.misses, 0);
+	atomic64_set(&cam_eeprom_stats.reads, 0);
+	atomic64_set(&cam_eeprom_stats.bus_reads, 0);
+	atomic64_set(&cam_eeprom_stats.page_toggles, 0);
+	atomic64_set(&cam_eeprom_stats.bytes, 0);
+	atomic64_set(&cam_eeprom_stats.last_us, 0);
+	atomic64_set(&cam_eeprom_stats.max_us, 0);
+}
+
+static int cam_eeprom_write_page_reg(struct cam_eeprom_ctrl_t *e_ctrl,
+	struct cam_eeprom_map_t *map, uint32_t data)
+{
+	struct cam_sensor_i2c_reg_setting  i2c_reg_settings = {0};
+	struct cam_sensor_i2c_reg_array    i2c_reg_array = {0};
+
+	i2c_reg_settings.addr_type = map->addr_type;
+	i2c_reg_settings.data_type = map->data_type;
+	i2c_reg_settings.size = 1;
+	i2c_reg_array.reg_addr = map->addr;
+	i2c_reg_array.reg_data = data;
+	i2c_reg_array.delay = map->delay;
+	i2c_reg_settings.reg_setting = &i2c_reg_array;
+	atomic64_inc(&cam_eeprom_stats.page_toggles);
+
+	return camera_io_dev_write(&e_ctrl->io_master_info,
+		&i2c_reg_settings);
+}
+
+/*
+ * Entry @next can run under the page setup of @first when it does not
+ * switch slave, has no poll of its own and programs the same page and
+ * page enable registers.
+ */
+static bool cam_eeprom_shares_page(struct cam_eeprom_memory_map_t *first,
+	struct cam_eeprom_memory_map_t *next, uint16_t slave_addr)
+{
+	if (next->saddr && next->saddr != slave_addr)
+		return false;
+
+	if (next->poll.valid_size)
+		return false;
+
+	return !memcmp(&first->page, &next->page, sizeof(first->page)) &&
+		!memcmp(&first->pageen, &next->pageen, sizeof(first->pageen));
+}
+
+/* Entry @next continues the sequential read that ends at @addr */
+static bool cam_eeprom_mem_contiguous(struct cam_eeprom_map_t *first,
+	struct cam_eeprom_map_t *next, uint32_t addr, uint32_t size)
+{
+	return next->valid_size && next->addr == addr + size &&
+		next->addr_type == first->addr_type &&
+		next->data_type == first->data_type &&
+		size + next->valid_size <= I2C_REG_DATA_MAX;
+}
+
 /**
  * cam_eeprom_read_memory() - read map data into buffer
  * @e_ctrl:     eeprom control struct
  * @block:      block to be read
  *
  * This function iterates through blocks stored in block->map, reads each
- * region and concatenate them into the pre-allocated block->mapdata
+ * region and concatenate them into the pre-allocated block->mapdata.
+ * Consecutive entries that share the slave and page setup are read under
+ * a single page enable, and address contiguous regions within them are
+ * merged into one sequential read.
  */
 static int cam_eeprom_read_memory(struct cam_eeprom_ctrl_t *e_ctrl,
 	struct cam_eeprom_memory_block_t *block)
 {
 	int                                rc = 0;
-	int                                j;
-	struct cam_sensor_i2c_reg_setting  i2c_reg_settings = {0};
-	struct cam_sensor_i2c_reg_array    i2c_reg_array = {0};
+	int                                j, k, r, n;
+	uint32_t                           addr, size;
 	struct cam_eeprom_memory_map_t    *emap = block->map;
 	struct cam_eeprom_soc_private     *eb_info = NULL;
 	uint8_t                           *memptr = block->mapdata;
+	ktime_t                            start;
+	int64_t                            us;
 
 	if (!e_ctrl) {
 		CAM_ERR(CAM_EEPROM, "e_ctrl is NULL");
@@ -41,8 +274,9 @@ static int cam_eeprom_read_memory(struct cam_eeprom_ctrl_t *e_ctrl,
 	}
 
 	eb_info = (struct cam_eeprom_soc_private *)e_ctrl->soc_info.soc_private;
+	start = ktime_get();
 
-	for (j = 0; j < block->num_map; j++) {
+	for (j = 0; j < block->num_map; j = k) {
 		CAM_DBG(CAM_EEPROM, "slave-addr = 0x%X", emap[j].saddr);
 		if (emap[j].saddr) {
 			eb_info->i2c_info.slave_addr = emap[j].saddr;
@@ -57,15 +291,8 @@ static int cam_eeprom_read_memory(struct cam_eeprom_ctrl_t *e_ctrl,
 		}
 
 		if (emap[j].page.valid_size) {
-			i2c_reg_settings.addr_type = emap[j].page.addr_type;
-			i2c_reg_settings.data_type = emap[j].page.data_type;
-			i2c_reg_settings.size = 1;
-			i2c_reg_array.reg_addr = emap[j].page.addr;
-			i2c_reg_array.reg_data = emap[j].page.data;
-			i2c_reg_array.delay = emap[j].page.delay;
-			i2c_reg_settings.reg_setting = &i2c_reg_array;
-			rc = camera_io_dev_write(&e_ctrl->io_master_info,
-				&i2c_reg_settings);
+			rc = cam_eeprom_write_page_reg(e_ctrl, &emap[j].page,
+				emap[j].page.data);
 			if (rc) {
 				CAM_ERR(CAM_EEPROM, "page write failed rc %d",
 					rc);
@@ -74,15 +301,8 @@ static int cam_eeprom_read_memory(struct cam_eeprom_ctrl_t *e_ctrl,
 		}
 
 		if (emap[j].pageen.valid_size) {
-			i2c_reg_settings.addr_type = emap[j].pageen.addr_type;
-			i2c_reg_settings.data_type = emap[j].pageen.data_type;
-			i2c_reg_settings.size = 1;
-			i2c_reg_array.reg_addr = emap[j].pageen.addr;
-			i2c_reg_array.reg_data = emap[j].pageen.data;
-			i2c_reg_array.delay = emap[j].pageen.delay;
-			i2c_reg_settings.reg_setting = &i2c_reg_array;
-			rc = camera_io_dev_write(&e_ctrl->io_master_info,
-				&i2c_reg_settings);
+			rc = cam_eeprom_write_page_reg(e_ctrl,
+				&emap[j].pageen, emap[j].pageen.data);
 			if (rc) {
 				CAM_ERR(CAM_EEPROM, "page enable failed rc %d",
 					rc);
@@ -103,30 +323,45 @@ static int cam_eeprom_read_memory(struct cam_eeprom_ctrl_t *e_ctrl,
 			}
 		}
 
-		if (emap[j].mem.valid_size) {
+		for (k = j + 1; k < block->num_map; k++)
+			if (!cam_eeprom_shares_page(&emap[j], &emap[k],
+				eb_info->i2c_info.slave_addr))
+				break;
+
+		for (r = j; r < k; r = n) {
+			n = r + 1;
+			if (!emap[r].mem.valid_size)
+				continue;
+
+			addr = emap[r].mem.addr;
+			size = emap[r].mem.valid_size;
+			for (; n < k; n++) {
+				if (!cam_eeprom_mem_contiguous(&emap[r].mem,
+					&emap[n].mem, addr, size))
+					break;
+				size += emap[n].mem.valid_size;
+			}
+
+			CAM_DBG(CAM_EEPROM, "map %d-%d addr 0x%x size %u",
+				r, n - 1, addr, size);
 			rc = camera_io_dev_read_seq(&e_ctrl->io_master_info,
-				emap[j].mem.addr, memptr,
-				emap[j].mem.addr_type,
-				emap[j].mem.data_type,
-				emap[j].mem.valid_size);
+				addr, memptr,
+				emap[r].mem.addr_type,
+				emap[r].mem.data_type,
+				size);
 			if (rc < 0) {
 				CAM_ERR(CAM_EEPROM, "read failed rc %d",
 					rc);
 				return rc;
 			}
-			memptr += emap[j].mem.valid_size;
+			memptr += size;
+			atomic64_inc(&cam_eeprom_stats.bus_reads);
+			atomic64_add(size, &cam_eeprom_stats.bytes);
 		}
 
 		if (emap[j].pageen.valid_size) {
-			i2c_reg_settings.addr_type = emap[j].pageen.addr_type;
-			i2c_reg_settings.data_type = emap[j].pageen.data_type;
-			i2c_reg_settings.size = 1;
-			i2c_reg_array.reg_addr = emap[j].pageen.addr;
-			i2c_reg_array.reg_data = 0;
-			i2c_reg_array.delay = emap[j].pageen.delay;
-			i2c_reg_settings.reg_setting = &i2c_reg_array;
-			rc = camera_io_dev_write(&e_ctrl->io_master_info,
-				&i2c_reg_settings);
+			rc = cam_eeprom_write_page_reg(e_ctrl,
+				&emap[j].pageen, 0);
 			if (rc) {
 				CAM_ERR(CAM_EEPROM,
 					"page disable failed rc %d",
@@ -135,6 +370,15 @@ static int cam_eeprom_read_memory(struct cam_eeprom_ctrl_t *e_ctrl,
 			}
 		}
 	}
+
+	us = ktime_us_delta(ktime_get(), start);
+	atomic64_inc(&cam_eeprom_stats.reads);
+	atomic64_set(&cam_eeprom_stats.last_us, us);
+	if (us > atomic64_read(&cam_eeprom_stats.max_us))
+		atomic64_set(&cam_eeprom_stats.max_us, us);
+
+	cam_eeprom_cache_insert(e_ctrl, block);
+
 	return rc;
 }
 
@@ -289,6 +533,12 @@ int32_t cam_eeprom_parse_read_memory_map(struct device_node *of_node,
 		CAM_ERR(CAM_EEPROM, "failed: eeprom dt parse rc %d", rc);
 		return rc;
 	}
+
+	if (cam_eeprom_cache_lookup(e_ctrl, &e_ctrl->cal_data)) {
+		e_ctrl->cam_eeprom_state = CAM_EEPROM_ACQUIRE;
+		return 0;
+	}
+
 	rc = cam_eeprom_power_up(e_ctrl, power_info);
 	if (rc) {
 		CAM_ERR(CAM_EEPROM, "failed: eeprom power up rc %d", rc);
@@ -1217,6 +1467,7 @@ static int32_t cam_eeprom_pkt_parse(struct cam_eeprom_ctrl_t *e_ctrl, void *arg)
 	struct cam_eeprom_soc_private  *soc_private =
 		(struct cam_eeprom_soc_private *)e_ctrl->soc_info.soc_private;
 	struct cam_sensor_power_ctrl_t *power_info = &soc_private->power_info;
+	bool                            cached = false;
 
 	ioctl_ctrl = (struct cam_control *)arg;
 
@@ -1296,23 +1547,27 @@ static int32_t cam_eeprom_pkt_parse(struct cam_eeprom_ctrl_t *e_ctrl, void *arg)
 			}
 		}
 
-		rc = cam_eeprom_power_up(e_ctrl,
-			&soc_private->power_info);
-		if (rc) {
-			CAM_ERR(CAM_EEPROM, "failed rc %d", rc);
-			goto memdata_free;
-		}
+		cached = cam_eeprom_cache_lookup(e_ctrl, &e_ctrl->cal_data);
+		if (!cached) {
+			rc = cam_eeprom_power_up(e_ctrl,
+				&soc_private->power_info);
+			if (rc) {
+				CAM_ERR(CAM_EEPROM, "failed rc %d", rc);
+				goto memdata_free;
+			}
 
-		e_ctrl->cam_eeprom_state = CAM_EEPROM_CONFIG;
-		rc = cam_eeprom_read_memory(e_ctrl, &e_ctrl->cal_data);
-		if (rc) {
-			CAM_ERR(CAM_EEPROM,
-				"read_eeprom_memory failed");
-			goto power_down;
+			e_ctrl->cam_eeprom_state = CAM_EEPROM_CONFIG;
+			rc = cam_eeprom_read_memory(e_ctrl, &e_ctrl->cal_data);
+			if (rc) {
+				CAM_ERR(CAM_EEPROM,
+					"read_eeprom_memory failed");
+				goto power_down;
+			}
 		}
 
 		rc = cam_eeprom_get_cal_data(e_ctrl, csl_packet);
-		rc = cam_eeprom_power_down(e_ctrl);
+		if (!cached)
+			rc = cam_eeprom_power_down(e_ctrl);
 		e_ctrl->cam_eeprom_state = CAM_EEPROM_ACQUIRE;
 		vfree(e_ctrl->cal_data.mapdata);
 		vfree(e_ctrl->cal_data.map);
@@ -1350,6 +1605,7 @@ static int32_t cam_eeprom_pkt_parse(struct cam_eeprom_ctrl_t *e_ctrl, void *arg)
 			rc, e_ctrl->eebin_info.start_address,
 			e_ctrl->eebin_info.size);
 
+		cam_eeprom_cache_invalidate(e_ctrl->soc_info.index);
 		rc = camera_io_dev_erase(&e_ctrl->io_master_info,
 			e_ctrl->eebin_info.start_address,
 			e_ctrl->eebin_info.size);
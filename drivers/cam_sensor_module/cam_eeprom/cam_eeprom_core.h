@@ -17,5 +17,25 @@ int32_t cam_eeprom_parse_read_memory_map(struct device_node *of_node,
  */
 void cam_eeprom_shutdown(struct cam_eeprom_ctrl_t *e_ctrl);
 
+extern bool cam_eeprom_cache_en;
+
+/**
+ * This API frees all cached calibration data
+ */
+void cam_eeprom_cache_flush(void);
+
+/**
+ * @buf: Output buffer
+ * @size: Size of the output buffer
+ *
+ * This API prints the calibration read and cache statistics
+ */
+int cam_eeprom_dump_read_stats(char *buf, size_t size);
+
+/**
+ * This API clears the calibration read statistics
+ */
+void cam_eeprom_reset_read_stats(void);
+
 #endif
 /* _CAM_EEPROM_CORE_H_ */
@@ -607,6 +607,61 @@ static struct spi_driver cam_eeprom_spi_driver = {
 	.probe = cam_eeprom_spi_driver_probe,
 	.remove = cam_eeprom_spi_driver_remove,
 };
+#define CAM_EEPROM_STATS_BUF_SIZE 1024
+
+static struct dentry *debugfs_root;
+
+static ssize_t cam_eeprom_read_stats_read(struct file *t_file, char *t_char,
+	size_t t_size_t, loff_t *t_loff_t)
+{
+	char *out_buffer;
+	ssize_t rc;
+	int len;
+
+	out_buffer = kzalloc(CAM_EEPROM_STATS_BUF_SIZE, GFP_KERNEL);
+	if (!out_buffer)
+		return -ENOMEM;
+
+	len = cam_eeprom_dump_read_stats(out_buffer,
+		CAM_EEPROM_STATS_BUF_SIZE);
+	rc = simple_read_from_buffer(t_char, t_size_t,
+		t_loff_t, out_buffer, len);
+	kfree(out_buffer);
+
+	return rc;
+}
+
+static ssize_t cam_eeprom_read_stats_write(struct file *t_file,
+	const char *t_char, size_t t_size_t, loff_t *t_loff_t)
+{
+	cam_eeprom_reset_read_stats();
+
+	return t_size_t;
+}
+
+static const struct file_operations cam_eeprom_read_stats = {
+	.open = simple_open,
+	.read = cam_eeprom_read_stats_read,
+	.write = cam_eeprom_read_stats_write,
+};
+
+static void cam_eeprom_create_debugfs_entry(void)
+{
+	struct dentry *dbgfileptr = NULL;
+
+	dbgfileptr = debugfs_create_dir("cam_eeprom", NULL);
+	if (IS_ERR_OR_NULL(dbgfileptr)) {
+		CAM_WARN(CAM_EEPROM, "debugfs directory creation fail");
+		return;
+	}
+	debugfs_root = dbgfileptr;
+
+	debugfs_create_bool("cache_en", 0644, debugfs_root,
+		&cam_eeprom_cache_en);
+	debugfs_create_file("read_stats", 0644, debugfs_root, NULL,
+		&cam_eeprom_read_stats);
+}
+
 int cam_eeprom_driver_init(void)
 {
 	int rc = 0;
@@ -630,14 +685,19 @@ int cam_eeprom_driver_init(void)
 		return rc;
 	}
 
+	cam_eeprom_create_debugfs_entry();
+
 	return rc;
 }
 
 void cam_eeprom_driver_exit(void)
 {
+	debugfs_remove_recursive(debugfs_root);
+	debugfs_root = NULL;
 	platform_driver_unregister(&cam_eeprom_platform_driver);
 	spi_unregister_driver(&cam_eeprom_spi_driver);
 	i2c_del_driver(&cam_eeprom_i2c_driver);
+	cam_eeprom_cache_flush();
 }
 
 MODULE_DESCRIPTION("CAM EEPROM driver");
@@ -89,6 +89,28 @@ struct cam_eeprom_memory_block_t {
 	uint32_t num_data;
 };
 
+/**
+ * struct cam_eeprom_read_stats - calibration read statistics
+ * @hits:         Reads served from the calibration cache
+ * @misses:       Cache lookups that had to go to the bus
+ * @reads:        Memory map reads done on the bus
+ * @bus_reads:    Sequential reads issued after merging
+ * @page_toggles: Page, page enable and page disable writes
+ * @bytes:        Bytes read from the bus
+ * @last_us:      Duration of the last bus read
+ * @max_us:       Longest bus read
+ */
+struct cam_eeprom_read_stats {
+	atomic64_t hits;
+	atomic64_t misses;
+	atomic64_t reads;
+	atomic64_t bus_reads;
+	atomic64_t page_toggles;
+	atomic64_t bytes;
+	atomic64_t last_us;
+	atomic64_t max_us;
+};
+
 /**
  * struct cam_eeprom_cmm_t - camera multimodule
  * @cmm_support     :   cmm support flag
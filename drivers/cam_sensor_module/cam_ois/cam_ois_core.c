@@ -397,213 +397,296 @@ static int cam_ois_slaveInfo_pkt_parser(struct cam_ois_ctrl_t *o_ctrl,
 	return rc;
 }
 
-static int cam_ois_fw_prog_download(struct cam_ois_ctrl_t *o_ctrl)
+/* Register entries staged per firmware transaction */
+#define CAM_OIS_FW_CHUNK_REGS 256
+
+/**
+ * struct cam_ois_fw_ops - per driver IC firmware hooks
+ * @name:          Substring matched against the OIS name
+ * @download:      Replaces the generic loader, takes ownership of @fw
+ * @fw_resident:   Reads back the device version/checksum, returns true if
+ *                 @fw is already running so the download can be skipped
+ * @post_download: Called after a successful generic download
+ * @no_coeff:      The IC has no separate coefficient firmware
+ */
+struct cam_ois_fw_ops {
+	const char *name;
+	int (*download)(struct cam_ois_ctrl_t *o_ctrl,
+		const struct firmware *fw);
+	bool (*fw_resident)(struct cam_ois_ctrl_t *o_ctrl,
+		const struct firmware *fw);
+	void (*post_download)(struct cam_ois_ctrl_t *o_ctrl,
+		const struct firmware *fw);
+	bool no_coeff;
+};
+
+static bool cam_ois_dw9781_fw_resident(struct cam_ois_ctrl_t *o_ctrl,
+	const struct firmware *fw)
 {
-	uint16_t                           total_bytes = 0;
-	uint8_t                           *ptr = NULL;
-	int32_t                            rc = 0, total_idx, packet_idx;
-	uint32_t                           txn_data_size, txn_regsetting_size;
-	const struct firmware             *fw = NULL;
-	const char                        *fw_name_prog = NULL;
-	char                               name_prog[32] = {0};
-	struct device                     *dev = &(o_ctrl->pdev->dev);
-	struct cam_sensor_i2c_reg_setting  i2c_reg_setting;
-	void                              *vaddr = NULL;
+	return !dw9781c_check_fw_download(&(o_ctrl->io_master_info),
+		fw->data, fw->size);
+}
 
-	if (!o_ctrl) {
-		CAM_ERR(CAM_OIS, "Invalid Args");
-		return -EINVAL;
-	}
+static void cam_ois_dw9781_post_download(struct cam_ois_ctrl_t *o_ctrl,
+	const struct firmware *fw)
+{
+	dw9781_post_firmware_download(&(o_ctrl->io_master_info),
+		fw->data, fw->size);
+}
 
-	snprintf(name_prog, 32, "%s.prog", o_ctrl->ois_name);
+static int cam_ois_aw86006_download(struct cam_ois_ctrl_t *o_ctrl,
+	const struct firmware *fw)
+{
+	int rc;
 
-	/* cast pointer as const pointer*/
-	fw_name_prog = name_prog;
+	mutex_lock(&o_ctrl->aw_ois_mutex);
+	rc = aw86006_firmware_update(o_ctrl, fw);
+	mutex_unlock(&o_ctrl->aw_ois_mutex);
 
-	/* Load FW */
-	rc = request_firmware(&fw, fw_name_prog, dev);
-	if (rc) {
-		CAM_ERR(CAM_OIS, "Failed to locate %s", fw_name_prog);
-		return rc;
-	}
+	return rc;
+}
 
-	if (strstr(o_ctrl->ois_name, "dw9781")) {
-		if (!dw9781c_check_fw_download(&(o_ctrl->io_master_info), fw->data, fw->size)) {
-			CAM_INFO(CAM_OIS, "Skip firmware download.");
-			release_firmware(fw);
-			return 0;
-		}
-		CAM_INFO(CAM_OIS, "Firmware download started.");
-	}
-	else if (strstr(o_ctrl->ois_name, "aw86006")) {
-		mutex_lock(&o_ctrl->aw_ois_mutex);
-		rc = aw86006_firmware_update(o_ctrl, fw);
-		mutex_unlock(&o_ctrl->aw_ois_mutex);
-		return rc;
+static const struct cam_ois_fw_ops cam_ois_fw_ops_table[] = {
+	{
+		.name = "dw9781",
+		.fw_resident = cam_ois_dw9781_fw_resident,
+		.post_download = cam_ois_dw9781_post_download,
+		.no_coeff = true,
+	},
+	{
+		.name = "aw86006",
+		.download = cam_ois_aw86006_download,
+		.no_coeff = true,
+	},
+};
+
+static struct cam_ois_fw_stats cam_ois_fw_stats;
+static DEFINE_SPINLOCK(cam_ois_fw_stats_lock);
+
+static const struct cam_ois_fw_ops *cam_ois_get_fw_ops(
+	struct cam_ois_ctrl_t *o_ctrl)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cam_ois_fw_ops_table); i++)
+		if (strstr(o_ctrl->ois_name, cam_ois_fw_ops_table[i].name))
+			return &cam_ois_fw_ops_table[i];
+
+	return NULL;
+}
+
+static void cam_ois_fw_update_stats(struct cam_ois_ctrl_t *o_ctrl,
+	const char *fw_name, size_t bytes, ktime_t start, bool skipped)
+{
+	int64_t us = ktime_us_delta(ktime_get(), start);
+
+	spin_lock(&cam_ois_fw_stats_lock);
+	if (skipped) {
+		cam_ois_fw_stats.skipped++;
+	} else {
+		cam_ois_fw_stats.downloads++;
+		cam_ois_fw_stats.last_bytes = bytes;
+		cam_ois_fw_stats.last_us = us;
+		cam_ois_fw_stats.total_bytes += bytes;
+		cam_ois_fw_stats.total_us += us;
+		strlcpy(cam_ois_fw_stats.last_name, fw_name,
+			sizeof(cam_ois_fw_stats.last_name));
 	}
+	spin_unlock(&cam_ois_fw_stats_lock);
+
+	if (!skipped)
+		CAM_DBG(CAM_OIS, "%s: %zu bytes in %lld us, %llu B/s",
+			fw_name, bytes, us,
+			us ? div64_u64((uint64_t)bytes * USEC_PER_SEC, us) : 0);
+}
+
+int cam_ois_dump_fw_stats(char *buf, size_t size)
+{
+	struct cam_ois_fw_stats stats;
+
+	spin_lock(&cam_ois_fw_stats_lock);
+	stats = cam_ois_fw_stats;
+	spin_unlock(&cam_ois_fw_stats_lock);
+
+	return scnprintf(buf, size,
+		"downloads %llu skipped %llu\nlast %s: %llu bytes %llu us %llu B/s\ntotal: %llu bytes %llu us %llu B/s\n",
+		stats.downloads, stats.skipped, stats.last_name,
+		stats.last_bytes, stats.last_us,
+		stats.last_us ? div64_u64(stats.last_bytes * USEC_PER_SEC,
+			stats.last_us) : 0,
+		stats.total_bytes, stats.total_us,
+		stats.total_us ? div64_u64(stats.total_bytes * USEC_PER_SEC,
+			stats.total_us) : 0);
+}
+
+void cam_ois_reset_fw_stats(void)
+{
+	spin_lock(&cam_ois_fw_stats_lock);
+	memset(&cam_ois_fw_stats, 0, sizeof(cam_ois_fw_stats));
+	spin_unlock(&cam_ois_fw_stats_lock);
+}
 
-	total_bytes = fw->size;
-	if(o_ctrl->ois_fw_txn_data_sz == 0)
-		txn_data_size = total_bytes;
+/**
+ * cam_ois_fw_stream - write a firmware blob through a small staging array
+ * @o_ctrl:     ctrl structure
+ * @fw:         firmware blob
+ * @base_addr:  register the blob is written to
+ * @step:       payload bytes carried by one register entry
+ * @write_flag: burst (1) or sequential (0) continuous write
+ *
+ * The blob is converted into register entries one transaction at a time.
+ * Each transaction restarts the transfer at @base_addr, so a configured
+ * transaction size is kept as is and an untiled download to a fixed
+ * register still stages the whole blob. Only an untiled download to
+ * incrementing addresses is split into CAM_OIS_FW_CHUNK_REGS entries.
+ */
+static int cam_ois_fw_stream(struct cam_ois_ctrl_t *o_ctrl,
+	const struct firmware *fw, uint32_t base_addr, uint32_t step,
+	uint8_t write_flag)
+{
+	int32_t                            rc = 0;
+	const uint8_t                     *ptr = fw->data;
+	size_t                             total_idx = 0;
+	uint32_t                           txn_regs, chunk_regs, idx;
+	struct cam_sensor_i2c_reg_setting  i2c_reg_setting;
+	struct cam_sensor_i2c_reg_array   *reg;
+
+	if (o_ctrl->ois_fw_txn_data_sz)
+		txn_regs = max_t(uint32_t, 1, o_ctrl->ois_fw_txn_data_sz / step);
 	else
-		txn_data_size = o_ctrl->ois_fw_txn_data_sz;
+		txn_regs = DIV_ROUND_UP(fw->size, step);
 
-	i2c_reg_setting.addr_type = o_ctrl->ois_fw_addr_type;
-	i2c_reg_setting.data_type = o_ctrl->ois_fw_data_type;
-	i2c_reg_setting.delay = 0;
-	txn_regsetting_size = sizeof(struct cam_sensor_i2c_reg_array) * txn_data_size;
-	vaddr = vmalloc(txn_regsetting_size);
-	if (!vaddr) {
+	chunk_regs = txn_regs;
+	if (!o_ctrl->ois_fw_txn_data_sz && o_ctrl->ois_fw_inc_addr)
+		chunk_regs = min_t(uint32_t, txn_regs, CAM_OIS_FW_CHUNK_REGS);
+
+	reg = kvmalloc_array(chunk_regs, sizeof(*reg), GFP_KERNEL);
+	if (!reg) {
 		CAM_ERR(CAM_OIS, "Failed in allocating i2c_array");
-		release_firmware(fw);
 		return -ENOMEM;
 	}
 
-	CAM_DBG(CAM_OIS, "fw len: %d, addr_type: %d, data_type: %d, chunck: %d, ois_fw_data_type:%d", total_bytes,
-	                 i2c_reg_setting.addr_type,
-	                 i2c_reg_setting.data_type,
-	                 txn_data_size,
-	                 o_ctrl->ois_fw_data_type);
-
-	i2c_reg_setting.reg_setting = (struct cam_sensor_i2c_reg_array *) (vaddr);
-
-	for (total_idx = 0, ptr = (uint8_t *)fw->data; total_idx < total_bytes;) {
-		for (packet_idx = 0;
-			(packet_idx < (txn_data_size/o_ctrl->ois_fw_data_type)) && (total_idx + (packet_idx*o_ctrl->ois_fw_data_type) < total_bytes);
-			packet_idx ++, ptr += o_ctrl->ois_fw_data_type)
-		{
-			int regAddrOffset = 0;
-			if(o_ctrl->ois_fw_inc_addr == 1)
-				regAddrOffset = total_idx/o_ctrl->ois_fw_data_type + packet_idx;
-
-			i2c_reg_setting.reg_setting[packet_idx].reg_addr =
-				o_ctrl->opcode.prog + regAddrOffset;
-			if (o_ctrl->ois_fw_data_type == CAMERA_SENSOR_I2C_TYPE_WORD) {
-				i2c_reg_setting.reg_setting[packet_idx].reg_data = (uint32_t)(*ptr << 8) | *(ptr+1);
-			} else {
-				i2c_reg_setting.reg_setting[packet_idx].reg_data = *ptr;
-			}
-			i2c_reg_setting.reg_setting[packet_idx].delay = 0;
-			i2c_reg_setting.reg_setting[packet_idx].data_mask = 0;
-			CAM_DBG(CAM_OIS, "OIS_FW Reg:[0x%04x]: 0x%04x P:0x%x",
-			    i2c_reg_setting.reg_setting[packet_idx].reg_addr,
-			    i2c_reg_setting.reg_setting[packet_idx].reg_data,
-			    (ptr-(uint8_t *)fw->data));
-		}
-		i2c_reg_setting.size = packet_idx;
-		if (o_ctrl->ois_fw_inc_addr == 1) {
-			rc = camera_io_dev_write_continuous(&(o_ctrl->io_master_info),
-				&i2c_reg_setting, 0);
-		} else {
-			rc = camera_io_dev_write_continuous(&(o_ctrl->io_master_info),
-				&i2c_reg_setting, 1);
-		}
+	i2c_reg_setting.addr_type = o_ctrl->ois_fw_addr_type;
+	i2c_reg_setting.data_type = o_ctrl->ois_fw_data_type;
+	i2c_reg_setting.delay = 0;
+	i2c_reg_setting.reg_setting = reg;
+
+	CAM_DBG(CAM_OIS, "fw len: %zu, addr_type: %d, data_type: %d, chunk: %u",
+		fw->size, i2c_reg_setting.addr_type,
+		i2c_reg_setting.data_type, chunk_regs);
+
+	while (total_idx < fw->size) {
+		for (idx = 0; (idx < chunk_regs) &&
+			(total_idx + idx * step < fw->size); idx++, ptr += step) {
+			reg[idx].reg_addr = base_addr;
+			if (o_ctrl->ois_fw_inc_addr == 1)
+				reg[idx].reg_addr += total_idx / step + idx;
+			if (step == CAMERA_SENSOR_I2C_TYPE_WORD)
+				reg[idx].reg_data = (uint32_t)(*ptr << 8) |
+					*(ptr + 1);
+			else
+				reg[idx].reg_data = *ptr;
+			reg[idx].delay = 0;
+			reg[idx].data_mask = 0;
+		}
+		i2c_reg_setting.size = idx;
+
+		rc = camera_io_dev_write_continuous(&(o_ctrl->io_master_info),
+			&i2c_reg_setting, write_flag);
 		if (rc < 0) {
 			CAM_ERR(CAM_OIS, "OIS FW download failed %d", rc);
-			goto release_firmware;
+			break;
 		}
-		total_idx += packet_idx*o_ctrl->ois_fw_data_type;
-		CAM_DBG(CAM_OIS, "packet_idx: %d, total_idx: %d", packet_idx, total_idx);
+		total_idx += idx * step;
 	}
 
-	if (strstr(o_ctrl->ois_name, "dw9781")) {
-		dw9781_post_firmware_download(&(o_ctrl->io_master_info), fw->data, fw->size);
-	}
-
-release_firmware:
-	vfree(vaddr);
-	vaddr = NULL;
-	txn_regsetting_size = 0;
-	release_firmware(fw);
+	kvfree(reg);
 
 	return rc;
 }
 
-static int cam_ois_fw_coeff_download(struct cam_ois_ctrl_t *o_ctrl)
+static int cam_ois_fw_download(struct cam_ois_ctrl_t *o_ctrl,
+	const char *suffix)
 {
-	uint16_t                           total_bytes = 0;
-	uint8_t                           *ptr = NULL;
-	int32_t                            rc = 0, total_idx, packet_idx;
-	uint32_t                           txn_data_size, txn_regsetting_size;
+	int32_t                            rc = 0;
+	bool                               prog = !strcmp(suffix, "prog");
 	const struct firmware             *fw = NULL;
-	const char                        *fw_name_coeff = NULL;
-	char                               name_coeff[32] = {0};
+	const struct cam_ois_fw_ops       *ops;
+	char                               name[32] = {0};
 	struct device                     *dev = &(o_ctrl->pdev->dev);
-	struct cam_sensor_i2c_reg_setting  i2c_reg_setting;
-	void                              *vaddr = NULL;
+	ktime_t                            start;
 
-	if (!o_ctrl) {
-		CAM_ERR(CAM_OIS, "Invalid Args");
-		return -EINVAL;
-	}
-
-	if (strstr(o_ctrl->ois_name, "dw9781") || strstr(o_ctrl->ois_name, "aw86006")) {
-		CAM_DBG(CAM_OIS, "not need download coeff fw for %s.", o_ctrl->ois_name);
+	ops = cam_ois_get_fw_ops(o_ctrl);
+	if (!prog && ops && ops->no_coeff) {
+		CAM_DBG(CAM_OIS, "not need download coeff fw for %s.",
+			o_ctrl->ois_name);
 		return 0;
 	}
 
-	snprintf(name_coeff, 32, "%s.coeff", o_ctrl->ois_name);
-	fw_name_coeff = name_coeff;
+	snprintf(name, sizeof(name), "%s.%s", o_ctrl->ois_name, suffix);
 
-	rc = request_firmware(&fw, fw_name_coeff, dev);
+	/* Load FW */
+	rc = request_firmware(&fw, name, dev);
 	if (rc) {
-		CAM_ERR(CAM_OIS, "Failed to locate %s", fw_name_coeff);
+		CAM_ERR(CAM_OIS, "Failed to locate %s", name);
 		return rc;
 	}
 
-	total_bytes = fw->size;
-	if(o_ctrl->ois_fw_txn_data_sz == 0)
-		txn_data_size = total_bytes;
-	else
-		txn_data_size = o_ctrl->ois_fw_txn_data_sz;
+	start = ktime_get();
+	if (prog && ops && ops->download)
+		return ops->download(o_ctrl, fw);
 
-	i2c_reg_setting.addr_type = o_ctrl->ois_fw_addr_type;
-	i2c_reg_setting.data_type = o_ctrl->ois_fw_data_type;
-	i2c_reg_setting.delay = 0;
-	txn_regsetting_size = sizeof(struct cam_sensor_i2c_reg_array) * txn_data_size;
-	vaddr = vmalloc(txn_regsetting_size);
-	if (!vaddr) {
-		CAM_ERR(CAM_OIS, "Failed in allocating i2c_array");
-		release_firmware(fw);
-		return -ENOMEM;
+	if (prog && ops && ops->fw_resident &&
+		ops->fw_resident(o_ctrl, fw)) {
+		CAM_INFO(CAM_OIS, "Skip firmware download.");
+		cam_ois_fw_update_stats(o_ctrl, name, 0, start, true);
+		goto release_firmware;
 	}
 
-	i2c_reg_setting.reg_setting = (struct cam_sensor_i2c_reg_array *) (vaddr);
+	if (prog) {
+		if (ops)
+			CAM_INFO(CAM_OIS, "Firmware download started.");
+		rc = cam_ois_fw_stream(o_ctrl, fw, o_ctrl->opcode.prog,
+			o_ctrl->ois_fw_data_type,
+			(o_ctrl->ois_fw_inc_addr == 1) ? 0 : 1);
+	} else {
+		rc = cam_ois_fw_stream(o_ctrl, fw, o_ctrl->opcode.coeff,
+			CAMERA_SENSOR_I2C_TYPE_BYTE, 1);
+	}
+	if (rc < 0)
+		goto release_firmware;
 
-	for (total_idx = 0, ptr = (uint8_t *)fw->data; total_idx < total_bytes;) {
-		for(packet_idx = 0;
-			(packet_idx < txn_data_size) && (total_idx + packet_idx < total_bytes);
-			packet_idx++, ptr++)
-		{
-			int regAddrOffset = 0;
-			if(o_ctrl->ois_fw_inc_addr == 1)
-				regAddrOffset = total_idx + packet_idx;
+	cam_ois_fw_update_stats(o_ctrl, name, fw->size, start, false);
 
-			i2c_reg_setting.reg_setting[packet_idx].reg_addr =
-				o_ctrl->opcode.coeff + regAddrOffset;
-			i2c_reg_setting.reg_setting[packet_idx].reg_data = *ptr;
-			i2c_reg_setting.reg_setting[packet_idx].delay = 0;
-			i2c_reg_setting.reg_setting[packet_idx].data_mask = 0;
-		}
-		i2c_reg_setting.size = packet_idx;
-		rc = camera_io_dev_write_continuous(&(o_ctrl->io_master_info),
-			&i2c_reg_setting, 1);
-		if (rc < 0) {
-			CAM_ERR(CAM_OIS, "OIS FW download failed %d", rc);
-			goto release_firmware;
-		}
-		total_idx += packet_idx;
-	}
+	if (prog && ops && ops->post_download)
+		ops->post_download(o_ctrl, fw);
 
 release_firmware:
-	vfree(vaddr);
-	vaddr = NULL;
-	txn_regsetting_size = 0;
 	release_firmware(fw);
 
 	return rc;
 }
 
+static int cam_ois_fw_prog_download(struct cam_ois_ctrl_t *o_ctrl)
+{
+	if (!o_ctrl) {
+		CAM_ERR(CAM_OIS, "Invalid Args");
+		return -EINVAL;
+	}
+
+	return cam_ois_fw_download(o_ctrl, "prog");
+}
+
+static int cam_ois_fw_coeff_download(struct cam_ois_ctrl_t *o_ctrl)
+{
+	if (!o_ctrl) {
+		CAM_ERR(CAM_OIS, "Invalid Args");
+		return -EINVAL;
+	}
+
+	return cam_ois_fw_download(o_ctrl, "coeff");
+}
+
 static int cam_ois_write_q_timer(struct cam_ois_ctrl_t *o_ctrl)
 {
 	struct cam_sensor_i2c_reg_setting i2c_reg_setting = {NULL,1,CAMERA_SENSOR_I2C_TYPE_WORD,CAMERA_SENSOR_I2C_TYPE_WORD,0};
@@ -30,5 +30,18 @@ int cam_ois_driver_cmd(struct cam_ois_ctrl_t *e_ctrl, void *arg);
  */
 void cam_ois_shutdown(struct cam_ois_ctrl_t *o_ctrl);
 
+/**
+ * @buf: Output buffer
+ * @size: Size of the output buffer
+ *
+ * This API prints the firmware download statistics
+ */
+int cam_ois_dump_fw_stats(char *buf, size_t size);
+
+/**
+ * This API clears the firmware download statistics
+ */
+void cam_ois_reset_fw_stats(void);
+
 #endif
 /* _CAM_OIS_CORE_H_ */
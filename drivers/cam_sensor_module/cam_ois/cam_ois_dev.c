@@ -772,6 +772,49 @@ static struct i2c_driver cam_ois_i2c_driver = {
 static struct cam_ois_registered_driver_t registered_driver = {
 	0, 0};
 
+static struct dentry *debugfs_root;
+
+static ssize_t cam_ois_fw_stats_read(struct file *t_file, char *t_char,
+	size_t t_size_t, loff_t *t_loff_t)
+{
+	char out_buffer[256];
+	int len;
+
+	len = cam_ois_dump_fw_stats(out_buffer, sizeof(out_buffer));
+
+	return simple_read_from_buffer(t_char, t_size_t,
+		t_loff_t, out_buffer, len);
+}
+
+static ssize_t cam_ois_fw_stats_write(struct file *t_file,
+	const char *t_char, size_t t_size_t, loff_t *t_loff_t)
+{
+	cam_ois_reset_fw_stats();
+
+	return t_size_t;
+}
+
+static const struct file_operations cam_ois_fw_stats_fops = {
+	.open = simple_open,
+	.read = cam_ois_fw_stats_read,
+	.write = cam_ois_fw_stats_write,
+};
+
+static void cam_ois_create_debugfs_entry(void)
+{
+	struct dentry *dbgfileptr = NULL;
+
+	dbgfileptr = debugfs_create_dir("cam_ois", NULL);
+	if (IS_ERR_OR_NULL(dbgfileptr)) {
+		CAM_WARN(CAM_OIS, "debugfs directory creation fail");
+		return;
+	}
+	debugfs_root = dbgfileptr;
+
+	debugfs_create_file("fw_stats", 0644, debugfs_root, NULL,
+		&cam_ois_fw_stats_fops);
+}
+
 int cam_ois_driver_init(void)
 {
 	int rc = 0;
@@ -792,11 +835,15 @@ int cam_ois_driver_init(void)
 	}
 
 	registered_driver.i2c_driver = 1;
+	cam_ois_create_debugfs_entry();
 	return rc;
 }
 
 void cam_ois_driver_exit(void)
 {
+	debugfs_remove_recursive(debugfs_root);
+	debugfs_root = NULL;
+
 	if (registered_driver.platform_driver)
 		platform_driver_unregister(&cam_ois_platform_driver);
 
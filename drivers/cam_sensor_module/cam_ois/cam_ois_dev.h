@@ -195,6 +195,26 @@ struct cam_ois_ctrl_t {
 	bool is_need_eis_data;
 };
 
+/**
+ * struct cam_ois_fw_stats - OIS firmware download statistics
+ * @downloads:   Completed generic downloads
+ * @skipped:     Downloads skipped because the firmware was resident
+ * @last_name:   Firmware file of the last download
+ * @last_bytes:  Size of the last download
+ * @last_us:     Duration of the last download
+ * @total_bytes: Bytes downloaded since the last reset
+ * @total_us:    Time spent downloading since the last reset
+ */
+struct cam_ois_fw_stats {
+	uint64_t downloads;
+	uint64_t skipped;
+	char last_name[32];
+	uint64_t last_bytes;
+	uint64_t last_us;
+	uint64_t total_bytes;
+	uint64_t total_us;
+};
+
 /**
  * @brief : API to register OIS hw to platform framework.
  * @return struct platform_device pointer on on success, or ERR_PTR() on error.
@@ -318,6 +318,17 @@ static int32_t cam_sensor_i2c_pkt_parse(struct cam_sensor_ctrl_t *s_ctrl,
 		goto end;
 	}
 
+	if (((csl_packet->header.op_code & 0xFFFFFF) ==
+		CAM_SENSOR_PACKET_OPCODE_SENSOR_UPDATE) ||
+		((csl_packet->header.op_code & 0xFFFFFF) ==
+		CAM_SENSOR_PACKET_OPCODE_SENSOR_FRAME_SKIP_UPDATE)) {
+		/* Keep the apply path to as few transfers as possible */
+		if (cam_sensor_util_flatten_settings(i2c_reg_settings))
+			CAM_WARN(CAM_SENSOR,
+				"Failed to flatten req %lld, applying as is",
+				csl_packet->header.request_id);
+	}
+
 	if ((csl_packet->header.op_code & 0xFFFFFF) ==
 		CAM_SENSOR_PACKET_OPCODE_SENSOR_UPDATE) {
 		i2c_reg_settings->request_id =
@@ -916,6 +927,44 @@ int cam_sensor_match_sub_device_id(struct cam_sensor_ctrl_t *s_ctrl)
 	return rc;
 }
 
+static void cam_sensor_update_apply_stats(struct cam_sensor_ctrl_t *s_ctrl,
+	ktime_t start_ts)
+{
+	struct cam_sensor_apply_stats *stats = &s_ctrl->apply_stats;
+	uint32_t duration_us;
+	int bucket;
+
+	duration_us = (uint32_t)ktime_us_delta(ktime_get(), start_ts);
+	bucket = min_t(int, fls(duration_us / 250),
+		CAM_SENSOR_APPLY_HIST_BUCKETS - 1);
+
+	stats->hist[bucket]++;
+	stats->count++;
+	if (duration_us > stats->max_us)
+		stats->max_us = duration_us;
+}
+
+static void cam_sensor_dump_apply_stats(struct cam_sensor_ctrl_t *s_ctrl)
+{
+	struct cam_sensor_apply_stats *stats = &s_ctrl->apply_stats;
+	char line[128];
+	int i, len = 0;
+
+	if (!stats->count)
+		return;
+
+	for (i = 0; i < CAM_SENSOR_APPLY_HIST_BUCKETS - 1; i++)
+		len += scnprintf(line + len, sizeof(line) - len, " <%u:%u",
+			250U << i, stats->hist[i]);
+	scnprintf(line + len, sizeof(line) - len, " >=%u:%u",
+		250U << (CAM_SENSOR_APPLY_HIST_BUCKETS - 2), stats->hist[i]);
+
+	CAM_INFO(CAM_SENSOR,
+		"sensor_id:0x%x applies %u max %uus apply_us%s",
+		s_ctrl->sensordata->slave_info.sensor_id, stats->count,
+		stats->max_us, line);
+}
+
 int32_t cam_sensor_driver_cmd(struct cam_sensor_ctrl_t *s_ctrl,
 	void *arg)
 {
@@ -1193,6 +1242,7 @@ int32_t cam_sensor_driver_cmd(struct cam_sensor_ctrl_t *s_ctrl,
 			}
 		}
 		s_ctrl->sensor_state = CAM_SENSOR_START;
+		memset(&s_ctrl->apply_stats, 0, sizeof(s_ctrl->apply_stats));
 
 		if (s_ctrl->bridge_intf.crm_cb &&
 			s_ctrl->bridge_intf.crm_cb->notify_timer) {
@@ -1234,6 +1284,7 @@ int32_t cam_sensor_driver_cmd(struct cam_sensor_ctrl_t *s_ctrl,
 		}
 
 		cam_sensor_release_per_frame_resource(s_ctrl);
+		cam_sensor_dump_apply_stats(s_ctrl);
 		s_ctrl->last_flush_req = 0;
 		s_ctrl->sensor_state = CAM_SENSOR_ACQUIRE;
 		CAM_INFO(CAM_SENSOR,
@@ -1513,6 +1564,7 @@ int cam_sensor_apply_settings(struct cam_sensor_ctrl_t *s_ctrl,
 	uint64_t top = 0, del_req_id = 0;
 	struct i2c_settings_array *i2c_set = NULL;
 	struct i2c_settings_list *i2c_list;
+	ktime_t start_ts;
 
 	if (req_id == 0) {
 		switch (opcode) {
@@ -1562,6 +1614,7 @@ int cam_sensor_apply_settings(struct cam_sensor_ctrl_t *s_ctrl,
 
 		if (i2c_set[offset].is_settings_valid == 1 &&
 			i2c_set[offset].request_id == req_id) {
+			start_ts = ktime_get();
 			list_for_each_entry(i2c_list,
 				&(i2c_set[offset].list_head), list) {
 				rc = cam_sensor_i2c_modes_util(
@@ -1574,6 +1627,7 @@ int cam_sensor_apply_settings(struct cam_sensor_ctrl_t *s_ctrl,
 					return rc;
 				}
 			}
+			cam_sensor_update_apply_stats(s_ctrl, start_ts);
 			CAM_DBG(CAM_SENSOR, "applied req_id: %llu", req_id);
 		} else {
 			CAM_DBG(CAM_SENSOR,
@@ -7,6 +7,7 @@
 #include "cam_req_mgr_dev.h"
 #include "cam_sensor_soc.h"
 #include "cam_sensor_core.h"
+#include "cam_sensor_i2c.h"
 #include "camera_main.h"
 
 static int cam_sensor_subdev_close_internal(struct v4l2_subdev *sd,
@@ -466,11 +467,14 @@ int cam_sensor_driver_init(void)
 	if (rc)
 		CAM_ERR(CAM_SENSOR, "i2c_add_driver failed rc = %d", rc);
 
+	cam_qup_i2c_debugfs_init();
+
 	return rc;
 }
 
 void cam_sensor_driver_exit(void)
 {
+	cam_qup_i2c_debugfs_deinit();
 	platform_driver_unregister(&cam_sensor_platform_driver);
 	i2c_del_driver(&cam_sensor_driver_i2c);
 }
@@ -35,6 +35,12 @@
 #define CDBG(fmt, args...) pr_debug(fmt, ##args)
 #endif
 
+/*
+ * Per frame apply duration histogram, bucket n counts applies
+ * below (250us << n), last bucket is open ended
+ */
+#define CAM_SENSOR_APPLY_HIST_BUCKETS 7
+
 #define SENSOR_DRIVER_I2C "i2c_camera"
 #define CAMX_SENSOR_DEV_NAME "cam-sensor-driver"
 
@@ -61,6 +67,18 @@ struct sensor_intf_params {
 	struct cam_req_mgr_crm_cb *crm_cb;
 };
 
+/**
+ * struct cam_sensor_apply_stats
+ * @hist: Apply duration histogram
+ * @max_us: Longest apply seen
+ * @count: Number of per frame applies
+ */
+struct cam_sensor_apply_stats {
+	uint32_t hist[CAM_SENSOR_APPLY_HIST_BUCKETS];
+	uint32_t max_us;
+	uint32_t count;
+};
+
 /**
  * struct cam_sensor_ctrl_t: Camera control structure
  * @device_name: Sensor device name
@@ -85,6 +103,7 @@ struct sensor_intf_params {
  * @bob_pwm_switch: Boolean flag to switch into PWM mode for BoB regulator
  * @last_flush_req: Last request to flush
  * @pipeline_delay: Sensor pipeline delay
+ * @apply_stats: Per frame apply duration stats since stream on
  */
 struct cam_sensor_ctrl_t {
 	char device_name[CAM_CTX_DEV_NAME_MAX_LENGTH];
@@ -128,6 +147,7 @@ struct cam_sensor_ctrl_t {
 	uint16_t i2c_switch_reg_addr;
 	uint16_t i2c_switch_reg_data;
 	uint16_t i2c_switch_reg_delayMs;
+	struct cam_sensor_apply_stats apply_stats;
 };
 
 /**
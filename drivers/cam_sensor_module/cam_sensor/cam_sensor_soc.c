@@ -187,6 +187,16 @@ static int32_t cam_sensor_driver_get_dt_data(struct cam_sensor_ctrl_t *s_ctrl)
 		CAM_DBG(CAM_SENSOR, "cci-index %d", s_ctrl->cci_num);
 	}
 
+	if (s_ctrl->io_master_info.master_type == I2C_MASTER) {
+		s_ctrl->io_master_info.qup_batch_en =
+			of_property_read_bool(of_node, "i2c-batch-write");
+		s_ctrl->io_master_info.qup_auto_inc =
+			of_property_read_bool(of_node, "i2c-auto-increment");
+		CAM_DBG(CAM_SENSOR, "i2c batch write %d auto increment %d",
+			s_ctrl->io_master_info.qup_batch_en,
+			s_ctrl->io_master_info.qup_auto_inc);
+	}
+
 	if (of_property_read_bool(of_node, "need-change-cci-master")) {
 		CAM_DBG(CAM_SENSOR, "need-change-cci-master found in this imgsensor");
 		s_ctrl->need_change_cci_master = true;
@@ -177,4 +177,20 @@ int32_t cam_qup_i2c_write_continuous_table(
 	struct cam_sensor_i2c_reg_setting *write_setting,
 	uint8_t cam_sensor_i2c_write_flag);
 
+/**
+ * cam_qup_i2c_release : Free the QUP batch buffers of a client
+ * @client: QUP I2C client structure
+ */
+void cam_qup_i2c_release(struct camera_io_master *client);
+
+/**
+ * cam_qup_i2c_debugfs_init : Create the QUP batching debugfs entries
+ */
+void cam_qup_i2c_debugfs_init(void);
+
+/**
+ * cam_qup_i2c_debugfs_deinit : Remove the QUP batching debugfs entries
+ */
+void cam_qup_i2c_debugfs_deinit(void);
+
 #endif /*_CAM_SENSOR_I2C_H*/
@@ -350,8 +350,10 @@ int32_t camera_io_release(struct camera_io_master *io_master_info)
 	if (io_master_info->master_type == CCI_MASTER) {
 		return cam_sensor_cci_i2c_util(io_master_info->cci_client,
 			MSM_CCI_RELEASE);
-	} else if ((io_master_info->master_type == I2C_MASTER) ||
-			(io_master_info->master_type == SPI_MASTER)) {
+	} else if (io_master_info->master_type == I2C_MASTER) {
+		cam_qup_i2c_release(io_master_info);
+		return 0;
+	} else if (io_master_info->master_type == SPI_MASTER) {
 		return 0;
 	}
 
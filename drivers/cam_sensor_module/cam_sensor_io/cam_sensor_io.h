@@ -14,17 +14,26 @@
 #define I2C_MASTER 2
 #define SPI_MASTER 3
 
+struct cam_qup_i2c_batch;
+
 /**
  * @master_type: CCI master type
  * @client: I2C client information structure
  * @cci_client: CCI client information structure
  * @spi_client: SPI client information structure
+ * @qup_batch: Reusable QUP table write buffers, allocated on first use
+ * @qup_batch_en: Send QUP table writes as multi-message transfers
+ * @qup_auto_inc: Device auto-increments register addresses, contiguous
+ *                runs of a batched table may go out as one burst
  */
 struct camera_io_master {
 	int master_type;
 	struct i2c_client *client;
 	struct cam_sensor_cci_client *cci_client;
 	struct cam_sensor_spi_client *spi_client;
+	struct cam_qup_i2c_batch *qup_batch;
+	bool qup_batch_en;
+	bool qup_auto_inc;
 };
 
 /**
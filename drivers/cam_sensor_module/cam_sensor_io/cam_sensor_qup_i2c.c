@@ -9,6 +9,47 @@
 
 #define I2C_REG_MAX_BUF_SIZE   8
 
+/* Bytes of table data packed into one i2c_transfer() */
+#define CAM_QUP_BATCH_BUF_SIZE  1024
+#define CAM_QUP_BATCH_MAX_MSGS  64
+/* Shortest auto-increment run sent as a single burst message */
+#define CAM_QUP_BURST_MIN_REGS  4
+
+enum cam_qup_i2c_mode {
+	CAM_QUP_MODE_SINGLE,
+	CAM_QUP_MODE_BATCH,
+	CAM_QUP_MODE_MAX,
+};
+
+/**
+ * struct cam_qup_i2c_batch
+ * @buf:  DMA safe staging buffer for the packed messages
+ * @msgs: Messages handed to one i2c_transfer() call
+ */
+struct cam_qup_i2c_batch {
+	uint8_t *buf;
+	struct i2c_msg msgs[CAM_QUP_BATCH_MAX_MSGS];
+};
+
+/**
+ * struct cam_qup_i2c_stats
+ * @tables:       Number of write_table calls
+ * @regs:         Registers written
+ * @xfers:        i2c_transfer() calls issued
+ * @total_us:     Time spent on the bus, excluding the table delay
+ * @max_us:       Longest single table
+ */
+struct cam_qup_i2c_stats {
+	atomic64_t tables;
+	atomic64_t regs;
+	atomic64_t xfers;
+	atomic64_t total_us;
+	atomic64_t max_us;
+};
+
+static struct cam_qup_i2c_stats qup_stats[CAM_QUP_MODE_MAX];
+static struct dentry *qup_debugfs_root;
+
 static int32_t cam_qup_i2c_rxdata(
 	struct i2c_client *dev_client, unsigned char *rxdata,
 	enum camera_sensor_i2c_type addr_type,
@@ -329,12 +370,212 @@ deallocate_buffer:
 	return rc;
 }
 
+static int32_t cam_qup_i2c_write_burst(struct camera_io_master *client,
+	struct cam_sensor_i2c_reg_setting *write_setting);
+
+static inline uint32_t cam_qup_i2c_pack(uint8_t *buf, uint32_t val,
+	enum camera_sensor_i2c_type type)
+{
+	int i;
+
+	for (i = 0; i < type; i++)
+		buf[i] = val >> (BITS_PER_BYTE * (type - 1 - i));
+
+	return type;
+}
+
+static int32_t cam_qup_i2c_get_batch(struct camera_io_master *client,
+	struct cam_qup_i2c_batch **batch)
+{
+	struct cam_qup_i2c_batch *new_batch;
+
+	if (client->qup_batch) {
+		*batch = client->qup_batch;
+		return 0;
+	}
+
+	new_batch = kzalloc(sizeof(*new_batch), GFP_KERNEL);
+	if (!new_batch)
+		return -ENOMEM;
+
+	new_batch->buf = kzalloc(CAM_QUP_BATCH_BUF_SIZE, GFP_KERNEL | GFP_DMA);
+	if (!new_batch->buf) {
+		kfree(new_batch);
+		return -ENOMEM;
+	}
+
+	client->qup_batch = new_batch;
+	*batch = new_batch;
+
+	return 0;
+}
+
+void cam_qup_i2c_release(struct camera_io_master *client)
+{
+	if (!client || !client->qup_batch)
+		return;
+
+	kfree(client->qup_batch->buf);
+	kfree(client->qup_batch);
+	client->qup_batch = NULL;
+}
+
+static uint32_t cam_qup_i2c_max_msgs(struct i2c_adapter *adapter)
+{
+	const struct i2c_adapter_quirks *q = adapter->quirks;
+
+	if (!q)
+		return CAM_QUP_BATCH_MAX_MSGS;
+
+#ifdef I2C_AQ_NO_REP_START
+	if (q->flags & I2C_AQ_NO_REP_START)
+		return 1;
+#endif
+	if (q->max_num_msgs)
+		return min_t(uint32_t, q->max_num_msgs,
+			CAM_QUP_BATCH_MAX_MSGS);
+
+	return CAM_QUP_BATCH_MAX_MSGS;
+}
+
+static int32_t cam_qup_i2c_flush_batch(struct camera_io_master *client,
+	struct cam_qup_i2c_batch *batch, uint32_t num_msgs)
+{
+	int32_t rc;
+
+	rc = i2c_transfer(client->client->adapter, batch->msgs, num_msgs);
+	atomic64_inc(&qup_stats[CAM_QUP_MODE_BATCH].xfers);
+	if (rc != num_msgs) {
+		CAM_ERR(CAM_SENSOR, "failed 0x%x num_msgs: %u rc: %d",
+			client->client->addr >> 1, num_msgs, rc);
+		return rc < 0 ? rc : -EIO;
+	}
+
+	return 0;
+}
+
+/*
+ * Pack the table into the client's staging buffer, one i2c_msg per
+ * register, and send as many messages per i2c_transfer() as the adapter
+ * allows. On devices that auto-increment register addresses, runs of at
+ * least CAM_QUP_BURST_MIN_REGS registers whose addresses advance by the
+ * data width go out through cam_qup_i2c_write_burst() instead.
+ */
+static int32_t cam_qup_i2c_write_table_batch(struct camera_io_master *client,
+	struct cam_sensor_i2c_reg_setting *write_setting)
+{
+	int32_t rc;
+	struct cam_qup_i2c_batch *batch = NULL;
+	struct cam_sensor_i2c_reg_array *reg_setting;
+	struct cam_sensor_i2c_reg_setting burst_setting;
+	struct i2c_msg *msg;
+	enum camera_sensor_i2c_type addr_type = write_setting->addr_type;
+	enum camera_sensor_i2c_type data_type = write_setting->data_type;
+	uint16_t saddr = client->client->addr >> 1;
+	uint32_t max_msgs, max_run = 1, num_msgs = 0, used = 0;
+	uint32_t i = 0, run, len;
+
+	rc = cam_qup_i2c_get_batch(client, &batch);
+	if (rc) {
+		CAM_ERR(CAM_SENSOR, "Batch buffer allocation failed");
+		return rc;
+	}
+
+	reg_setting = write_setting->reg_setting;
+	max_msgs = cam_qup_i2c_max_msgs(client->client->adapter);
+	if (client->qup_auto_inc) {
+		max_run = I2C_REG_DATA_MAX / data_type;
+		if (client->client->adapter->quirks &&
+			client->client->adapter->quirks->max_write_len)
+			max_run = max_t(uint32_t, 1, min_t(uint32_t, max_run,
+				(client->client->adapter->quirks->max_write_len -
+				addr_type) / data_type));
+	}
+
+	while (i < write_setting->size) {
+		run = 1;
+		while ((i + run < write_setting->size) && (run < max_run) &&
+			(reg_setting[i + run].reg_addr ==
+			reg_setting[i + run - 1].reg_addr + data_type))
+			run++;
+
+		if (run >= CAM_QUP_BURST_MIN_REGS) {
+			if (num_msgs) {
+				rc = cam_qup_i2c_flush_batch(client, batch,
+					num_msgs);
+				if (rc)
+					return rc;
+				num_msgs = 0;
+				used = 0;
+			}
+
+			burst_setting = *write_setting;
+			burst_setting.reg_setting = &reg_setting[i];
+			burst_setting.size = run;
+			burst_setting.delay = 0;
+			rc = cam_qup_i2c_write_burst(client, &burst_setting);
+			atomic64_inc(&qup_stats[CAM_QUP_MODE_BATCH].xfers);
+			if (rc < 0)
+				return rc;
+
+			CAM_DBG(CAM_SENSOR, "burst addr 0x%x run %u",
+				reg_setting[i].reg_addr, run);
+			i += run;
+			continue;
+		}
+
+		len = addr_type + data_type;
+		if ((num_msgs == max_msgs) ||
+			(used + len > CAM_QUP_BATCH_BUF_SIZE)) {
+			rc = cam_qup_i2c_flush_batch(client, batch, num_msgs);
+			if (rc)
+				return rc;
+			num_msgs = 0;
+			used = 0;
+		}
+
+		msg = &batch->msgs[num_msgs++];
+		msg->addr = saddr;
+		msg->flags = 0;
+		msg->buf = batch->buf + used;
+		len = cam_qup_i2c_pack(msg->buf, reg_setting[i].reg_addr,
+			addr_type);
+		len += cam_qup_i2c_pack(msg->buf + len,
+			reg_setting[i].reg_data, data_type);
+		msg->len = len;
+		used += len;
+
+		CAM_DBG(CAM_SENSOR, "addr 0x%x data 0x%x",
+			reg_setting[i].reg_addr, reg_setting[i].reg_data);
+		i++;
+	}
+
+	if (num_msgs)
+		rc = cam_qup_i2c_flush_batch(client, batch, num_msgs);
+
+	return rc;
+}
+
+static void cam_qup_i2c_update_stats(enum cam_qup_i2c_mode mode,
+	uint32_t num_regs, ktime_t start)
+{
+	struct cam_qup_i2c_stats *stats = &qup_stats[mode];
+	int64_t us = ktime_us_delta(ktime_get(), start);
+
+	atomic64_inc(&stats->tables);
+	atomic64_add(num_regs, &stats->regs);
+	atomic64_add(us, &stats->total_us);
+	if (us > atomic64_read(&stats->max_us))
+		atomic64_set(&stats->max_us, us);
+}
+
 int32_t cam_qup_i2c_write_table(struct camera_io_master *client,
 	struct cam_sensor_i2c_reg_setting *write_setting)
 {
 	int i;
 	int32_t rc = -EINVAL;
 	struct cam_sensor_i2c_reg_array *reg_setting;
+	ktime_t start;
 
 	if (!client || !write_setting)
 		return rc;
@@ -346,6 +587,14 @@ int32_t cam_qup_i2c_write_table(struct camera_io_master *client,
 		return rc;
 
 	reg_setting = write_setting->reg_setting;
+	start = ktime_get();
+
+	if (client->qup_batch_en) {
+		rc = cam_qup_i2c_write_table_batch(client, write_setting);
+		cam_qup_i2c_update_stats(CAM_QUP_MODE_BATCH,
+			write_setting->size, start);
+		goto delay;
+	}
 
 	for (i = 0; i < write_setting->size; i++) {
 		CAM_DBG(CAM_SENSOR, "addr 0x%x data 0x%x",
@@ -353,11 +602,15 @@ int32_t cam_qup_i2c_write_table(struct camera_io_master *client,
 
 		rc = cam_qup_i2c_write(client, reg_setting,
 			write_setting->addr_type, write_setting->data_type);
+		atomic64_inc(&qup_stats[CAM_QUP_MODE_SINGLE].xfers);
 		if (rc < 0)
 			break;
 		reg_setting++;
 	}
+	cam_qup_i2c_update_stats(CAM_QUP_MODE_SINGLE, write_setting->size,
+		start);
 
+delay:
 	if (write_setting->delay > 20)
 		msleep(write_setting->delay);
 	else if (write_setting->delay)
@@ -537,3 +790,70 @@ int32_t cam_qup_i2c_write_continuous_table(struct camera_io_master *client,
 
 	return rc;
 }
+
+static ssize_t cam_qup_i2c_stats_read(struct file *t_file, char *t_char,
+	size_t t_size_t, loff_t *t_loff_t)
+{
+	static const char * const mode_name[CAM_QUP_MODE_MAX] = {
+		"single", "batch" };
+	struct cam_qup_i2c_stats *stats;
+	char out_buffer[256];
+	int i, len = 0;
+
+	for (i = 0; i < CAM_QUP_MODE_MAX; i++) {
+		stats = &qup_stats[i];
+		len += scnprintf(out_buffer + len, sizeof(out_buffer) - len,
+			"%s: tables %lld regs %lld xfers %lld total_us %lld max_us %lld\n",
+			mode_name[i], atomic64_read(&stats->tables),
+			atomic64_read(&stats->regs),
+			atomic64_read(&stats->xfers),
+			atomic64_read(&stats->total_us),
+			atomic64_read(&stats->max_us));
+	}
+
+	return simple_read_from_buffer(t_char, t_size_t,
+		t_loff_t, out_buffer, len);
+}
+
+static ssize_t cam_qup_i2c_stats_write(struct file *t_file,
+	const char *t_char, size_t t_size_t, loff_t *t_loff_t)
+{
+	int i;
+
+	for (i = 0; i < CAM_QUP_MODE_MAX; i++) {
+		atomic64_set(&qup_stats[i].tables, 0);
+		atomic64_set(&qup_stats[i].regs, 0);
+		atomic64_set(&qup_stats[i].xfers, 0);
+		atomic64_set(&qup_stats[i].total_us, 0);
+		atomic64_set(&qup_stats[i].max_us, 0);
+	}
+
+	return t_size_t;
+}
+
+static const struct file_operations cam_qup_i2c_stats_fops = {
+	.open = simple_open,
+	.read = cam_qup_i2c_stats_read,
+	.write = cam_qup_i2c_stats_write,
+};
+
+void cam_qup_i2c_debugfs_init(void)
+{
+	struct dentry *dbgfileptr = NULL;
+
+	dbgfileptr = debugfs_create_dir("cam_sensor_qup", NULL);
+	if (IS_ERR_OR_NULL(dbgfileptr)) {
+		CAM_WARN(CAM_SENSOR, "debugfs directory creation fail");
+		return;
+	}
+	qup_debugfs_root = dbgfileptr;
+
+	debugfs_create_file("write_table_stats", 0644, qup_debugfs_root,
+		NULL, &cam_qup_i2c_stats_fops);
+}
+
+void cam_qup_i2c_debugfs_deinit(void)
+{
+	debugfs_remove_recursive(qup_debugfs_root);
+	qup_debugfs_root = NULL;
+}
@@ -108,6 +108,90 @@ int32_t delete_request(struct i2c_settings_array *i2c_array)
 	return rc;
 }
 
+static bool cam_sensor_util_can_merge(struct i2c_settings_list *head,
+	struct i2c_settings_list *next, uint32_t total)
+{
+	return (next->op_code == CAM_SENSOR_I2C_WRITE_RANDOM) &&
+		(!head->i2c_settings.delay) &&
+		(head->i2c_settings.addr_type ==
+			next->i2c_settings.addr_type) &&
+		(head->i2c_settings.data_type ==
+			next->i2c_settings.data_type) &&
+		((total + next->i2c_settings.size) <=
+			CAM_SENSOR_FLATTEN_MAX_REGS);
+}
+
+/*
+ * Merge runs of back to back random writes with matching addr/data
+ * types into one table, so each run is applied as a single transfer.
+ * Runs end at a node level delay or any other op code. Register order
+ * is kept, the io master packs adjacent addresses on its own.
+ */
+int32_t cam_sensor_util_flatten_settings(struct i2c_settings_array *i2c_array)
+{
+	struct i2c_settings_list *head, *i2c_list, *i2c_next;
+	struct cam_sensor_i2c_reg_array *reg_setting;
+	uint32_t total, num_nodes, copied;
+
+	if (i2c_array == NULL) {
+		CAM_ERR(CAM_SENSOR, "FATAL:: Invalid argument");
+		return -EINVAL;
+	}
+
+	list_for_each_entry(head, &(i2c_array->list_head), list) {
+		if (head->op_code != CAM_SENSOR_I2C_WRITE_RANDOM)
+			continue;
+
+		/* Size the run before allocating */
+		total = head->i2c_settings.size;
+		num_nodes = 1;
+		i2c_list = head;
+		list_for_each_entry_continue(i2c_list,
+			&(i2c_array->list_head), list) {
+			if (!cam_sensor_util_can_merge(head, i2c_list, total))
+				break;
+			total += i2c_list->i2c_settings.size;
+			num_nodes++;
+			if (i2c_list->i2c_settings.delay)
+				break;
+		}
+
+		if (num_nodes == 1)
+			continue;
+
+		reg_setting = vzalloc(total *
+			sizeof(struct cam_sensor_i2c_reg_array));
+		if (!reg_setting)
+			return -ENOMEM;
+
+		copied = head->i2c_settings.size;
+		memcpy(reg_setting, head->i2c_settings.reg_setting,
+			copied * sizeof(struct cam_sensor_i2c_reg_array));
+
+		i2c_list = list_next_entry(head, list);
+		while (--num_nodes) {
+			i2c_next = list_next_entry(i2c_list, list);
+			memcpy(reg_setting + copied,
+				i2c_list->i2c_settings.reg_setting,
+				i2c_list->i2c_settings.size *
+				sizeof(struct cam_sensor_i2c_reg_array));
+			copied += i2c_list->i2c_settings.size;
+			head->i2c_settings.delay = i2c_list->i2c_settings.delay;
+
+			vfree(i2c_list->i2c_settings.reg_setting);
+			list_del(&(i2c_list->list));
+			kfree(i2c_list);
+			i2c_list = i2c_next;
+		}
+
+		vfree(head->i2c_settings.reg_setting);
+		head->i2c_settings.reg_setting = reg_setting;
+		head->i2c_settings.size = total;
+	}
+
+	return 0;
+}
+
 int32_t cam_sensor_handle_delay(
 	uint32_t **cmd_buf,
 	uint16_t generic_op_code,
@@ -32,6 +32,9 @@
 #define QTIMER_MUL_FACTOR   10000
 #define QTIMER_DIV_FACTOR   192
 
+/* Max registers in one flattened random write */
+#define CAM_SENSOR_FLATTEN_MAX_REGS 1024
+
 int cam_get_dt_power_setting_data(struct device_node *of_node,
 	struct cam_hw_soc_info *soc_info,
 	struct cam_sensor_power_ctrl_t *power_info);
@@ -60,6 +63,8 @@ int32_t cam_sensor_i2c_read_data(
 	struct camera_io_master *io_master_info);
 
 int32_t delete_request(struct i2c_settings_array *i2c_array);
+
+int32_t cam_sensor_util_flatten_settings(struct i2c_settings_array *i2c_array);
 int cam_sensor_util_request_gpio_table(
 	struct cam_hw_soc_info *soc_info, int gpio_en);
 
@@ -16,6 +16,7 @@
 #include <linux/genalloc.h>
 #include <linux/debugfs.h>
 #include <linux/dma-iommu.h>
+#include <linux/hashtable.h>
 
 #include <soc/qcom/secure_buffer.h>
 
@@ -43,6 +44,8 @@
 #define GET_SMMU_TABLE_IDX(x) (((x) >> COOKIE_SIZE) & COOKIE_MASK)
 
 #define CAM_SMMU_MONITOR_MAX_ENTRIES   100
+#define CAM_SMMU_BUF_HASH_BITS         7
+#define CAM_SMMU_LOOKUP_STATS_BUF_SIZE 1024
 #define CAM_SMMU_INC_MONITOR_HEAD(head, ret) \
 	div_u64_rem(atomic64_add_return(1, head),\
 	CAM_SMMU_MONITOR_MAX_ENTRIES, (ret))
@@ -116,6 +119,22 @@ struct cam_smmu_monitor {
 	enum cam_smmu_region_id region_id;
 };
 
+/**
+ * struct cam_smmu_lookup_stats - Mapping lookup statistics of a context bank,
+ * updated with the context bank lock held
+ *
+ * @num_lookups : Number of fd/dma_buf lookups
+ * @total_depth : Accumulated number of entries compared
+ * @max_depth   : Worst number of entries compared in one lookup
+ * @total_ns    : Accumulated lookup time, only when map profiling is enabled
+ */
+struct cam_smmu_lookup_stats {
+	uint64_t num_lookups;
+	uint64_t total_depth;
+	uint32_t max_depth;
+	uint64_t total_ns;
+};
+
 struct cam_context_bank_info {
 	struct device *dev;
 	struct iommu_domain *domain;
@@ -148,6 +167,10 @@ struct cam_context_bank_info {
 
 	struct list_head smmu_buf_list;
 	struct list_head smmu_buf_kernel_list;
+	/* lookup index of non-secure mappings, lists are kept for dumps */
+	DECLARE_HASHTABLE(fd_hash, CAM_SMMU_BUF_HASH_BITS);
+	DECLARE_HASHTABLE(dma_buf_hash, CAM_SMMU_BUF_HASH_BITS);
+	struct cam_smmu_lookup_stats lookup_stats;
 	struct mutex lock;
 	int handle;
 	enum cam_smmu_ops_param state;
@@ -203,6 +226,7 @@ struct cam_dma_buff_info {
 	int ref_count;
 	dma_addr_t paddr;
 	struct list_head list;
+	struct hlist_node hnode;
 	int ion_fd;
 	size_t len;
 	size_t phys_len;
@@ -911,6 +935,10 @@ void cam_smmu_reset_iommu_table(enum cam_smmu_init_dir ops)
 		iommu_cb_set.cb_info[i].handle = HANDLE_INIT;
 		INIT_LIST_HEAD(&iommu_cb_set.cb_info[i].smmu_buf_list);
 		INIT_LIST_HEAD(&iommu_cb_set.cb_info[i].smmu_buf_kernel_list);
+		hash_init(iommu_cb_set.cb_info[i].fd_hash);
+		hash_init(iommu_cb_set.cb_info[i].dma_buf_hash);
+		memset(&iommu_cb_set.cb_info[i].lookup_stats, 0,
+			sizeof(iommu_cb_set.cb_info[i].lookup_stats));
 		iommu_cb_set.cb_info[i].state = CAM_SMMU_DETACH;
 		iommu_cb_set.cb_info[i].dev = NULL;
 		iommu_cb_set.cb_info[i].cb_count = 0;
@@ -1141,6 +1169,65 @@ static int cam_smmu_free_scratch_va(struct scratch_mapping *mapping,
 	return 0;
 }
 
+static void cam_smmu_update_lookup_stats(int idx, uint32_t depth,
+	ktime_t start)
+{
+	struct cam_smmu_lookup_stats *stats =
+		&iommu_cb_set.cb_info[idx].lookup_stats;
+
+	stats->num_lookups++;
+	stats->total_depth += depth;
+	if (depth > stats->max_depth)
+		stats->max_depth = depth;
+	if (iommu_cb_set.map_profile_enable)
+		stats->total_ns += ktime_to_ns(ktime_sub(ktime_get(), start));
+}
+
+static struct cam_dma_buff_info *cam_smmu_lookup_fd(int idx, int ion_fd)
+{
+	struct cam_dma_buff_info *mapping, *found = NULL;
+	uint32_t depth = 0;
+	ktime_t start = 0;
+
+	if (iommu_cb_set.map_profile_enable)
+		start = ktime_get();
+
+	hash_for_each_possible(iommu_cb_set.cb_info[idx].fd_hash, mapping,
+		hnode, ion_fd) {
+		depth++;
+		if (mapping->ion_fd == ion_fd) {
+			found = mapping;
+			break;
+		}
+	}
+
+	cam_smmu_update_lookup_stats(idx, depth, start);
+	return found;
+}
+
+static struct cam_dma_buff_info *cam_smmu_lookup_dma_buf(int idx,
+	struct dma_buf *buf)
+{
+	struct cam_dma_buff_info *mapping, *found = NULL;
+	uint32_t depth = 0;
+	ktime_t start = 0;
+
+	if (iommu_cb_set.map_profile_enable)
+		start = ktime_get();
+
+	hash_for_each_possible(iommu_cb_set.cb_info[idx].dma_buf_hash, mapping,
+		hnode, (unsigned long)buf) {
+		depth++;
+		if (mapping->buf == buf) {
+			found = mapping;
+			break;
+		}
+	}
+
+	cam_smmu_update_lookup_stats(idx, depth, start);
+	return found;
+}
+
 static struct cam_dma_buff_info *cam_smmu_find_mapping_by_virt_address(int idx,
 	dma_addr_t virt_addr)
 {
@@ -1170,13 +1257,10 @@ static struct cam_dma_buff_info *cam_smmu_find_mapping_by_ion_index(int idx,
 		return NULL;
 	}
 
-	list_for_each_entry(mapping,
-			&iommu_cb_set.cb_info[idx].smmu_buf_list,
-			list) {
-		if (mapping->ion_fd == ion_fd) {
-			CAM_DBG(CAM_SMMU, "find ion_fd %d", ion_fd);
-			return mapping;
-		}
+	mapping = cam_smmu_lookup_fd(idx, ion_fd);
+	if (mapping) {
+		CAM_DBG(CAM_SMMU, "find ion_fd %d", ion_fd);
+		return mapping;
 	}
 
 	CAM_ERR(CAM_SMMU, "Error: Cannot find entry by index %d", idx);
@@ -1194,13 +1278,10 @@ static struct cam_dma_buff_info *cam_smmu_find_mapping_by_dma_buf(int idx,
 		return NULL;
 	}
 
-	list_for_each_entry(mapping,
-			&iommu_cb_set.cb_info[idx].smmu_buf_kernel_list,
-			list) {
-		if (mapping->buf == buf) {
-			CAM_DBG(CAM_SMMU, "find dma_buf %pK", buf);
-			return mapping;
-		}
+	mapping = cam_smmu_lookup_dma_buf(idx, buf);
+	if (mapping) {
+		CAM_DBG(CAM_SMMU, "find dma_buf %pK", buf);
+		return mapping;
 	}
 
 	CAM_ERR(CAM_SMMU, "Error: Cannot find entry by index %d", idx);
@@ -2202,6 +2283,8 @@ static int cam_smmu_map_buffer_and_add_to_list(int idx, int ion_fd,
 	/* add to the list */
 	list_add(&mapping_info->list,
 		&iommu_cb_set.cb_info[idx].smmu_buf_list);
+	hash_add(iommu_cb_set.cb_info[idx].fd_hash, &mapping_info->hnode,
+		mapping_info->ion_fd);
 
 	cam_smmu_update_monitor_array(&iommu_cb_set.cb_info[idx], true,
 		mapping_info);
@@ -2230,6 +2313,8 @@ static int cam_smmu_map_kernel_buffer_and_add_to_list(int idx,
 	/* add to the list */
 	list_add(&mapping_info->list,
 		&iommu_cb_set.cb_info[idx].smmu_buf_kernel_list);
+	hash_add(iommu_cb_set.cb_info[idx].dma_buf_hash, &mapping_info->hnode,
+		(unsigned long)mapping_info->buf);
 
 	cam_smmu_update_monitor_array(&iommu_cb_set.cb_info[idx], true,
 		mapping_info);
@@ -2321,6 +2406,7 @@ static int cam_smmu_unmap_buf_and_remove_from_list(
 	mapping_info->buf = NULL;
 
 	list_del_init(&mapping_info->list);
+	hash_del(&mapping_info->hnode);
 
 	/* free one buffer */
 	kfree(mapping_info);
@@ -2333,14 +2419,12 @@ static enum cam_smmu_buf_state cam_smmu_check_fd_in_list(int idx,
 {
 	struct cam_dma_buff_info *mapping;
 
-	list_for_each_entry(mapping,
-		&iommu_cb_set.cb_info[idx].smmu_buf_list, list) {
-		if (mapping->ion_fd == ion_fd) {
-			*paddr_ptr = mapping->paddr;
-			*len_ptr = mapping->len;
-			*ts_mapping = &mapping->ts;
-			return CAM_SMMU_BUFF_EXIST;
-		}
+	mapping = cam_smmu_lookup_fd(idx, ion_fd);
+	if (mapping) {
+		*paddr_ptr = mapping->paddr;
+		*len_ptr = mapping->len;
+		*ts_mapping = &mapping->ts;
+		return CAM_SMMU_BUFF_EXIST;
 	}
 
 	return CAM_SMMU_BUFF_NOT_EXIST;
@@ -2352,15 +2436,13 @@ static enum cam_smmu_buf_state cam_smmu_user_reuse_fd_in_list(int idx,
 {
 	struct cam_dma_buff_info *mapping;
 
-	list_for_each_entry(mapping,
-		&iommu_cb_set.cb_info[idx].smmu_buf_list, list) {
-		if (mapping->ion_fd == ion_fd) {
-			*paddr_ptr = mapping->paddr;
-			*len_ptr = mapping->len;
-			*ts_mapping = &mapping->ts;
-			mapping->ref_count++;
-			return CAM_SMMU_BUFF_EXIST;
-		}
+	mapping = cam_smmu_lookup_fd(idx, ion_fd);
+	if (mapping) {
+		*paddr_ptr = mapping->paddr;
+		*len_ptr = mapping->len;
+		*ts_mapping = &mapping->ts;
+		mapping->ref_count++;
+		return CAM_SMMU_BUFF_EXIST;
 	}
 
 	return CAM_SMMU_BUFF_NOT_EXIST;
@@ -2371,13 +2453,11 @@ static enum cam_smmu_buf_state cam_smmu_check_dma_buf_in_list(int idx,
 {
 	struct cam_dma_buff_info *mapping;
 
-	list_for_each_entry(mapping,
-		&iommu_cb_set.cb_info[idx].smmu_buf_kernel_list, list) {
-		if (mapping->buf == buf) {
-			*paddr_ptr = mapping->paddr;
-			*len_ptr = mapping->len;
-			return CAM_SMMU_BUFF_EXIST;
-		}
+	mapping = cam_smmu_lookup_dma_buf(idx, buf);
+	if (mapping) {
+		*paddr_ptr = mapping->paddr;
+		*len_ptr = mapping->len;
+		return CAM_SMMU_BUFF_EXIST;
 	}
 
 	return CAM_SMMU_BUFF_NOT_EXIST;
@@ -2586,6 +2666,8 @@ static int cam_smmu_alloc_scratch_buffer_add_to_list(int idx,
 		mapping_info->len, mapping_info->phys_len);
 
 	list_add(&mapping_info->list, &iommu_cb_set.cb_info[idx].smmu_buf_list);
+	hash_add(iommu_cb_set.cb_info[idx].fd_hash, &mapping_info->hnode,
+		mapping_info->ion_fd);
 
 	*virt_addr = (dma_addr_t)iova;
 
@@ -2647,6 +2729,7 @@ static int cam_smmu_free_scratch_buffer_remove_from_list(
 	sg_free_table(mapping_info->table);
 	kfree(mapping_info->table);
 	list_del_init(&mapping_info->list);
+	hash_del(&mapping_info->hnode);
 
 	kfree(mapping_info);
 	mapping_info = NULL;
@@ -4168,10 +4251,72 @@ cb_init_fail:
 	return rc;
 }
 
+static int cam_smmu_lookup_stats_open(struct inode *inode, struct file *file)
+{
+	file->private_data = inode->i_private;
+	return 0;
+}
+
+static ssize_t cam_smmu_lookup_stats_read(struct file *t_file, char *t_char,
+	size_t t_size_t, loff_t *t_loff_t)
+{
+	struct cam_smmu_lookup_stats stats;
+	char *out_buffer;
+	ssize_t rc;
+	int i, len = 0;
+
+	out_buffer = kzalloc(CAM_SMMU_LOOKUP_STATS_BUF_SIZE, GFP_KERNEL);
+	if (!out_buffer)
+		return -ENOMEM;
+
+	for (i = 0; i < iommu_cb_set.cb_num; i++) {
+		mutex_lock(&iommu_cb_set.cb_info[i].lock);
+		stats = iommu_cb_set.cb_info[i].lookup_stats;
+		mutex_unlock(&iommu_cb_set.cb_info[i].lock);
+
+		if (!stats.num_lookups)
+			continue;
+
+		len += scnprintf(out_buffer + len,
+			CAM_SMMU_LOOKUP_STATS_BUF_SIZE - len,
+			"%s: lookups=%llu avg_depth=%llu max_depth=%u total_ns=%llu\n",
+			iommu_cb_set.cb_info[i].name[0], stats.num_lookups,
+			div64_u64(stats.total_depth, stats.num_lookups),
+			stats.max_depth, stats.total_ns);
+	}
+
+	rc = simple_read_from_buffer(t_char, t_size_t, t_loff_t,
+		out_buffer, len);
+	kfree(out_buffer);
+	return rc;
+}
+
+static ssize_t cam_smmu_lookup_stats_write(struct file *t_file,
+	const char *t_char, size_t t_size_t, loff_t *t_loff_t)
+{
+	int i;
+
+	for (i = 0; i < iommu_cb_set.cb_num; i++) {
+		mutex_lock(&iommu_cb_set.cb_info[i].lock);
+		memset(&iommu_cb_set.cb_info[i].lookup_stats, 0,
+			sizeof(iommu_cb_set.cb_info[i].lookup_stats));
+		mutex_unlock(&iommu_cb_set.cb_info[i].lock);
+	}
+
+	return t_size_t;
+}
+
+static const struct file_operations cam_smmu_lookup_stats_fops = {
+	.open = cam_smmu_lookup_stats_open,
+	.read = cam_smmu_lookup_stats_read,
+	.write = cam_smmu_lookup_stats_write,
+};
+
 static int cam_smmu_create_debug_fs(void)
 {
 	int rc = 0;
 	struct dentry *dbgfileptr = NULL;
+	struct dentry *stats_file = NULL;
 
 	dbgfileptr = debugfs_create_dir("camera_smmu", NULL);
 	if (!dbgfileptr) {
@@ -4191,7 +4336,13 @@ static int cam_smmu_create_debug_fs(void)
 			CAM_WARN(CAM_SMMU, "DebugFS not enabled in kernel!");
 		else
 			rc = PTR_ERR(dbgfileptr);
+		goto end;
 	}
+
+	stats_file = debugfs_create_file("lookup_stats", 0644,
+		iommu_cb_set.dentry, NULL, &cam_smmu_lookup_stats_fops);
+	if (IS_ERR_OR_NULL(stats_file))
+		CAM_WARN(CAM_SMMU, "Failed to create lookup_stats");
 end:
 	return rc;
 }
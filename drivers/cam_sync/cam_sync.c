@@ -9,6 +9,7 @@
 #include <linux/module.h>
 #include <linux/platform_device.h>
 #include <linux/debugfs.h>
+#include <linux/math64.h>
 #if IS_REACHABLE(CONFIG_MSM_GLOBAL_SYNX)
 #include <synx_api.h>
 #endif
@@ -50,20 +51,15 @@ int cam_sync_create(int32_t *sync_obj, const char *name)
 {
 	int rc;
 	long idx;
-	bool bit;
 
-	do {
-		idx = find_first_zero_bit(sync_dev->bitmap, CAM_SYNC_MAX_OBJS);
-		if (idx >= CAM_SYNC_MAX_OBJS) {
-			CAM_ERR(CAM_SYNC,
-				"Error: Unable to create sync idx = %d reached max!",
-				idx);
-			cam_sync_print_fence_table();
-			return -ENOMEM;
-		}
-		CAM_DBG(CAM_SYNC, "Index location available at idx: %ld", idx);
-		bit = test_and_set_bit(idx, sync_dev->bitmap);
-	} while (bit);
+	rc = cam_sync_util_find_and_set_empty_row(sync_dev, &idx);
+	if (rc) {
+		CAM_ERR(CAM_SYNC,
+			"Error: Unable to create sync obj, reached max!");
+		cam_sync_print_fence_table();
+		return -ENOMEM;
+	}
+	CAM_DBG(CAM_SYNC, "Index location available at idx: %ld", idx);
 
 	spin_lock_bh(&sync_dev->row_spinlocks[idx]);
 	rc = cam_sync_init_row(sync_dev->sync_table, idx, name,
@@ -83,8 +79,8 @@ int cam_sync_create(int32_t *sync_obj, const char *name)
 	return rc;
 }
 
-int cam_sync_register_callback(sync_callback cb_func,
-	void *userdata, int32_t sync_obj)
+static int cam_sync_register_callback_common(sync_callback cb_func,
+	void *userdata, int32_t sync_obj, bool inline_cb)
 {
 	struct sync_callback_info *sync_cb;
 	struct sync_table_row *row = NULL;
@@ -104,25 +100,26 @@ int cam_sync_register_callback(sync_callback cb_func,
 		return -EINVAL;
 	}
 
-	sync_cb = kzalloc(sizeof(*sync_cb), GFP_ATOMIC);
-	if (!sync_cb) {
-		spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
-		return -ENOMEM;
-	}
-
 	/* Trigger callback if sync object is already in SIGNALED state */
 	if (((row->state == CAM_SYNC_STATE_SIGNALED_SUCCESS) ||
 		(row->state == CAM_SYNC_STATE_SIGNALED_ERROR) ||
 		(row->state == CAM_SYNC_STATE_SIGNALED_CANCEL)) &&
 		(!row->remaining)) {
-		if (trigger_cb_without_switch) {
+		if (trigger_cb_without_switch || inline_cb) {
 			CAM_DBG(CAM_SYNC, "Invoke callback for sync object:%d",
 				sync_obj);
 			status = row->state;
-			kfree(sync_cb);
 			spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
 			cb_func(sync_obj, status, userdata);
 		} else {
+			sync_cb = kmem_cache_zalloc(sync_dev->cb_cache,
+				GFP_ATOMIC);
+			if (!sync_cb) {
+				spin_unlock_bh(
+					&sync_dev->row_spinlocks[sync_obj]);
+				return -ENOMEM;
+			}
+
 			sync_cb->callback_func = cb_func;
 			sync_cb->cb_data = userdata;
 			sync_cb->sync_obj = sync_obj;
@@ -140,9 +137,16 @@ int cam_sync_register_callback(sync_callback cb_func,
 		return 0;
 	}
 
+	sync_cb = kmem_cache_zalloc(sync_dev->cb_cache, GFP_ATOMIC);
+	if (!sync_cb) {
+		spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
+		return -ENOMEM;
+	}
+
 	sync_cb->callback_func = cb_func;
 	sync_cb->cb_data = userdata;
 	sync_cb->sync_obj = sync_obj;
+	sync_cb->inline_cb = inline_cb;
 	INIT_WORK(&sync_cb->cb_dispatch_work, cam_sync_util_cb_dispatch);
 	list_add_tail(&sync_cb->list, &row->callback_list);
 	spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
@@ -150,6 +154,20 @@ int cam_sync_register_callback(sync_callback cb_func,
 	return 0;
 }
 
+int cam_sync_register_callback(sync_callback cb_func,
+	void *userdata, int32_t sync_obj)
+{
+	return cam_sync_register_callback_common(cb_func, userdata,
+		sync_obj, false);
+}
+
+int cam_sync_register_callback_inline(sync_callback cb_func,
+	void *userdata, int32_t sync_obj)
+{
+	return cam_sync_register_callback_common(cb_func, userdata,
+		sync_obj, true);
+}
+
 int cam_sync_deregister_callback(sync_callback cb_func,
 	void *userdata, int32_t sync_obj)
 {
@@ -177,7 +195,7 @@ int cam_sync_deregister_callback(sync_callback cb_func,
 		if (sync_cb->callback_func == cb_func &&
 			sync_cb->cb_data == userdata) {
 			list_del_init(&sync_cb->list);
-			kfree(sync_cb);
+			kmem_cache_free(sync_dev->cb_cache, sync_cb);
 			found = true;
 		}
 	}
@@ -192,6 +210,8 @@ int cam_sync_signal(int32_t sync_obj, uint32_t status, uint32_t event_cause)
 	struct sync_table_row *parent_row = NULL;
 	struct sync_parent_info *parent_info, *temp_parent_info;
 	struct list_head parents_list;
+	struct list_head inline_list;
+	uint32_t state;
 	int rc = 0;
 
 	if (sync_obj >= CAM_SYNC_MAX_OBJS || sync_obj <= 0) {
@@ -199,10 +219,25 @@ int cam_sync_signal(int32_t sync_obj, uint32_t status, uint32_t event_cause)
 			sync_obj, CAM_SYNC_MAX_OBJS);
 		return -EINVAL;
 	}
+
+	if ((status != CAM_SYNC_STATE_SIGNALED_SUCCESS) &&
+		(status != CAM_SYNC_STATE_SIGNALED_ERROR) &&
+		(status != CAM_SYNC_STATE_SIGNALED_CANCEL)) {
+		CAM_ERR(CAM_SYNC,
+			"Error: signaling with undefined status = %d event reason = %u",
+			status, event_cause);
+		return -EINVAL;
+	}
+
+	/*
+	 * Stale and duplicate signals are rejected without the row lock. The
+	 * reference drop and the ACTIVE to SIGNALED transition are done under
+	 * it, so a concurrent destroy cannot release and reuse the row before
+	 * its callbacks and parents are dispatched.
+	 */
 	row = sync_dev->sync_table + sync_obj;
-	spin_lock_bh(&sync_dev->row_spinlocks[sync_obj]);
-	if (row->state == CAM_SYNC_STATE_INVALID) {
-		spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
+	state = READ_ONCE(row->state);
+	if (state == CAM_SYNC_STATE_INVALID) {
 		CAM_ERR(CAM_SYNC,
 			"Error: accessing an uninitialized sync obj = %d",
 			sync_obj);
@@ -210,29 +245,26 @@ int cam_sync_signal(int32_t sync_obj, uint32_t status, uint32_t event_cause)
 	}
 
 	if (row->type == CAM_SYNC_TYPE_GROUP) {
-		spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
 		CAM_ERR(CAM_SYNC,
 			"Error: Signaling a GROUP sync object = %d",
 			sync_obj);
 		return -EINVAL;
 	}
 
-	if (row->state != CAM_SYNC_STATE_ACTIVE) {
-		spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
+	if (state != CAM_SYNC_STATE_ACTIVE) {
 		CAM_ERR(CAM_SYNC,
 			"Error: Sync object already signaled sync_obj = %d",
 			sync_obj);
 		return -EALREADY;
 	}
 
-	if ((status != CAM_SYNC_STATE_SIGNALED_SUCCESS) &&
-		(status != CAM_SYNC_STATE_SIGNALED_ERROR) &&
-		(status != CAM_SYNC_STATE_SIGNALED_CANCEL)) {
+	spin_lock_bh(&sync_dev->row_spinlocks[sync_obj]);
+	if (row->state != CAM_SYNC_STATE_ACTIVE) {
 		spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
 		CAM_ERR(CAM_SYNC,
-			"Error: signaling with undefined status = %d event reason = %u",
-			status, event_cause);
-		return -EINVAL;
+			"Error: Sync object not active sync_obj = %d state = %u",
+			sync_obj, row->state);
+		return -EALREADY;
 	}
 
 	if (!atomic_dec_and_test(&row->ref_cnt)) {
@@ -240,14 +272,18 @@ int cam_sync_signal(int32_t sync_obj, uint32_t status, uint32_t event_cause)
 		return 0;
 	}
 
-	row->state = status;
-	cam_sync_util_dispatch_signaled_cb(sync_obj, status, event_cause);
+	WRITE_ONCE(row->state, status);
+	INIT_LIST_HEAD(&inline_list);
+	cam_sync_util_dispatch_signaled_cb(sync_obj, status, event_cause,
+		&inline_list);
 
 	/* copy parent list to local and release child lock */
 	INIT_LIST_HEAD(&parents_list);
 	list_splice_init(&row->parents_list, &parents_list);
 	spin_unlock_bh(&sync_dev->row_spinlocks[sync_obj]);
 
+	cam_sync_util_dispatch_inline_cb(&inline_list);
+
 	if (list_empty(&parents_list))
 		return 0;
 
@@ -278,9 +314,10 @@ int cam_sync_signal(int32_t sync_obj, uint32_t status, uint32_t event_cause)
 		if (!parent_row->remaining)
 			cam_sync_util_dispatch_signaled_cb(
 				parent_info->sync_id, parent_row->state,
-				event_cause);
+				event_cause, &inline_list);
 
 		spin_unlock_bh(&sync_dev->row_spinlocks[parent_info->sync_id]);
+		cam_sync_util_dispatch_inline_cb(&inline_list);
 		list_del_init(&parent_info->list);
 		kfree(parent_info);
 	}
@@ -292,7 +329,6 @@ int cam_sync_merge(int32_t *sync_obj, uint32_t num_objs, int32_t *merged_obj)
 {
 	int rc;
 	long idx = 0;
-	bool bit;
 	int i = 0;
 
 	if (!sync_obj || !merged_obj) {
@@ -319,12 +355,10 @@ int cam_sync_merge(int32_t *sync_obj, uint32_t num_objs, int32_t *merged_obj)
 			return rc;
 		}
 	}
-	do {
-		idx = find_first_zero_bit(sync_dev->bitmap, CAM_SYNC_MAX_OBJS);
-		if (idx >= CAM_SYNC_MAX_OBJS)
-			return -ENOMEM;
-		bit = test_and_set_bit(idx, sync_dev->bitmap);
-	} while (bit);
+
+	rc = cam_sync_util_find_and_set_empty_row(sync_dev, &idx);
+	if (rc)
+		return -ENOMEM;
 
 	spin_lock_bh(&sync_dev->row_spinlocks[idx]);
 	rc = cam_sync_init_group_object(sync_dev->sync_table,
@@ -405,7 +439,7 @@ int cam_sync_check_valid(int32_t sync_obj)
 		return -EINVAL;
 	}
 
-	if (row->state == CAM_SYNC_STATE_INVALID) {
+	if (READ_ONCE(row->state) == CAM_SYNC_STATE_INVALID) {
 		CAM_ERR(CAM_SYNC,
 			"Error: accessing an uninitialized sync obj = %d",
 			sync_obj);
@@ -425,7 +459,7 @@ int cam_sync_wait(int32_t sync_obj, uint64_t timeout_ms)
 
 	row = sync_dev->sync_table + sync_obj;
 
-	if (row->state == CAM_SYNC_STATE_INVALID) {
+	if (READ_ONCE(row->state) == CAM_SYNC_STATE_INVALID) {
 		CAM_ERR(CAM_SYNC,
 			"Error: accessing an uninitialized sync obj = %d",
 			sync_obj);
@@ -440,7 +474,7 @@ int cam_sync_wait(int32_t sync_obj, uint64_t timeout_ms)
 			"Error: timed out for sync obj = %d", sync_obj);
 		rc = -ETIMEDOUT;
 	} else {
-		switch (row->state) {
+		switch (READ_ONCE(row->state)) {
 		case CAM_SYNC_STATE_INVALID:
 		case CAM_SYNC_STATE_ACTIVE:
 		case CAM_SYNC_STATE_SIGNALED_ERROR:
@@ -598,6 +632,259 @@ static int cam_sync_handle_wait(struct cam_private_ioctl_arg *k_ioctl)
 	return 0;
 }
 
+static int cam_sync_handle_signal_batch(struct cam_private_ioctl_arg *k_ioctl)
+{
+	struct cam_sync_signal_batch sync_batch;
+	struct cam_sync_signal *signals;
+	int i, rc = 0;
+
+	if (k_ioctl->size != sizeof(struct cam_sync_signal_batch))
+		return -EINVAL;
+
+	if (!k_ioctl->ioctl_ptr)
+		return -EINVAL;
+
+	if (copy_from_user(&sync_batch,
+		u64_to_user_ptr(k_ioctl->ioctl_ptr),
+		k_ioctl->size))
+		return -EFAULT;
+
+	if (!sync_batch.num_signals ||
+		sync_batch.num_signals > CAM_SYNC_MAX_BATCH_OBJS)
+		return -EINVAL;
+
+	signals = kcalloc(sync_batch.num_signals, sizeof(*signals),
+		GFP_KERNEL);
+	if (!signals)
+		return -ENOMEM;
+
+	if (copy_from_user(signals, u64_to_user_ptr(sync_batch.signals),
+		sizeof(*signals) * sync_batch.num_signals)) {
+		kfree(signals);
+		return -EFAULT;
+	}
+
+	sync_batch.failed_idx = -1;
+	for (i = 0; i < sync_batch.num_signals; i++) {
+		/* need to get ref for UMD signaled fences */
+		rc = cam_sync_get_obj_ref(signals[i].sync_obj);
+		if (!rc)
+			rc = cam_sync_signal(signals[i].sync_obj,
+				signals[i].sync_state,
+				CAM_SYNC_COMMON_SYNC_SIGNAL_EVENT);
+		if (rc) {
+			CAM_DBG(CAM_SYNC,
+				"Batch signal failed at idx %d sync obj %d rc %d",
+				i, signals[i].sync_obj, rc);
+			sync_batch.failed_idx = i;
+			break;
+		}
+	}
+
+	kfree(signals);
+
+	if (copy_to_user(u64_to_user_ptr(k_ioctl->ioctl_ptr),
+		&sync_batch, k_ioctl->size))
+		return -EFAULT;
+
+	return rc;
+}
+
+static void cam_sync_wait_any_ctx_release(struct kref *ref)
+{
+	struct cam_sync_wait_any_ctx *ctx = container_of(ref,
+		struct cam_sync_wait_any_ctx, ref);
+
+	kfree(ctx);
+}
+
+static void cam_sync_wait_any_cb(int32_t sync_obj, int status, void *data)
+{
+	struct cam_sync_wait_any_ctx *ctx = data;
+
+	if (atomic_cmpxchg(&ctx->fired_obj, -1, sync_obj) == -1) {
+		ctx->status = status;
+		complete(&ctx->done);
+	}
+
+	kref_put(&ctx->ref, cam_sync_wait_any_ctx_release);
+}
+
+static int cam_sync_wait_any(int32_t *sync_objs, uint32_t num_objs,
+	uint64_t timeout_ms, int32_t *fired_obj)
+{
+	struct cam_sync_wait_any_ctx *ctx;
+	bool completed = false;
+	int i, j, status, rc = 0;
+
+	ctx = kzalloc(sizeof(*ctx), GFP_KERNEL);
+	if (!ctx)
+		return -ENOMEM;
+
+	atomic_set(&ctx->fired_obj, -1);
+	init_completion(&ctx->done);
+	kref_init(&ctx->ref);
+
+	/* Each registered callback holds a reference until it runs */
+	for (i = 0; i < num_objs; i++) {
+		kref_get(&ctx->ref);
+		rc = cam_sync_register_callback_inline(cam_sync_wait_any_cb,
+			ctx, sync_objs[i]);
+		if (rc) {
+			kref_put(&ctx->ref, cam_sync_wait_any_ctx_release);
+			break;
+		}
+	}
+
+	if (!rc) {
+		completed = wait_for_completion_timeout(&ctx->done,
+			msecs_to_jiffies(timeout_ms));
+		if (!completed)
+			CAM_DBG(CAM_SYNC, "Wait any timed out on %u objs",
+				num_objs);
+	}
+
+	/*
+	 * A callback which could not be deregistered has been dispatched
+	 * and drops its own reference.
+	 */
+	for (j = 0; j < i; j++)
+		if (!cam_sync_deregister_callback(cam_sync_wait_any_cb,
+			ctx, sync_objs[j]))
+			kref_put(&ctx->ref, cam_sync_wait_any_ctx_release);
+
+	/*
+	 * The status is taken from the callback, the row of the fired object
+	 * may already be destroyed and reused. A callback which won after
+	 * the timeout completes right after setting it.
+	 */
+	*fired_obj = atomic_read(&ctx->fired_obj);
+	if (*fired_obj >= 0 && !completed)
+		wait_for_completion(&ctx->done);
+	status = ctx->status;
+	kref_put(&ctx->ref, cam_sync_wait_any_ctx_release);
+
+	if (rc)
+		return rc;
+
+	if (*fired_obj < 0) {
+		CAM_ERR(CAM_SYNC, "Error: timed out for %u sync objs",
+			num_objs);
+		return -ETIMEDOUT;
+	}
+
+	if (status != CAM_SYNC_STATE_SIGNALED_SUCCESS)
+		return -EINVAL;
+
+	return 0;
+}
+
+static int cam_sync_wait_all(int32_t *sync_objs, uint32_t num_objs,
+	uint64_t timeout_ms, int32_t *fired_obj)
+{
+	struct sync_table_row *row;
+	unsigned long deadline, remaining;
+	int i, rc = 0;
+
+	/*
+	 * Same as a merged object, the wait completes once every object is
+	 * signaled and fails if any of them was signaled with error/cancel.
+	 */
+	deadline = jiffies + msecs_to_jiffies(timeout_ms);
+	for (i = 0; i < num_objs; i++) {
+		row = sync_dev->sync_table + sync_objs[i];
+		remaining = time_after(deadline, jiffies) ?
+			(deadline - jiffies) : 0;
+		if (!wait_for_completion_timeout(&row->signaled, remaining)) {
+			CAM_ERR(CAM_SYNC,
+				"Error: timed out for sync obj = %d",
+				sync_objs[i]);
+			*fired_obj = sync_objs[i];
+			return -ETIMEDOUT;
+		}
+
+		if (!rc && (READ_ONCE(row->state) !=
+			CAM_SYNC_STATE_SIGNALED_SUCCESS)) {
+			CAM_ERR(CAM_SYNC,
+				"Error: Wait on invalid state = %d, obj = %d",
+				row->state, sync_objs[i]);
+			*fired_obj = sync_objs[i];
+			rc = -EINVAL;
+		}
+	}
+
+	if (!rc)
+		*fired_obj = sync_objs[num_objs - 1];
+
+	return rc;
+}
+
+static int cam_sync_handle_wait_multi(struct cam_private_ioctl_arg *k_ioctl)
+{
+	struct cam_sync_wait_multi sync_wait;
+	int32_t *sync_objs;
+	int i, rc;
+
+	if (k_ioctl->size != sizeof(struct cam_sync_wait_multi))
+		return -EINVAL;
+
+	if (!k_ioctl->ioctl_ptr)
+		return -EINVAL;
+
+	if (copy_from_user(&sync_wait,
+		u64_to_user_ptr(k_ioctl->ioctl_ptr),
+		k_ioctl->size))
+		return -EFAULT;
+
+	if (!sync_wait.num_objs ||
+		sync_wait.num_objs > CAM_SYNC_MAX_BATCH_OBJS)
+		return -EINVAL;
+
+	sync_objs = kcalloc(sync_wait.num_objs, sizeof(*sync_objs),
+		GFP_KERNEL);
+	if (!sync_objs)
+		return -ENOMEM;
+
+	if (copy_from_user(sync_objs, u64_to_user_ptr(sync_wait.sync_objs),
+		sizeof(*sync_objs) * sync_wait.num_objs)) {
+		rc = -EFAULT;
+		goto end;
+	}
+
+	if (cam_common_util_remove_duplicate_arr(sync_objs,
+		sync_wait.num_objs) != sync_wait.num_objs) {
+		CAM_ERR(CAM_SYNC, "The obj list has duplicate fence");
+		rc = -EINVAL;
+		goto end;
+	}
+
+	for (i = 0; i < sync_wait.num_objs; i++) {
+		rc = cam_sync_check_valid(sync_objs[i]);
+		if (rc) {
+			CAM_ERR(CAM_SYNC, "Sync_obj[%d] %d valid check fail",
+				i, sync_objs[i]);
+			goto end;
+		}
+	}
+
+	if (k_ioctl->id == CAM_SYNC_WAIT_ANY)
+		k_ioctl->result = cam_sync_wait_any(sync_objs,
+			sync_wait.num_objs, sync_wait.timeout_ms,
+			&sync_wait.fired_obj);
+	else
+		k_ioctl->result = cam_sync_wait_all(sync_objs,
+			sync_wait.num_objs, sync_wait.timeout_ms,
+			&sync_wait.fired_obj);
+
+	if (copy_to_user(u64_to_user_ptr(k_ioctl->ioctl_ptr),
+		&sync_wait, k_ioctl->size))
+		rc = -EFAULT;
+
+end:
+	kfree(sync_objs);
+	return rc;
+}
+
 static int cam_sync_handle_destroy(struct cam_private_ioctl_arg *k_ioctl)
 {
 	struct cam_sync_info sync_create;
@@ -796,6 +1083,15 @@ static long cam_sync_dev_ioctl(struct file *filep, void *fh,
 		((struct cam_private_ioctl_arg *)arg)->result =
 			k_ioctl.result;
 		break;
+	case CAM_SYNC_SIGNAL_BATCH:
+		rc = cam_sync_handle_signal_batch(&k_ioctl);
+		break;
+	case CAM_SYNC_WAIT_ANY:
+	case CAM_SYNC_WAIT_ALL:
+		rc = cam_sync_handle_wait_multi(&k_ioctl);
+		((struct cam_private_ioctl_arg *)arg)->result =
+			k_ioctl.result;
+		break;
 	default:
 		rc = -ENOIOCTLCMD;
 	}
@@ -1050,10 +1346,62 @@ static void cam_sync_init_entity(struct sync_device *sync_dev)
 }
 #endif
 
+static int cam_sync_cb_stats_open(struct inode *inode, struct file *file)
+{
+	file->private_data = inode->i_private;
+	return 0;
+}
+
+static ssize_t cam_sync_cb_stats_read(struct file *t_file, char *t_char,
+	size_t t_size_t, loff_t *t_loff_t)
+{
+	static const char * const dispatch_name[CAM_SYNC_CB_DISPATCH_MAX] = {
+		"workq", "inline"};
+	char out_buffer[CAM_SYNC_CB_STATS_BUF_SIZE];
+	struct sync_cb_dispatch_stats *stats;
+	int64_t count, total_ns;
+	int i, len = 0;
+
+	for (i = 0; i < CAM_SYNC_CB_DISPATCH_MAX; i++) {
+		stats = &sync_dev->cb_stats[i];
+		count = atomic64_read(&stats->count);
+		total_ns = atomic64_read(&stats->total_ns);
+		len += scnprintf(out_buffer + len, sizeof(out_buffer) - len,
+			"%s: count=%lld avg_ns=%lld max_ns=%lld\n",
+			dispatch_name[i], count,
+			count ? div64_s64(total_ns, count) : 0,
+			atomic64_read(&stats->max_ns));
+	}
+
+	return simple_read_from_buffer(t_char, t_size_t,
+		t_loff_t, out_buffer, len);
+}
+
+static ssize_t cam_sync_cb_stats_write(struct file *t_file,
+	const char *t_char, size_t t_size_t, loff_t *t_loff_t)
+{
+	int i;
+
+	for (i = 0; i < CAM_SYNC_CB_DISPATCH_MAX; i++) {
+		atomic64_set(&sync_dev->cb_stats[i].count, 0);
+		atomic64_set(&sync_dev->cb_stats[i].total_ns, 0);
+		atomic64_set(&sync_dev->cb_stats[i].max_ns, 0);
+	}
+
+	return t_size_t;
+}
+
+static const struct file_operations cam_sync_cb_stats_fops = {
+	.open = cam_sync_cb_stats_open,
+	.read = cam_sync_cb_stats_read,
+	.write = cam_sync_cb_stats_write,
+};
+
 static int cam_sync_create_debugfs(void)
 {
 	int rc = 0;
 	struct dentry *dbgfileptr = NULL;
+	struct dentry *stats_file = NULL;
 
 	dbgfileptr = debugfs_create_dir("camera_sync", NULL);
 	if (!dbgfileptr) {
@@ -1071,7 +1419,13 @@ static int cam_sync_create_debugfs(void)
 			CAM_WARN(CAM_SYNC, "DebugFS not enabled in kernel!");
 		else
 			rc = PTR_ERR(dbgfileptr);
+		goto end;
 	}
+
+	stats_file = debugfs_create_file("cb_dispatch_stats", 0644,
+		sync_dev->dentry, NULL, &cam_sync_cb_stats_fops);
+	if (IS_ERR_OR_NULL(stats_file))
+		CAM_WARN(CAM_SYNC, "Failed to create cb_dispatch_stats");
 end:
 	return rc;
 }
@@ -1147,6 +1501,23 @@ static void cam_sync_configure_synx_obj(struct synx_register_params *object)
 }
 #endif
 
+/*
+ * Callback nodes of objects nobody destroyed are still allocated from the
+ * callback cache, free them once no callback work is left to run.
+ */
+static void cam_sync_destroy_cb_cache(void)
+{
+	int i;
+
+	for (i = 1; i < CAM_SYNC_MAX_OBJS; i++)
+		if (test_bit(i, sync_dev->bitmap) &&
+			sync_dev->sync_table[i].state != CAM_SYNC_STATE_INVALID)
+			cam_sync_deinit_object(sync_dev->sync_table, i);
+
+	kmem_cache_destroy(sync_dev->cb_cache);
+	sync_dev->cb_cache = NULL;
+}
+
 static int cam_sync_component_bind(struct device *dev,
 	struct device *master_dev, void *data)
 {
@@ -1219,6 +1590,13 @@ static int cam_sync_component_bind(struct device *dev,
 		goto v4l2_fail;
 	}
 
+	sync_dev->cb_cache = KMEM_CACHE(sync_callback_info, SLAB_HWCACHE_ALIGN);
+	if (!sync_dev->cb_cache) {
+		CAM_ERR(CAM_SYNC, "Error: callback cache creation failed");
+		rc = -ENOMEM;
+		goto wq_fail;
+	}
+
 	trigger_cb_without_switch = false;
 	cam_sync_create_debugfs();
 #if IS_REACHABLE(CONFIG_MSM_GLOBAL_SYNX)
@@ -1226,11 +1604,20 @@ static int cam_sync_component_bind(struct device *dev,
 	cam_sync_configure_synx_obj(&sync_dev->params);
 	rc = cam_sync_register_synx_bind_ops(&sync_dev->params);
 	if (rc)
-		goto v4l2_fail;
+		goto synx_fail;
 #endif
 	CAM_DBG(CAM_SYNC, "Component bound successfully");
 	return rc;
 
+#if IS_REACHABLE(CONFIG_MSM_GLOBAL_SYNX)
+synx_fail:
+	debugfs_remove_recursive(sync_dev->dentry);
+	sync_dev->dentry = NULL;
+	flush_workqueue(sync_dev->work_queue);
+	cam_sync_destroy_cb_cache();
+#endif
+wq_fail:
+	destroy_workqueue(sync_dev->work_queue);
 v4l2_fail:
 	v4l2_device_unregister(sync_dev->vdev->v4l2_dev);
 register_fail:
@@ -1258,6 +1645,8 @@ static void cam_sync_component_unbind(struct device *dev,
 	video_device_release(sync_dev->vdev);
 	debugfs_remove_recursive(sync_dev->dentry);
 	sync_dev->dentry = NULL;
+	destroy_workqueue(sync_dev->work_queue);
+	cam_sync_destroy_cb_cache();
 
 	for (i = 0; i < CAM_SYNC_MAX_OBJS; i++)
 		spin_lock_init(&sync_dev->row_spinlocks[i]);
@@ -50,6 +50,25 @@ int cam_sync_create(int32_t *sync_obj, const char *name);
 int cam_sync_register_callback(sync_callback cb_func,
 	void *userdata, int32_t sync_obj);
 
+/**
+ * @brief: Registers an inline callback with a sync object
+ *
+ * Same as cam_sync_register_callback, except that the callback is invoked
+ * directly from the signaling context instead of the sync workqueue. The
+ * signaling context may be softirq, so the callback must not sleep.
+ *
+ * @param cb_func:  Pointer to callback to be registered
+ * @param userdata: Opaque pointer which will be passed back with callback.
+ * @param sync_obj: int referencing the sync object.
+ *
+ * @return Status of operation. Zero in case of success.
+ * -EINVAL will be returned if userdata is invalid.
+ * -ENOMEM will be returned if cb_func is invalid.
+ *
+ */
+int cam_sync_register_callback_inline(sync_callback cb_func,
+	void *userdata, int32_t sync_obj);
+
 /**
  * @brief: De-registers a callback with a sync object
  *
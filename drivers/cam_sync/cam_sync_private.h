@@ -11,6 +11,8 @@
 #include <linux/workqueue.h>
 #include <linux/interrupt.h>
 #include <linux/debugfs.h>
+#include <linux/slab.h>
+#include <linux/kref.h>
 #include <media/v4l2-fh.h>
 #include <media/v4l2-device.h>
 #include <media/v4l2-subdev.h>
@@ -34,6 +36,7 @@
 #define CAM_SYNC_DEBUG_FILENAME         "cam_debug"
 #define CAM_SYNC_DEBUG_BASEDIR          "cam"
 #define CAM_SYNC_DEBUG_BUF_SIZE         32
+#define CAM_SYNC_CB_STATS_BUF_SIZE      256
 #define CAM_SYNC_PAYLOAD_WORDS          2
 #define CAM_SYNC_NAME                   "cam_sync"
 #define CAM_SYNC_WORKQUEUE_NAME         "HIPRIO_SYNC_WORK_QUEUE"
@@ -41,6 +44,10 @@
 #define CAM_SYNC_TYPE_INDV              0
 #define CAM_SYNC_TYPE_GROUP             1
 
+#define CAM_SYNC_CB_DISPATCH_WORKQ      0
+#define CAM_SYNC_CB_DISPATCH_INLINE     1
+#define CAM_SYNC_CB_DISPATCH_MAX        2
+
 /**
  * enum sync_type - Enum to indicate the type of sync object,
  * i.e. individual or group.
@@ -98,6 +105,8 @@ struct sync_child_info {
  * @cb_data            : Callback data, registered by client driver
  * @status             : Status with which callback will be invoked in client
  * @sync_obj           : Sync id of the object for which callback is registered
+ * @inline_cb          : Invoke callback from the signaling context instead of
+ *                      the sync workqueue
  * @workq_scheduled_ts : workqueue scheduled timestamp
  * @cb_dispatch_work   : Work representing the call dispatch
  * @list               : List member used to append this node to a linked list
@@ -107,11 +116,26 @@ struct sync_callback_info {
 	void *cb_data;
 	int status;
 	int32_t sync_obj;
+	bool inline_cb;
 	ktime_t workq_scheduled_ts;
 	struct work_struct cb_dispatch_work;
 	struct list_head list;
 };
 
+/**
+ * struct sync_cb_dispatch_stats - Latency counters from signal to invocation
+ * of kernel callbacks, one instance per dispatch type
+ *
+ * @count    : Number of callbacks dispatched
+ * @total_ns : Accumulated dispatch latency in ns
+ * @max_ns   : Worst dispatch latency in ns
+ */
+struct sync_cb_dispatch_stats {
+	atomic64_t count;
+	atomic64_t total_ns;
+	atomic64_t max_ns;
+};
+
 /**
  * struct sync_user_payload - Single node of information about a user space
  * payload registered from user space
@@ -134,7 +158,8 @@ struct sync_user_payload {
  * @parents_list      : Linked list of parents of this sync object
  * @children_list     : Linked list of children of this sync object
  * @state             : State (INVALID, ACTIVE, SIGNALED_SUCCESS or
- *                      SIGNALED_ERROR)
+ *                      SIGNALED_ERROR). Written under the row lock,
+ *                      readers outside the row lock must use READ_ONCE
  * @remaining         : Count of remaining children that not been signaled
  * @signaled          : Completion variable on which block calls will wait
  * @callback_list     : Linked list of kernel callbacks registered
@@ -171,6 +196,22 @@ struct cam_signalable_info {
 	struct list_head list;
 };
 
+/**
+ * struct cam_sync_wait_any_ctx - Context shared between a WAIT_ANY waiter and
+ * the inline callbacks it registers on each sync object
+ *
+ * @fired_obj : First sync object which was signaled, -1 until then
+ * @status    : Status of the first signaled object
+ * @done      : Completion on which the waiter blocks
+ * @ref       : One reference for the waiter plus one per registered callback
+ */
+struct cam_sync_wait_any_ctx {
+	atomic_t fired_obj;
+	int status;
+	struct completion done;
+	struct kref ref;
+};
+
 /**
  * struct sync_device - Internal struct to book keep sync driver details
  *
@@ -182,6 +223,8 @@ struct cam_signalable_info {
  * @open_cnt        : Count of file open calls made on the sync driver
  * @dentry          : Debugfs entry
  * @work_queue      : Work queue used for dispatching kernel callbacks
+ * @cb_cache        : Slab cache for kernel callback nodes
+ * @cb_stats        : Callback dispatch latency, per dispatch type
  * @cam_sync_eventq : Event queue used to dispatch user payloads to user space
  * @bitmap          : Bitmap representation of all sync objects
  * @params          : Parameters for synx call back registration
@@ -196,6 +239,8 @@ struct sync_device {
 	int open_cnt;
 	struct dentry *dentry;
 	struct workqueue_struct *work_queue;
+	struct kmem_cache *cb_cache;
+	struct sync_cb_dispatch_stats cb_stats[CAM_SYNC_CB_DISPATCH_MAX];
 	struct v4l2_fh *cam_sync_eventq;
 	spinlock_t cam_sync_eventq_lock;
 	DECLARE_BITMAP(bitmap, CAM_SYNC_MAX_OBJS);
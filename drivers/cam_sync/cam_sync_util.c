@@ -3,27 +3,53 @@
  * Copyright (c) 2017-2018, 2020-2021 The Linux Foundation. All rights reserved.
  */
 
+#include <linux/percpu.h>
+
 #include "cam_sync_util.h"
 #include "cam_req_mgr_workq.h"
 #include "cam_common_util.h"
 
+/*
+ * Per-CPU start position for the free row search. Each CPU begins scanning
+ * at its own cursor so that concurrent creators do not all contend on the
+ * first words of the bitmap.
+ */
+static DEFINE_PER_CPU(unsigned long, cam_sync_alloc_hint);
+
 int cam_sync_util_find_and_set_empty_row(struct sync_device *sync_dev,
 	long *idx)
 {
-	int rc = 0;
-
-	mutex_lock(&sync_dev->table_lock);
+	unsigned long hint, bit;
+	bool wrapped = false;
+
+	hint = this_cpu_read(cam_sync_alloc_hint);
+	if (!hint)
+		hint = 1 + raw_smp_processor_id() *
+			(CAM_SYNC_MAX_OBJS / num_possible_cpus());
+	if (hint >= CAM_SYNC_MAX_OBJS)
+		hint = 1;
+
+	for (;;) {
+		bit = find_next_zero_bit(sync_dev->bitmap,
+			CAM_SYNC_MAX_OBJS, hint);
+		if (bit >= CAM_SYNC_MAX_OBJS) {
+			if (wrapped)
+				return -ENOMEM;
+			wrapped = true;
+			hint = 1;
+			continue;
+		}
 
-	*idx = find_first_zero_bit(sync_dev->bitmap, CAM_SYNC_MAX_OBJS);
+		if (!test_and_set_bit(bit, sync_dev->bitmap))
+			break;
 
-	if (*idx < CAM_SYNC_MAX_OBJS)
-		set_bit(*idx, sync_dev->bitmap);
-	else
-		rc = -1;
+		hint = bit + 1;
+	}
 
-	mutex_unlock(&sync_dev->table_lock);
+	this_cpu_write(cam_sync_alloc_hint, bit + 1);
+	*idx = bit;
 
-	return rc;
+	return 0;
 }
 
 int cam_sync_init_row(struct sync_table_row *table,
@@ -273,7 +299,7 @@ int cam_sync_deinit_object(struct sync_table_row *table, uint32_t idx)
 	list_for_each_entry_safe(sync_cb, temp_cb,
 			&row->callback_list, list) {
 		list_del_init(&sync_cb->list);
-		kfree(sync_cb);
+		kmem_cache_free(sync_dev->cb_cache, sync_cb);
 	}
 
 	memset(row, 0, sizeof(*row));
@@ -288,6 +314,25 @@ int cam_sync_deinit_object(struct sync_table_row *table, uint32_t idx)
 	return 0;
 }
 
+void cam_sync_util_update_cb_stats(uint32_t type, ktime_t signaled_ts)
+{
+	struct sync_cb_dispatch_stats *stats = &sync_dev->cb_stats[type];
+	s64 latency_ns, max_ns;
+
+	latency_ns = ktime_to_ns(ktime_sub(ktime_get(), signaled_ts));
+	atomic64_inc(&stats->count);
+	atomic64_add(latency_ns, &stats->total_ns);
+
+	max_ns = atomic64_read(&stats->max_ns);
+	while (latency_ns > max_ns) {
+		s64 old = atomic64_cmpxchg(&stats->max_ns, max_ns, latency_ns);
+
+		if (old == max_ns)
+			break;
+		max_ns = old;
+	}
+}
+
 void cam_sync_util_cb_dispatch(struct work_struct *cb_dispatch_work)
 {
 	struct sync_callback_info *cb_info = container_of(cb_dispatch_work,
@@ -299,13 +344,29 @@ void cam_sync_util_cb_dispatch(struct work_struct *cb_dispatch_work)
 		"CAM-SYNC workq schedule",
 		cb_info->workq_scheduled_ts,
 		CAM_WORKQ_SCHEDULE_TIME_THRESHOLD);
+	cam_sync_util_update_cb_stats(CAM_SYNC_CB_DISPATCH_WORKQ,
+		cb_info->workq_scheduled_ts);
 	sync_data(cb_info->sync_obj, cb_info->status, cb_info->cb_data);
 
-	kfree(cb_info);
+	kmem_cache_free(sync_dev->cb_cache, cb_info);
+}
+
+void cam_sync_util_dispatch_inline_cb(struct list_head *inline_list)
+{
+	struct sync_callback_info *sync_cb, *temp_sync_cb;
+
+	list_for_each_entry_safe(sync_cb, temp_sync_cb, inline_list, list) {
+		list_del_init(&sync_cb->list);
+		cam_sync_util_update_cb_stats(CAM_SYNC_CB_DISPATCH_INLINE,
+			sync_cb->workq_scheduled_ts);
+		sync_cb->callback_func(sync_cb->sync_obj, sync_cb->status,
+			sync_cb->cb_data);
+		kmem_cache_free(sync_dev->cb_cache, sync_cb);
+	}
 }
 
 void cam_sync_util_dispatch_signaled_cb(int32_t sync_obj,
-	uint32_t status, uint32_t event_cause)
+	uint32_t status, uint32_t event_cause, struct list_head *inline_list)
 {
 	struct sync_callback_info  *sync_cb;
 	struct sync_user_payload   *payload_info;
@@ -324,7 +385,12 @@ void cam_sync_util_dispatch_signaled_cb(int32_t sync_obj,
 	list_for_each_entry_safe(sync_cb,
 		temp_sync_cb, &signalable_row->callback_list, list) {
 		sync_cb->status = status;
+		sync_cb->workq_scheduled_ts = ktime_get();
 		list_del_init(&sync_cb->list);
+		if (sync_cb->inline_cb) {
+			list_add_tail(&sync_cb->list, inline_list);
+			continue;
+		}
 		queue_work(sync_dev->work_queue,
 			&sync_cb->cb_dispatch_work);
 	}
@@ -14,13 +14,13 @@ extern struct sync_device *sync_dev;
 
 /**
  * @brief: Finds an empty row in the sync table and sets its corresponding bit
- * in the bit array
+ * in the bit array. The search is lockless and starts from a per-CPU cursor.
  *
  * @param sync_dev : Pointer to the sync device instance
  * @param idx      : Pointer to an long containing the index found in the bit
  *                   array
  *
- * @return Status of operation. Negative in case of error. Zero otherwise.
+ * @return Status of operation. -ENOMEM if the table is full. Zero otherwise.
  */
 int cam_sync_util_find_and_set_empty_row(struct sync_device *sync_dev,
 	long *idx);
@@ -84,11 +84,34 @@ void cam_sync_util_cb_dispatch(struct work_struct *cb_dispatch_work);
  * @sync_obj    : Sync object that is signaled
  * @status      : Status of the signaled object
  * @evt_param   : Event paramaeter
+ * @inline_list : List to which inline callbacks are moved, caller must
+ *                invoke them with cam_sync_util_dispatch_inline_cb once the
+ *                row lock is released
  *
  * @return None
  */
 void cam_sync_util_dispatch_signaled_cb(int32_t sync_obj,
-	uint32_t status, uint32_t evt_param);
+	uint32_t status, uint32_t evt_param, struct list_head *inline_list);
+
+/**
+ * @brief: Function to invoke and free inline callbacks collected by
+ *         cam_sync_util_dispatch_signaled_cb
+ *
+ * @inline_list : List of inline callbacks
+ *
+ * @return None
+ */
+void cam_sync_util_dispatch_inline_cb(struct list_head *inline_list);
+
+/**
+ * @brief: Function to account the latency of one callback dispatch
+ *
+ * @type        : CAM_SYNC_CB_DISPATCH_WORKQ or CAM_SYNC_CB_DISPATCH_INLINE
+ * @signaled_ts : Time at which the callback was made ready to run
+ *
+ * @return None
+ */
+void cam_sync_util_update_cb_stats(uint32_t type, ktime_t signaled_ts);
 
 /**
  * @brief: Function to send V4L event to user space
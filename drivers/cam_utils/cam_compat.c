@@ -5,6 +5,7 @@
 
 #include <linux/dma-mapping.h>
 #include <linux/of_address.h>
+#include <uapi/linux/sched/types.h>
 
 #include "cam_compat.h"
 #include "cam_debug_util.h"
@@ -234,3 +235,14 @@ int camera_component_match_add_drivers(struct device *master_dev,
 end:
 	return rc;
 }
+
+void cam_set_rt_sched(struct task_struct *task)
+{
+#if KERNEL_VERSION(5, 9, 0) <= LINUX_VERSION_CODE
+	sched_set_fifo(task);
+#else
+	struct sched_param param = { .sched_priority = MAX_RT_PRIO / 2 };
+
+	sched_setscheduler(task, SCHED_FIFO, &param);
+#endif
+}
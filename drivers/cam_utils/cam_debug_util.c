@@ -6,16 +6,130 @@
 #include <linux/io.h>
 #include <linux/slab.h>
 #include <linux/module.h>
+#include <linux/vmalloc.h>
+#include <linux/debugfs.h>
 #include "cam_trace.h"
 
 #include "cam_debug_util.h"
 
-static uint debug_mdl;
-module_param(debug_mdl, uint, 0644);
+/* Number of entries in the binary debug log ring, power of 2 */
+#define CAM_DEBUG_RING_ENTRIES     1024
 
-/* 0x0 - only logs, 0x1 - only trace, 0x2 - logs + trace */
+/* Words of packed printf arguments kept per ring entry */
+#define CAM_DEBUG_RING_ARG_WORDS   32
+
+/* Max decoded length of one ring entry */
+#define CAM_DEBUG_RING_LINE_LEN    256
+
+DEFINE_STATIC_KEY_FALSE(cam_debug_key);
+
+uint cam_debug_mdl;
+
+/*
+ * 0x0 - only logs, 0x1 - only trace, 0x2 - logs + trace,
+ * 0x3 - binary ring, decoded through debugfs camera_debug/log_ring
+ */
 static uint debug_type;
-module_param(debug_type, uint, 0644);
+
+/**
+ * struct cam_debug_ring_entry
+ *
+ * @seq       : Write sequence number, set last once the entry is complete
+ * @truncated : Arguments did not fit in args
+ * @module_id : Module ID of the log
+ * @line      : Source line of the log
+ * @ts        : Timestamp in ns
+ * @func      : Function name of the log
+ * @fmt       : Format string, decoded later with the packed args
+ * @args      : Arguments packed by vbin_printf
+ */
+struct cam_debug_ring_entry {
+	uint32_t     seq;
+	bool         truncated;
+	uint32_t     module_id;
+	int          line;
+	uint64_t     ts;
+	const char  *func;
+	const char  *fmt;
+	uint32_t     args[CAM_DEBUG_RING_ARG_WORDS];
+};
+
+static struct cam_debug_ring_entry *cam_debug_ring;
+static atomic_t cam_debug_ring_head = ATOMIC_INIT(0);
+static DEFINE_MUTEX(cam_debug_ring_lock);
+static struct dentry *cam_debug_dentry;
+
+static int cam_debug_ring_alloc(void)
+{
+	struct cam_debug_ring_entry *ring;
+	int rc = 0;
+
+	if (!IS_ENABLED(CONFIG_BINARY_PRINTF))
+		return -EOPNOTSUPP;
+
+	mutex_lock(&cam_debug_ring_lock);
+	if (!cam_debug_ring) {
+		ring = vzalloc(CAM_DEBUG_RING_ENTRIES * sizeof(*ring));
+		if (ring)
+			smp_store_release(&cam_debug_ring, ring);
+		else
+			rc = -ENOMEM;
+	}
+	mutex_unlock(&cam_debug_ring_lock);
+
+	return rc;
+}
+
+static int cam_debug_mdl_set(const char *val, const struct kernel_param *kp)
+{
+	int rc;
+
+	rc = param_set_uint(val, kp);
+	if (rc)
+		return rc;
+
+	if (cam_debug_mdl)
+		static_branch_enable(&cam_debug_key);
+	else
+		static_branch_disable(&cam_debug_key);
+
+	return 0;
+}
+
+static const struct kernel_param_ops cam_debug_mdl_ops = {
+	.set = cam_debug_mdl_set,
+	.get = param_get_uint,
+};
+module_param_cb(debug_mdl, &cam_debug_mdl_ops, &cam_debug_mdl, 0644);
+
+static int cam_debug_type_set(const char *val, const struct kernel_param *kp)
+{
+	uint type;
+	int rc;
+
+	rc = kstrtouint(val, 0, &type);
+	if (rc)
+		return rc;
+
+	if (type > CAM_DEBUG_TYPE_RING)
+		return -EINVAL;
+
+	if (type == CAM_DEBUG_TYPE_RING) {
+		rc = cam_debug_ring_alloc();
+		if (rc)
+			return rc;
+	}
+
+	WRITE_ONCE(debug_type, type);
+
+	return 0;
+}
+
+static const struct kernel_param_ops cam_debug_type_ops = {
+	.set = cam_debug_type_set,
+	.get = param_get_uint,
+};
+module_param_cb(debug_type, &cam_debug_type_ops, &debug_type, 0644);
 
 struct camera_debug_settings cam_debug;
 
@@ -254,35 +368,206 @@ const char *cam_get_tag_name(unsigned int tag_id)
 	return name;
 }
 
+#ifdef CONFIG_BINARY_PRINTF
+static void cam_debug_ring_record(unsigned int module_id, const char *func,
+	const int line, const char *fmt, va_list args)
+{
+	struct cam_debug_ring_entry *ring = smp_load_acquire(&cam_debug_ring);
+	struct cam_debug_ring_entry *entry;
+	uint32_t seq;
+	int len;
+
+	if (!ring)
+		return;
+
+	seq = atomic_inc_return(&cam_debug_ring_head);
+	entry = &ring[(seq - 1) & (CAM_DEBUG_RING_ENTRIES - 1)];
+
+	WRITE_ONCE(entry->seq, 0);
+	smp_wmb();
+
+	entry->module_id = module_id;
+	entry->line = line;
+	entry->ts = ktime_get_ns();
+	entry->func = func;
+	entry->fmt = fmt;
+	len = vbin_printf(entry->args, CAM_DEBUG_RING_ARG_WORDS, fmt, args);
+	entry->truncated = (len > CAM_DEBUG_RING_ARG_WORDS);
+
+	smp_wmb();
+	WRITE_ONCE(entry->seq, seq);
+}
+
+static int cam_debug_ring_decode(struct cam_debug_ring_entry *entry,
+	char *buf, size_t size)
+{
+	char str_buffer[CAM_DEBUG_RING_LINE_LEN];
+	uint64_t ts = entry->ts;
+	uint32_t ns = do_div(ts, NSEC_PER_SEC);
+
+	if (entry->truncated)
+		strlcpy(str_buffer, entry->fmt, sizeof(str_buffer));
+	else
+		bstr_printf(str_buffer, sizeof(str_buffer), entry->fmt,
+			entry->args);
+
+	return scnprintf(buf, size, "[%llu.%06u] CAM_DBG: %s: %s: %d: %s%s\n",
+		ts, ns / NSEC_PER_USEC, cam_get_module_name(entry->module_id),
+		entry->func, entry->line, entry->truncated ? "(truncated) " : "",
+		str_buffer);
+}
+#else
+static void cam_debug_ring_record(unsigned int module_id, const char *func,
+	const int line, const char *fmt, va_list args)
+{
+}
+
+static int cam_debug_ring_decode(struct cam_debug_ring_entry *entry,
+	char *buf, size_t size)
+{
+	return 0;
+}
+#endif
+
+static int cam_debug_ring_open(struct inode *inode, struct file *file)
+{
+	struct cam_debug_ring_entry *ring = smp_load_acquire(&cam_debug_ring);
+	struct cam_debug_ring_entry *entry, snapshot;
+	uint32_t head, seq;
+	size_t size, len = 0;
+	char *out_buffer;
+
+	size = CAM_DEBUG_RING_ENTRIES * CAM_DEBUG_RING_LINE_LEN;
+	out_buffer = vzalloc(size);
+	if (!out_buffer)
+		return -ENOMEM;
+
+	head = atomic_read(&cam_debug_ring_head);
+	seq = (head > CAM_DEBUG_RING_ENTRIES) ?
+		(head - CAM_DEBUG_RING_ENTRIES) : 0;
+
+	for (seq += 1; ring && (seq <= head); seq++) {
+		entry = &ring[(seq - 1) & (CAM_DEBUG_RING_ENTRIES - 1)];
+		if (READ_ONCE(entry->seq) != seq)
+			continue;
+
+		smp_rmb();
+		snapshot = *entry;
+		smp_rmb();
+
+		/* Skip entries overwritten while being copied */
+		if (READ_ONCE(entry->seq) != seq)
+			continue;
+
+		len += cam_debug_ring_decode(&snapshot, out_buffer + len,
+			size - len);
+	}
+
+	file->private_data = out_buffer;
+
+	return 0;
+}
+
+static ssize_t cam_debug_ring_read(struct file *t_file, char *t_char,
+	size_t t_size_t, loff_t *t_loff_t)
+{
+	char *out_buffer = t_file->private_data;
+
+	return simple_read_from_buffer(t_char, t_size_t,
+		t_loff_t, out_buffer, strlen(out_buffer));
+}
+
+static ssize_t cam_debug_ring_write(struct file *t_file,
+	const char *t_char, size_t t_size_t, loff_t *t_loff_t)
+{
+	atomic_set(&cam_debug_ring_head, 0);
+
+	return t_size_t;
+}
+
+static int cam_debug_ring_release(struct inode *inode, struct file *file)
+{
+	vfree(file->private_data);
+
+	return 0;
+}
+
+static const struct file_operations cam_debug_ring_fops = {
+	.open = cam_debug_ring_open,
+	.read = cam_debug_ring_read,
+	.write = cam_debug_ring_write,
+	.release = cam_debug_ring_release,
+};
+
+int cam_debug_util_init(void)
+{
+	struct dentry *dbgfileptr = NULL;
+
+	dbgfileptr = debugfs_create_dir("camera_debug", NULL);
+	if (IS_ERR_OR_NULL(dbgfileptr)) {
+		CAM_WARN(CAM_UTIL, "DebugFS could not create directory!");
+		return 0;
+	}
+	cam_debug_dentry = dbgfileptr;
+
+	debugfs_create_file("log_ring", 0644, cam_debug_dentry, NULL,
+		&cam_debug_ring_fops);
+
+	return 0;
+}
+
+void cam_debug_util_exit(void)
+{
+	debugfs_remove_recursive(cam_debug_dentry);
+	cam_debug_dentry = NULL;
+
+	WRITE_ONCE(debug_type, CAM_DEBUG_TYPE_LOG);
+	static_branch_disable(&cam_debug_key);
+	vfree(cam_debug_ring);
+	cam_debug_ring = NULL;
+}
+
 void cam_debug_log(unsigned int module_id, const char *func, const int line,
 	const char *fmt, ...)
 {
-	if (debug_mdl & module_id) {
-		char str_buffer[STR_BUFFER_MAX_LENGTH];
-		va_list args;
+	char str_buffer[STR_BUFFER_MAX_LENGTH];
+	uint type = READ_ONCE(debug_type);
+	va_list args;
 
-		va_start(args, fmt);
-		vsnprintf(str_buffer, STR_BUFFER_MAX_LENGTH, fmt, args);
+	if (!(cam_debug_mdl & module_id))
+		return;
+
+	va_start(args, fmt);
 
-		if ((debug_type == 0) || (debug_type == 2)) {
-			pr_info("CAM_DBG: %s: %s: %d: %s\n",
-				cam_get_module_name(module_id),
-				func, line, str_buffer);
-		}
+	/* Binary ring defers formatting to the debugfs reader */
+	if (type == CAM_DEBUG_TYPE_RING) {
+		cam_debug_ring_record(module_id, func, line, fmt, args);
+		va_end(args);
+		return;
+	}
 
-		if ((debug_type == 1) || (debug_type == 2)) {
-			char trace_buffer[STR_BUFFER_MAX_LENGTH];
+	vsnprintf(str_buffer, STR_BUFFER_MAX_LENGTH, fmt, args);
 
-			snprintf(trace_buffer, sizeof(trace_buffer),
-				"%s: %s: %s: %d: %s",
-				cam_get_tag_name(CAM_TYPE_DBG),
-				cam_get_module_name(module_id),
-				func, line, str_buffer);
-			trace_cam_log_debug(trace_buffer);
-		}
+	if ((type == CAM_DEBUG_TYPE_LOG) ||
+		(type == CAM_DEBUG_TYPE_LOG_TRACE)) {
+		pr_info("CAM_DBG: %s: %s: %d: %s\n",
+			cam_get_module_name(module_id),
+			func, line, str_buffer);
+	}
 
-		va_end(args);
+	if ((type == CAM_DEBUG_TYPE_TRACE) ||
+		(type == CAM_DEBUG_TYPE_LOG_TRACE)) {
+		char trace_buffer[STR_BUFFER_MAX_LENGTH];
+
+		snprintf(trace_buffer, sizeof(trace_buffer),
+			"%s: %s: %s: %d: %s",
+			cam_get_tag_name(CAM_TYPE_DBG),
+			cam_get_module_name(module_id),
+			func, line, str_buffer);
+		trace_cam_log_debug(trace_buffer);
 	}
+
+	va_end(args);
 }
 
 void cam_debug_trace(unsigned int tag, unsigned int module_id,
@@ -291,7 +576,8 @@ void cam_debug_trace(unsigned int tag, unsigned int module_id,
 	char str_buffer[STR_BUFFER_MAX_LENGTH];
 	va_list args;
 
-	if ((tag == CAM_TYPE_TRACE) || (debug_type == 1) || (debug_type == 2)) {
+	if ((tag == CAM_TYPE_TRACE) || (debug_type == CAM_DEBUG_TYPE_TRACE) ||
+		(debug_type == CAM_DEBUG_TYPE_LOG_TRACE)) {
 		char trace_buffer[STR_BUFFER_MAX_LENGTH];
 
 		va_start(args, fmt);
@@ -8,6 +8,7 @@
 #define _CAM_DEBUG_UTIL_H_
 
 #include <linux/platform_device.h>
+#include <linux/jump_label.h>
 
 #define CAM_IS_NULL_TO_STR(ptr) ((ptr) ? "Non-NULL" : "NULL")
 
@@ -53,6 +54,18 @@
 
 #define STR_BUFFER_MAX_LENGTH  512
 
+/* Debug log backends selected with the debug_type module param */
+#define CAM_DEBUG_TYPE_LOG         0
+#define CAM_DEBUG_TYPE_TRACE       1
+#define CAM_DEBUG_TYPE_LOG_TRACE   2
+#define CAM_DEBUG_TYPE_RING        3
+
+/* Enabled while any module is set in debug_mdl */
+DECLARE_STATIC_KEY_FALSE(cam_debug_key);
+
+/* Bitmask of module IDs with debug logs enabled */
+extern uint cam_debug_mdl;
+
 /**
  * struct cam_cpas_debug_settings - Sysfs debug settings for cpas driver
  */
@@ -112,6 +125,20 @@ void cam_debug_log(unsigned int module_id, const char *func, const int line,
 void cam_debug_trace(unsigned int tag, unsigned int module_id,
 	const char *func, const int line, const char *fmt, ...);
 
+/*
+ * cam_debug_util_init()
+ *
+ * @brief     :  Create debugfs entries of the debug log ring
+ */
+int cam_debug_util_init(void);
+
+/*
+ * cam_debug_util_exit()
+ *
+ * @brief     :  Remove debugfs entries and free the debug log ring
+ */
+void cam_debug_util_exit(void);
+
 /*
  * cam_get_module_name()
  *
@@ -205,14 +232,21 @@ const char *cam_get_module_name(unsigned int module_id);
 
 /*
  * CAM_DBG
- * @brief    :  This Macro will print debug logs when enabled using GROUP
+ * @brief    :  This Macro will print debug logs when enabled using GROUP.
+ *              With no module enabled it compiles to a patched out branch,
+ *              arguments are evaluated only when the module is enabled.
  *
  * @__module :  Respective module id which is been calling this Macro
  * @fmt      :  Formatted string which needs to be print in log
  * @args     :  Arguments which needs to be print in log
  */
-#define CAM_DBG(__module, fmt, args...)                            \
-	cam_debug_log(__module, __func__, __LINE__, fmt, ##args)
+#define CAM_DBG(__module, fmt, args...)                                        \
+	({                                                                     \
+		if (static_branch_unlikely(&cam_debug_key) &&                  \
+			(cam_debug_mdl & (__module)))                          \
+			cam_debug_log(__module, __func__, __LINE__,            \
+				fmt, ##args);                                  \
+	})
 
 /*
  * CAM_ERR_RATE_LIMIT
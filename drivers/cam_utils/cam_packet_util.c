@@ -12,6 +12,7 @@
 #include "cam_debug_util.h"
 
 #define CAM_UNIQUE_SRC_HDL_MAX 50
+#define CAM_UNIQUE_DST_HDL_MAX 16
 
 struct cam_patch_unique_src_buf_tbl {
 	int32_t       hdl;
@@ -19,6 +20,12 @@ struct cam_patch_unique_src_buf_tbl {
 	size_t        buf_size;
 };
 
+struct cam_patch_unique_dst_buf_tbl {
+	int32_t       hdl;
+	uintptr_t     cpu_addr;
+	size_t        buf_len;
+};
+
 int cam_packet_util_get_cmd_mem_addr(int handle, uint32_t **buf_addr,
 	size_t *len)
 {
@@ -238,7 +245,7 @@ void cam_packet_dump_patch_info(struct cam_packet *packet,
 }
 
 static int cam_packet_util_get_patch_iova(
-	struct cam_patch_unique_src_buf_tbl *tbl,
+	struct cam_patch_unique_src_buf_tbl *tbl, uint32_t *last_idx,
 	int32_t hdl, uint32_t buf_hdl, dma_addr_t *iova, size_t *buf_size)
 {
 	int idx = 0;
@@ -247,6 +254,14 @@ static int cam_packet_util_get_patch_iova(
 	dma_addr_t iova_addr;
 	bool is_found = false;
 
+	/* Consecutive patches usually come from the same source buffer */
+	if (*last_idx < CAM_UNIQUE_SRC_HDL_MAX &&
+		tbl[*last_idx].hdl == buf_hdl && tbl[*last_idx].iova) {
+		*iova = tbl[*last_idx].iova;
+		*buf_size = tbl[*last_idx].buf_size;
+		return 0;
+	}
+
 	for (idx = 0; idx < CAM_UNIQUE_SRC_HDL_MAX; idx++) {
 		if (buf_hdl == tbl[idx].hdl) {
 			CAM_DBG(CAM_UTIL,
@@ -254,6 +269,7 @@ static int cam_packet_util_get_patch_iova(
 				buf_hdl, idx, tbl[idx].hdl);
 			*iova = tbl[idx].iova;
 			*buf_size = tbl[idx].buf_size;
+			*last_idx = idx;
 			is_found = true;
 			break;
 		} else if ((tbl[idx].hdl == 0) || (tbl[idx].iova == 0)) {
@@ -283,6 +299,7 @@ static int cam_packet_util_get_patch_iova(
 			tbl[idx].buf_size = src_buf_size;
 			tbl[idx].iova = iova_addr;
 			tbl[idx].hdl = buf_hdl;
+			*last_idx = idx;
 			CAM_DBG(CAM_UTIL,
 				"Updated table index: %d with src_buf_hdl: 0x%x",
 				idx, tbl[idx].hdl);
@@ -294,6 +311,57 @@ static int cam_packet_util_get_patch_iova(
 	return rc;
 }
 
+/*
+ * Each destination command buffer is mapped into the kernel once per packet,
+ * no matter how many patches target it. If the table is full the buffer is
+ * resolved for the single patch and released right away.
+ */
+static int cam_packet_util_get_patch_dst(
+	struct cam_patch_unique_dst_buf_tbl *tbl, uint32_t *num_entries,
+	uint32_t *last_idx, int32_t buf_hdl, uintptr_t *cpu_addr,
+	size_t *buf_len, bool *is_cached)
+{
+	int rc;
+	uint32_t idx;
+
+	if (*last_idx < *num_entries && tbl[*last_idx].hdl == buf_hdl) {
+		idx = *last_idx;
+		goto found;
+	}
+
+	for (idx = 0; idx < *num_entries; idx++) {
+		if (tbl[idx].hdl == buf_hdl)
+			goto found;
+	}
+
+	rc = cam_mem_get_cpu_buf(buf_hdl, cpu_addr, buf_len);
+	if (rc < 0 || !(*cpu_addr) || (*buf_len == 0)) {
+		CAM_ERR(CAM_UTIL, "unable to get dst buf address");
+		if (!rc)
+			rc = -EINVAL;
+		return rc;
+	}
+
+	*is_cached = false;
+	if (*num_entries < CAM_UNIQUE_DST_HDL_MAX) {
+		idx = (*num_entries)++;
+		tbl[idx].hdl = buf_hdl;
+		tbl[idx].cpu_addr = *cpu_addr;
+		tbl[idx].buf_len = *buf_len;
+		*last_idx = idx;
+		*is_cached = true;
+	}
+
+	return 0;
+
+found:
+	*cpu_addr = tbl[idx].cpu_addr;
+	*buf_len = tbl[idx].buf_len;
+	*last_idx = idx;
+	*is_cached = true;
+	return 0;
+}
+
 int cam_packet_util_process_patches(struct cam_packet *packet,
 	int32_t iommu_hdl, int32_t sec_mmu_hdl)
 {
@@ -308,8 +376,13 @@ int cam_packet_util_process_patches(struct cam_packet *packet,
 	int        i  = 0;
 	int        rc = 0;
 	int32_t    hdl;
+	uint32_t   src_last_idx = 0, dst_last_idx = 0;
+	uint32_t   num_dst = 0;
+	bool       dst_cached;
 	struct cam_patch_unique_src_buf_tbl
 		tbl[CAM_UNIQUE_SRC_HDL_MAX];
+	struct cam_patch_unique_dst_buf_tbl
+		dst_tbl[CAM_UNIQUE_DST_HDL_MAX];
 
 	memset(tbl, 0, CAM_UNIQUE_SRC_HDL_MAX *
 		sizeof(struct cam_patch_unique_src_buf_tbl));
@@ -326,31 +399,32 @@ int cam_packet_util_process_patches(struct cam_packet *packet,
 		hdl = cam_mem_is_secure_buf(patch_desc[i].src_buf_hdl) ?
 			sec_mmu_hdl : iommu_hdl;
 
-		rc = cam_packet_util_get_patch_iova(&tbl[0], hdl,
-			patch_desc[i].src_buf_hdl, &iova_addr, &src_buf_size);
+		rc = cam_packet_util_get_patch_iova(&tbl[0], &src_last_idx,
+			hdl, patch_desc[i].src_buf_hdl, &iova_addr,
+			&src_buf_size);
 		if (rc) {
 			CAM_ERR(CAM_UTIL,
 				"get_iova failed for patch[%d], src_buf_hdl: 0x%x: rc: %d",
 				i, patch_desc[i].src_buf_hdl, rc);
-			return rc;
+			goto put_dst;
 		}
 
 		if ((size_t)patch_desc[i].src_offset >= src_buf_size) {
 			CAM_ERR(CAM_UTIL,
 				"Invalid src buf patch offset: patch:src_offset: 0x%x, src_buf_size: %zu",
 				patch_desc[i].src_offset, src_buf_size);
-			return -EINVAL;
+			rc = -EINVAL;
+			goto put_dst;
 		}
 
 		src_buf_iova_addr = (uint32_t *)iova_addr;
 		temp = iova_addr;
 
-		rc = cam_mem_get_cpu_buf(patch_desc[i].dst_buf_hdl,
-			&cpu_addr, &dst_buf_len);
-		if (rc < 0 || !cpu_addr || (dst_buf_len == 0)) {
-			CAM_ERR(CAM_UTIL, "unable to get dst buf address");
-			return rc;
-		}
+		rc = cam_packet_util_get_patch_dst(dst_tbl, &num_dst,
+			&dst_last_idx, patch_desc[i].dst_buf_hdl, &cpu_addr,
+			&dst_buf_len, &dst_cached);
+		if (rc)
+			goto put_dst;
 		dst_cpu_addr = (uint32_t *)cpu_addr;
 
 		CAM_DBG(CAM_UTIL, "i = %d patch info = %x %x %x %x", i,
@@ -362,8 +436,11 @@ int cam_packet_util_process_patches(struct cam_packet *packet,
 			(size_t)patch_desc[i].dst_offset)) {
 			CAM_ERR(CAM_UTIL,
 				"Invalid dst buf patch offset");
-			cam_mem_put_cpu_buf((int32_t)patch_desc[i].dst_buf_hdl);
-			return -EINVAL;
+			if (!dst_cached)
+				cam_mem_put_cpu_buf(
+					(int32_t)patch_desc[i].dst_buf_hdl);
+			rc = -EINVAL;
+			goto put_dst;
 		}
 
 		dst_cpu_addr = (uint32_t *)((uint8_t *)dst_cpu_addr +
@@ -376,9 +453,14 @@ int cam_packet_util_process_patches(struct cam_packet *packet,
 			"patch is done for dst %pK with src %pK value %llx",
 			dst_cpu_addr, src_buf_iova_addr,
 			*((uint64_t *)dst_cpu_addr));
-		cam_mem_put_cpu_buf((int32_t)patch_desc[i].dst_buf_hdl);
+		if (!dst_cached)
+			cam_mem_put_cpu_buf((int32_t)patch_desc[i].dst_buf_hdl);
 	}
 
+put_dst:
+	for (i = 0; i < num_dst; i++)
+		cam_mem_put_cpu_buf(dst_tbl[i].hdl);
+
 	return rc;
 }
 
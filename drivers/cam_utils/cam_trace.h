@@ -368,6 +368,27 @@ TRACE_EVENT(cam_irq_handled,
 	)
 );
 
+TRACE_EVENT(cam_irq_th_duration,
+	TP_PROTO(const char *entity, uint32_t num_handlers,
+		uint64_t duration_ns),
+	TP_ARGS(entity, num_handlers, duration_ns),
+	TP_STRUCT__entry(
+		__string(entity, entity)
+		__field(uint32_t, num_handlers)
+		__field(uint64_t, duration_ns)
+	),
+	TP_fast_assign(
+		__assign_str(entity, entity);
+		__entry->num_handlers = num_handlers;
+		__entry->duration_ns = duration_ns;
+	),
+	TP_printk(
+		"%8s: top half handlers=%u duration=%lluns",
+			__get_str(entity), __entry->num_handlers,
+			__entry->duration_ns
+	)
+);
+
 TRACE_EVENT(cam_cdm_cb,
 	TP_PROTO(const char *entity, uint32_t status),
 	TP_ARGS(entity, status),
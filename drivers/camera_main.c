@@ -5,11 +5,14 @@
 #include <linux/module.h>
 #include <linux/build_bug.h>
 
+#include "cam_debug_util.h"
 #include "cam_req_mgr_dev.h"
 #include "cam_sync_api.h"
 #include "cam_smmu_api.h"
 #include "cam_cpas_hw_intf.h"
 #include "cam_cdm_intf_api.h"
+#include "cam_context.h"
+#include "cam_context_utils.h"
 
 #include "cam_ife_csid_dev.h"
 #include "cam_vfe.h"
@@ -74,6 +77,8 @@ struct camera_submodule {
 };
 
 static const struct camera_submodule_component camera_base[] = {
+	{&cam_debug_util_init, &cam_debug_util_exit},
+	{&cam_context_util_init, &cam_context_util_exit},
 	{&cam_req_mgr_init, &cam_req_mgr_exit},
 	{&cam_sync_init, &cam_sync_exit},
 	{&cam_smmu_init_module, &cam_smmu_exit_module},
@@ -119,6 +119,9 @@
 #define CAM_SYNC_EVENT_CNT                7
 #define CAM_SYNC_EVENT_REASON_CODE_INDEX  0
 
+/* Max number of sync objects in one batched signal or wait */
+#define CAM_SYNC_MAX_BATCH_OBJS           64
+
 
 /**
  * struct cam_sync_ev_header - Event header for sync event notification
@@ -207,6 +210,37 @@ struct cam_sync_wait {
 	uint64_t timeout_ms;
 };
 
+/**
+ * struct cam_sync_signal_batch - Batched sync object signaling struct
+ *
+ * @signals:     Pointer to array of struct cam_sync_signal
+ * @num_signals: Number of entries in the array
+ * @failed_idx:  Index of the first entry which failed to signal, -1 if all
+ *               entries were signaled
+ */
+struct cam_sync_signal_batch {
+	__u64 signals;
+	__u32 num_signals;
+	__s32 failed_idx;
+};
+
+/**
+ * struct cam_sync_wait_multi - Wait information for multiple sync objects
+ *
+ * @sync_objs:  Pointer to array of sync objects to wait on
+ * @num_objs:   Number of objects in the array
+ * @fired_obj:  For WAIT_ANY, the sync object that was signaled first.
+ *              For WAIT_ALL, the first object not signaled with success, or
+ *              the last object waited upon if all succeeded
+ * @timeout_ms: Timeout in milliseconds for the whole wait
+ */
+struct cam_sync_wait_multi {
+	__u64    sync_objs;
+	__u32    num_objs;
+	__s32    fired_obj;
+	uint64_t timeout_ms;
+};
+
 /**
  * struct cam_private_ioctl_arg - Sync driver ioctl argument
  *
@@ -234,5 +268,8 @@ struct cam_private_ioctl_arg {
 #define CAM_SYNC_REGISTER_PAYLOAD                4
 #define CAM_SYNC_DEREGISTER_PAYLOAD              5
 #define CAM_SYNC_WAIT                            6
+#define CAM_SYNC_SIGNAL_BATCH                    7
+#define CAM_SYNC_WAIT_ANY                        8
+#define CAM_SYNC_WAIT_ALL                        9
 
 #endif /* __UAPI_CAM_SYNC_H__ */